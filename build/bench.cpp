@@ -0,0 +1,597 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * End-to-end benchmark of the loudness models.
+ *
+ * Every DynamicLoudnessGM2002 and DynamicLoudnessCH2012 parameter set
+ * processes a deterministic synthetic signal at 32, 44.1, 48 and 96 kHz for
+ * each input layout (one or three sources, one or two ears; partial
+ * loudness is used with several sources). The stationary models evaluate a
+ * sequence of power spectra. The signal is also written to a temporary
+ * stereo FLAC file, which is read by an AudioFileCutter with and without
+ * read-ahead to measure how much of the decoding the background thread
+ * hides. Each call to Model::process() (and AudioFileCutter::process() when
+ * reading the file) is timed after a warm-up, and the results are written
+ * as JSON, one case per line:
+ *
+ *   name            Unique case name.
+ *   nFrames         Number of calls to Model::process().
+ *   signalSeconds   Duration of the input signal (dynamic models only).
+ *   processSeconds  Total processing time.
+ *   realTimeFactor  processSeconds / signalSeconds, less than 1 is faster
+ *                   than real time (dynamic models only).
+ *   latencyUs       Mean, median, 90th, 99th percentile and maximum time of
+ *                   a call in microseconds.
+ *   peakRssKb       Peak resident set size of the process after the case.
+ *
+ * Given a baseline written by a previous run, the median latency of every
+ * case, which is less affected by other load on the machine than the mean,
+ * is compared against it and cases slower by more than the tolerance are
+ * flagged as regressions, in which case the program returns 1.
+ *
+ * Results are written to standard output unless an output file is given, in
+ * which case progress and the comparison are printed there instead.
+ *
+ * Usage: bench [-o results.json] [-b baseline.json] [-t tolerance (%)]
+ *              [-d signal duration (s)] [-m max time per case (s)]
+ *              [-f name filter]
+ *
+ * See the bench target in the Makefile.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../src/modules/AudioFileCutter.h"
+#include "../src/models/DynamicLoudnessGM2002.h"
+#include "../src/models/DynamicLoudnessCH2012.h"
+#include "../src/models/StationaryLoudnessANSIS342007.h"
+#include "../src/models/StationaryLoudnessCHGM2011.h"
+#include "../src/models/StationaryLoudnessDIN456311991.h"
+
+using namespace loudness;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result
+{
+    string name;
+    int nFrames;
+    double signalSeconds, processSeconds;
+    double mean, p50, p90, p99, max;
+    long peakRssKb;
+};
+
+static const int nWarmUpFrames = 20;
+static const int nStationaryFrames = 200;
+
+/*
+ * Fills input with a pink-ish noise at 60 dB SPL plus a tone at 70 dB SPL
+ * whose frequency depends on the source and ear, gated on and off every
+ * 250 ms. The noise is seeded per channel so runs are repeatable.
+ */
+static void generateSignal(vector<RealVec>& signal, int nSources, int nEars,
+        int nSamples, int fs)
+{
+    signal.assign(nSources * nEars, RealVec(nSamples));
+    for (int chn = 0; chn < nSources * nEars; ++chn)
+    {
+        unsigned int seed = 1 + chn;
+        double b0 = 0, b1 = 0;
+        double freq = 250.0 * (1 + chn);
+        for (int i = 0; i < nSamples; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            double white = (seed >> 8) / (double)(1 << 24) - 0.5;
+            b0 = 0.99765 * b0 + white * 0.0990460;
+            b1 = 0.96300 * b1 + white * 0.2965164;
+            double pink = (b0 + b1 + white * 0.1848) * 3.0;
+            double gate = ((4 * i / fs) % 2) ? 0.0 : 1.0;
+            signal[chn][i] = 2e-5 * pow(10, 60 / 20.0) * pink
+                + gate * 2e-5 * pow(10, 70 / 20.0) * sqrt(2)
+                * sin(2 * PI * freq * i / fs);
+        }
+    }
+}
+
+static long getPeakRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/*
+ * Sorts the call times (in seconds) and fills the latency statistics.
+ */
+static void summarise(vector<double>& times, Result& result)
+{
+    std::sort(times.begin(), times.end());
+    int n = (int)times.size();
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i)
+        sum += times[i];
+    result.nFrames = n;
+    result.processSeconds = sum;
+    result.mean = 1e6 * sum / n;
+    result.p50 = 1e6 * times[(n - 1) / 2];
+    result.p90 = 1e6 * times[(int)(0.9 * (n - 1))];
+    result.p99 = 1e6 * times[(int)(0.99 * (n - 1))];
+    result.max = 1e6 * times[n - 1];
+    result.peakRssKb = getPeakRssKb();
+}
+
+/*
+ * Processes the signal hop by hop, timing each call to Model::process().
+ * Processing stops early once maxSeconds have been spent, so slow models
+ * process a shorter signal.
+ */
+static bool benchDynamic(Model& model, int fs, int nSources, int nEars,
+        double duration, double maxSeconds, Result& result)
+{
+    model.setOutputsToAggregate(vector<string>());
+    int hopSize = (int)round(fs / model.getRate());
+    SignalBank input;
+    input.initialize(nSources, nEars, 1, hopSize, fs);
+    if (!model.initialize(input))
+        return false;
+
+    int nFrames = (int)(duration * fs) / hopSize;
+    vector<RealVec> signal;
+    generateSignal(signal, nSources, nEars, nFrames * hopSize, fs);
+
+    vector<double> times(nFrames);
+    double totalTime = 0.0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        //the first pass warms up the caches and is discarded
+        int nPassFrames = pass ? nFrames : std::min(nWarmUpFrames, nFrames);
+        for (int frame = 0; frame < nPassFrames; ++frame)
+        {
+            for (int src = 0; src < nSources; ++src)
+            {
+                for (int ear = 0; ear < nEars; ++ear)
+                {
+                    const Real* x = signal[src * nEars + ear].data()
+                                    + frame * hopSize;
+                    std::copy(x, x + hopSize,
+                              input.getSignalWritePointer(src, ear, 0));
+                }
+            }
+            Clock::time_point start = Clock::now();
+            model.process(input);
+            times[frame] = std::chrono::duration<double>(
+                    Clock::now() - start).count();
+
+            if (pass)
+            {
+                totalTime += times[frame];
+                if (totalTime > maxSeconds)
+                {
+                    nFrames = frame + 1;
+                    times.resize(nFrames);
+                    break;
+                }
+            }
+        }
+        model.reset();
+    }
+
+    summarise(times, result);
+    result.signalSeconds = nFrames * hopSize / (double)fs;
+    return true;
+}
+
+/*
+ * Writes the signal for one source and nEars ears to a 16 bit FLAC file.
+ */
+static bool writeFlacFile(const string& fileName, int nEars, double duration,
+        int fs)
+{
+    int nSamples = (int)(duration * fs);
+    vector<RealVec> signal;
+    generateSignal(signal, 1, nEars, nSamples, fs);
+    vector<float> interleaved(nSamples * nEars);
+    for (int i = 0; i < nSamples; ++i)
+    {
+        for (int ear = 0; ear < nEars; ++ear)
+            interleaved[i * nEars + ear] = signal[ear][i];
+    }
+
+    SF_INFO fileInfo;
+    fileInfo.samplerate = fs;
+    fileInfo.channels = nEars;
+    fileInfo.format = SF_FORMAT_FLAC | SF_FORMAT_PCM_16;
+    SNDFILE* sndFile = sf_open(fileName.c_str(), SFM_WRITE, &fileInfo);
+    if (!sndFile)
+        return false;
+    bool isWritten = sf_writef_float(sndFile, interleaved.data(), nSamples)
+                     == nSamples;
+    return (sf_close(sndFile) == 0) && isWritten;
+}
+
+/*
+ * Processes a file hop by hop, timing each call to AudioFileCutter::process()
+ * and Model::process() together. Processing stops early once maxSeconds
+ * have been spent.
+ */
+static bool benchAudioFile(Model& model, const string& fileName, int fs,
+        bool isReadAheadUsed, double maxSeconds, Result& result)
+{
+    model.setOutputsToAggregate(vector<string>());
+    int hopSize = (int)round(fs / model.getRate());
+    AudioFileCutter audio(fileName, hopSize);
+    audio.setReadAheadUsed(isReadAheadUsed);
+    if (!audio.initialize() || !model.initialize(audio.getOutput()))
+        return false;
+
+    int nFrames = audio.getNFrames();
+    vector<double> times(nFrames);
+    double totalTime = 0.0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        //the first pass warms up the caches and is discarded
+        int nPassFrames = pass ? nFrames : std::min(nWarmUpFrames, nFrames);
+        for (int frame = 0; frame < nPassFrames; ++frame)
+        {
+            Clock::time_point start = Clock::now();
+            audio.process();
+            model.process(audio.getOutput());
+            times[frame] = std::chrono::duration<double>(
+                    Clock::now() - start).count();
+
+            if (pass)
+            {
+                totalTime += times[frame];
+                if (totalTime > maxSeconds)
+                {
+                    nFrames = frame + 1;
+                    times.resize(nFrames);
+                    break;
+                }
+            }
+        }
+        audio.reset();
+        model.reset();
+    }
+
+    summarise(times, result);
+    result.signalSeconds = nFrames * hopSize / (double)fs;
+    return true;
+}
+
+/*
+ * Evaluates a sequence of power spectra with component levels between 30 and
+ * 90 dB SPL, timing each call to Model::process().
+ */
+static bool benchStationary(Model& model, int nSources, int nEars,
+        Result& result)
+{
+    int nComponents = 100;
+    RealVec freqs(nComponents);
+    for (int i = 0; i < nComponents; ++i)
+        freqs[i] = 50 * pow(10, 2.5 * i / (nComponents - 1));
+
+    model.setOutputsToAggregate(vector<string>());
+    SignalBank input;
+    input.initialize(nSources, nEars, nComponents, 1, 1);
+    input.setCentreFreqs(freqs);
+    if (!model.initialize(input))
+        return false;
+
+    vector<SignalBank> inputs(nStationaryFrames);
+    unsigned int seed = 1;
+    for (int frame = 0; frame < nStationaryFrames; ++frame)
+    {
+        inputs[frame].initialize(input);
+        for (int src = 0; src < nSources; ++src)
+        {
+            for (int ear = 0; ear < nEars; ++ear)
+            {
+                for (int chn = 0; chn < nComponents; ++chn)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    Real level = 30 + 60 * (seed >> 8) / (Real)(1 << 24);
+                    inputs[frame].setSample(src, ear, chn, 0,
+                                            pow(10, level / 10.0));
+                }
+            }
+        }
+    }
+
+    vector<double> times(nStationaryFrames);
+    for (int frame = 0; frame < nWarmUpFrames; ++frame)
+        model.process(inputs[frame]);
+    for (int frame = 0; frame < nStationaryFrames; ++frame)
+    {
+        Clock::time_point start = Clock::now();
+        model.process(inputs[frame]);
+        times[frame] = std::chrono::duration<double>(
+                Clock::now() - start).count();
+    }
+
+    summarise(times, result);
+    result.signalSeconds = 0.0;
+    return true;
+}
+
+static string formatResult(const Result& result)
+{
+    char line[512];
+    char rtf[64];
+    if (result.signalSeconds > 0)
+    {
+        snprintf(rtf, sizeof(rtf), "\"signalSeconds\":%.4f,"
+                "\"realTimeFactor\":%.6f,", result.signalSeconds,
+                result.processSeconds / result.signalSeconds);
+    }
+    else
+    {
+        rtf[0] = '\0';
+    }
+    snprintf(line, sizeof(line), "{\"name\":\"%s\",\"nFrames\":%d,%s"
+            "\"processSeconds\":%.6f,\"latencyUs\":{\"mean\":%.3f,"
+            "\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f},"
+            "\"peakRssKb\":%ld}",
+            result.name.c_str(), result.nFrames, rtf, result.processSeconds,
+            result.mean, result.p50, result.p90, result.p99, result.max,
+            result.peakRssKb);
+    return line;
+}
+
+/*
+ * Reads the median latency of each case from a file written by this
+ * program.
+ */
+static bool readBaseline(const char* filename, map<string, double>& baseline)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file)
+        return false;
+
+    char line[1024];
+    while (fgets(line, sizeof(line), file))
+    {
+        const char* name = strstr(line, "{\"name\":\"");
+        const char* median = strstr(line, "\"p50\":");
+        if (!name || !median)
+            continue;
+        name += strlen("{\"name\":\"");
+        const char* nameEnd = strchr(name, '"');
+        if (nameEnd)
+        {
+            baseline[string(name, nameEnd)] = atof(median
+                                                   + strlen("\"p50\":"));
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const char* outputFile = 0;
+    const char* baselineFile = 0;
+    const char* filter = "";
+    double tolerance = 10.0;
+    double duration = 2.0;
+    double maxSeconds = 1.0;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "-o"))
+            outputFile = argv[i + 1];
+        else if (!strcmp(argv[i], "-b"))
+            baselineFile = argv[i + 1];
+        else if (!strcmp(argv[i], "-t"))
+            tolerance = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "-d"))
+            duration = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "-m"))
+            maxSeconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "-f"))
+            filter = argv[i + 1];
+    }
+    if ((argc % 2 == 0) || (duration <= 0))
+    {
+        printf("Usage: %s [-o results.json] [-b baseline.json] "
+               "[-t tolerance (%%)] [-d duration (s)] "
+               "[-m max time per case (s)] [-f name filter]\n",
+               argv[0]);
+        return 1;
+    }
+
+    map<string, double> baseline;
+    if (baselineFile && !readBaseline(baselineFile, baseline))
+    {
+        printf("Cannot read %s\n", baselineFile);
+        return 1;
+    }
+
+    FILE* file = outputFile ? fopen(outputFile, "w") : stdout;
+    if (!file)
+    {
+        printf("Cannot open %s\n", outputFile);
+        return 1;
+    }
+
+    //progress goes to stdout unless it holds the results
+    FILE* log = outputFile ? stdout : stderr;
+
+    const char* setsGM2002[] = {"GM2002", "Faster", "Recent",
+                                "FasterAndRecent", "WEAR2015"};
+    const char* setsCH2012[] = {"CH2012", "Faster"};
+    int rates[] = {32000, 44100, 48000, 96000};
+    int layouts[][2] = {{1, 1}, {1, 2}, {3, 1}, {3, 2}};
+
+    vector<Result> results;
+    bool isValid = true;
+    auto record = [&](const string& name, bool isRun, Result& result)
+    {
+        result.name = name;
+        if (!isRun)
+        {
+            fprintf(log, "%s: Not initialised!\n", name.c_str());
+            isValid = false;
+            return;
+        }
+        results.push_back(result);
+        fprintf(log, "%-72s %10.3f us\n", name.c_str(), result.p50);
+        fflush(log);
+    };
+    auto run = [&](Model& model, const string& name, int fs,
+                   int nSources, int nEars)
+    {
+        if (!strstr(name.c_str(), filter))
+            return;
+        Result result;
+        bool isRun = fs > 0
+                     ? benchDynamic(model, fs, nSources, nEars, duration,
+                                    maxSeconds, result)
+                     : benchStationary(model, nSources, nEars, result);
+        record(name, isRun, result);
+    };
+
+    for (int fs : rates)
+    {
+        for (auto& layout : layouts)
+        {
+            int nSources = layout[0], nEars = layout[1];
+            char config[64];
+            snprintf(config, sizeof(config), " %dHz %dsrc %dear",
+                     fs, nSources, nEars);
+
+            for (const char* set : setsGM2002)
+            {
+                DynamicLoudnessGM2002 model;
+                model.configureModelParameters(set);
+                model.setPartialLoudnessUsed(nSources > 1);
+                run(model, string("DynamicLoudnessGM2002 ") + set + config,
+                    fs, nSources, nEars);
+            }
+
+            for (const char* set : setsCH2012)
+            {
+                DynamicLoudnessCH2012 model;
+                model.configureModelParameters(set);
+                model.setPartialLoudnessUsed(nSources > 1);
+                run(model, string("DynamicLoudnessCH2012 ") + set + config,
+                    fs, nSources, nEars);
+            }
+        }
+    }
+
+    for (auto& layout : layouts)
+    {
+        int nSources = layout[0], nEars = layout[1];
+        char config[64];
+        snprintf(config, sizeof(config), " %dsrc %dear", nSources, nEars);
+
+        StationaryLoudnessANSIS342007 ansi;
+        ansi.setPartialLoudnessUsed(nSources > 1);
+        run(ansi, string("StationaryLoudnessANSIS342007") + config,
+            0, nSources, nEars);
+
+        StationaryLoudnessCHGM2011 chgm;
+        chgm.setPartialLoudnessUsed(nSources > 1);
+        run(chgm, string("StationaryLoudnessCHGM2011") + config,
+            0, nSources, nEars);
+
+        //single source, single ear only
+        if ((nSources == 1) && (nEars == 1))
+        {
+            StationaryLoudnessDIN456311991 din;
+            run(din, string("StationaryLoudnessDIN456311991") + config,
+                0, nSources, nEars);
+        }
+    }
+
+    //decoding with and without read-ahead
+    char fileName[] = "/tmp/loudnessBenchXXXXXX";
+    int fd = mkstemp(fileName);
+    if (fd >= 0)
+    {
+        close(fd);
+        int fs = 44100;
+        bool isWritten = writeFlacFile(fileName, 2, duration, fs);
+        for (const char* set : setsGM2002)
+        {
+            for (int isReadAheadUsed = 0; isReadAheadUsed < 2;
+                 ++isReadAheadUsed)
+            {
+                string name = string("DynamicLoudnessGM2002 ") + set
+                              + " 44100Hz 1src 2ear FLAC"
+                              + (isReadAheadUsed ? " read-ahead" : "");
+                if (!strstr(name.c_str(), filter))
+                    continue;
+                DynamicLoudnessGM2002 model;
+                model.configureModelParameters(set);
+                Result result;
+                bool isRun = isWritten
+                             && benchAudioFile(model, fileName, fs,
+                                               isReadAheadUsed, maxSeconds,
+                                               result);
+                record(name, isRun, result);
+            }
+        }
+        remove(fileName);
+    }
+    else
+    {
+        fprintf(log, "Cannot create a temporary audio file\n");
+        isValid = false;
+    }
+
+    fprintf(file, "{\"results\":[\n");
+    for (uint i = 0; i < results.size(); ++i)
+    {
+        fprintf(file, "%s%s\n", formatResult(results[i]).c_str(),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "],\n\"peakRssKb\":%ld}\n", getPeakRssKb());
+    if (outputFile)
+        fclose(file);
+
+    if (baselineFile)
+    {
+        int nRegressions = 0;
+        fprintf(log, "\n%-72s %10s %10s %8s\n", "Compared with baseline",
+                "base (us)", "now (us)", "change");
+        for (const Result& result : results)
+        {
+            auto search = baseline.find(result.name);
+            if (search == baseline.end() || search -> second <= 0)
+                continue;
+            double change = 100 * (result.p50 / search -> second - 1);
+            bool isRegression = change > tolerance;
+            nRegressions += isRegression;
+            fprintf(log, "%-72s %10.3f %10.3f %+7.1f%%%s\n",
+                    result.name.c_str(), search -> second, result.p50,
+                    change, isRegression ? " REGRESSION" : "");
+        }
+        fprintf(log, "%d regression(s) above %.1f%%\n", nRegressions,
+                tolerance);
+        isValid = isValid && (nRegressions == 0);
+    }
+
+    return isValid ? 0 : 1;
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Checks that models do not allocate heap memory once initialised.
+ *
+ * Every model configuration is initialised and then fed one second of
+ * noise, frame by frame and in blocks (Model::processBlock()). The program
+ * counts the allocations made by the calling thread inside Model::process()
+ * and Model::processBlock(), and Module::process() names the modules
+ * responsible (see AllocationCounter). Outputs are not aggregated, since
+ * aggregation stores every frame.
+ *
+ * Allocations are counted by replacing the C allocation functions of glibc,
+ * through which operator new and fftw_malloc allocate too. Only this
+ * program is affected: the library replaces no allocation function.
+ *
+ * Must be linked with objects of the library built with COUNT_ALLOCATIONS
+ * defined.
+ *
+ * See the check-allocations target in the Makefile.
+ */
+
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <malloc.h>
+#include "../src/support/AllocationCounter.h"
+#include "../src/support/FFT.h"
+#include "../src/models/DynamicLoudnessGM2002.h"
+#include "../src/models/DynamicLoudnessCH2012.h"
+#include "../src/models/StationaryLoudnessANSIS342007.h"
+#include "../src/models/StationaryLoudnessCHGM2011.h"
+#include "../src/models/StationaryLoudnessDIN456311991.h"
+
+using namespace loudness;
+
+/*
+ * Allocation functions of glibc, which count the allocation and forward it
+ * to glibc's implementation.
+ */
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t nElements, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void* __libc_valloc(size_t size);
+
+    void* malloc(size_t size) noexcept
+    {
+        AllocationCounter::countAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t nElements, size_t size) noexcept
+    {
+        AllocationCounter::countAllocation();
+        return __libc_calloc(nElements, size);
+    }
+
+    void* realloc(void* ptr, size_t size) noexcept
+    {
+        AllocationCounter::countAllocation();
+        return __libc_realloc(ptr, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        AllocationCounter::countAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        AllocationCounter::countAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void* valloc(size_t size) noexcept
+    {
+        AllocationCounter::countAllocation();
+        return __libc_valloc(size);
+    }
+
+    int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept
+    {
+        AllocationCounter::countAllocation();
+        if ((alignment % sizeof(void*)) || (alignment & (alignment - 1)))
+            return EINVAL;
+        void* result = __libc_memalign(alignment, size);
+        if (!result)
+            return ENOMEM;
+        *ptr = result;
+        return 0;
+    }
+}
+
+static const int fs = 32000;
+
+/*
+ * Returns true if allocations made through operator new and fftw_malloc are
+ * counted.
+ */
+static bool isCounting()
+{
+    long nAllocations = AllocationCounter::getNAllocations();
+    SignalBank bank;
+    bank.initialize(1, 1, 1, 64, fs);
+    bool isNewCounted = AllocationCounter::getNAllocations() > nAllocations;
+
+    nAllocations = AllocationCounter::getNAllocations();
+    void* buffer = FFTW(malloc)(64 * sizeof(Real));
+    bool isFFTWCounted = AllocationCounter::getNAllocations() > nAllocations;
+    FFTW(free)(buffer);
+
+    return isNewCounted && isFFTWCounted;
+}
+static const int nFrames = 100;
+
+/*
+ * Fills the signals of the input with noise, scaled by gain.
+ */
+static void fillNoise(SignalBank& input, unsigned int& seed, Real gain)
+{
+    for (int src = 0; src < input.getNSources(); ++src)
+    {
+        for (int ear = 0; ear < input.getNEars(); ++ear)
+        {
+            for (int chn = 0; chn < input.getNChannels(); ++chn)
+            {
+                Real* x = input.getSignalWritePointer(src, ear, chn);
+                for (int smp = 0; smp < input.getNSamples(); ++smp)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    x[smp] = gain * ((seed >> 8) / (Real)(1 << 24) - 0.5);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Processes nFrames inputs with the given block size and returns the number
+ * of allocations made inside the model.
+ */
+static long processModel(Model& model, const SignalBank& prototype,
+        int blockSize, bool isStationary)
+{
+    model.setOutputsToAggregate(vector<string>());
+    model.setBlockSize(blockSize);
+    if (!model.initialize(prototype))
+        return -1;
+
+    //all inputs are created before counting
+    vector<SignalBank> inputs(nFrames);
+    unsigned int seed = 1;
+    for (int i = 0; i < nFrames; ++i)
+    {
+        inputs[i].initialize(prototype);
+        if (isStationary)
+        {
+            //component intensities between 30 and 90 dB SPL
+            fillNoise(inputs[i], seed, 1.0);
+            for (int ear = 0; ear < prototype.getNEars(); ++ear)
+            {
+                for (int chn = 0; chn < prototype.getNChannels(); ++chn)
+                {
+                    Real level = 60 + 60 * inputs[i].getSample(0, ear, chn, 0);
+                    inputs[i].setSample(0, ear, chn, 0, pow(10, level / 10.0));
+                }
+            }
+        }
+        else
+        {
+            fillNoise(inputs[i], seed, 0.1);
+        }
+    }
+
+    long nAllocations = AllocationCounter::getNAllocations();
+    if (blockSize > 1)
+    {
+        model.processBlock(inputs.data(), nFrames);
+    }
+    else
+    {
+        for (int i = 0; i < nFrames; ++i)
+            model.process(inputs[i]);
+    }
+    return AllocationCounter::getNAllocations() - nAllocations;
+}
+
+template <class ModelType>
+static bool checkModel(ModelType& model, const string& name,
+        const SignalBank& prototype, bool isStationary = false)
+{
+    bool isValid = true;
+    int blockSizes[] = {1, 8};
+    for (int i = 0; i < 2; ++i)
+    {
+        ModelType copy(model);
+        AllocationCounter::resetNProcessAllocations();
+        long nAllocations = processModel(copy, prototype, blockSizes[i],
+                                         isStationary);
+        long nModuleAllocations = AllocationCounter::getNProcessAllocations();
+        bool isAllocationFree = (nAllocations == 0) && (nModuleAllocations == 0);
+        printf("%-50s %5d %12ld %12ld %s\n", name.c_str(), blockSizes[i],
+                nAllocations, nModuleAllocations,
+                isAllocationFree ? "OK" : "FAIL");
+        isValid = isValid && isAllocationFree;
+    }
+    return isValid;
+}
+
+int main()
+{
+    if (!AllocationCounter::isEnabled())
+    {
+        printf("Allocations are only counted in builds with COUNT_ALLOCATIONS.\n");
+        return 1;
+    }
+    if (!isCounting())
+    {
+        printf("Allocations through operator new or fftw_malloc are not counted.\n");
+        return 1;
+    }
+
+    printf("%-50s %5s %12s %12s\n", "Model", "Block", "Allocations",
+            "In modules");
+
+    bool isValid = true;
+    for (int nSources = 1; nSources <= 2; ++nSources)
+    {
+        for (int nEars = 1; nEars <= 2; ++nEars)
+        {
+            char config[32];
+            snprintf(config, sizeof(config), " (%d source%s, %d ear%s)",
+                    nSources, nSources > 1 ? "s" : "",
+                    nEars, nEars > 1 ? "s" : "");
+
+            const char* setsGM2002[] = {"GM2002", "Faster", "Recent",
+                                        "FasterAndRecent", "WEAR2015"};
+            for (int i = 0; i < 5; ++i)
+            {
+                DynamicLoudnessGM2002 model;
+                model.configureModelParameters(setsGM2002[i]);
+                model.setPartialLoudnessUsed(nSources > 1);
+                SignalBank input;
+                input.initialize(nSources, nEars, 1,
+                        (int)round(fs / model.getRate()), fs);
+                isValid &= checkModel(model, string("DynamicLoudnessGM2002 ")
+                        + setsGM2002[i] + config, input);
+            }
+
+            DynamicLoudnessGM2002 goertzel;
+            goertzel.setHoppingGoertzelDFTUsed(true);
+            SignalBank input;
+            input.initialize(nSources, nEars, 1,
+                    (int)round(fs / goertzel.getRate()), fs);
+            isValid &= checkModel(goertzel,
+                    string("DynamicLoudnessGM2002 Goertzel") + config, input);
+
+            DynamicLoudnessGM2002 multiRate;
+            multiRate.setMultiRateSpectrumUsed(true);
+            isValid &= checkModel(multiRate,
+                    string("DynamicLoudnessGM2002 MultiRate") + config, input);
+
+            const char* setsCH2012[] = {"CH2012", "Faster"};
+            for (int i = 0; i < 2; ++i)
+            {
+                DynamicLoudnessCH2012 model;
+                model.configureModelParameters(setsCH2012[i]);
+                model.setPartialLoudnessUsed(nSources > 1);
+                input.initialize(nSources, nEars, 1,
+                        (int)round(fs / model.getRate()), fs);
+                isValid &= checkModel(model, string("DynamicLoudnessCH2012 ")
+                        + setsCH2012[i] + config, input);
+            }
+        }
+    }
+
+    //stationary models take a power spectrum
+    int nComponents = 100;
+    RealVec freqs(nComponents);
+    for (int i = 0; i < nComponents; ++i)
+        freqs[i] = 50 * pow(10, 2.5 * i / (nComponents - 1));
+    for (int nEars = 1; nEars <= 2; ++nEars)
+    {
+        SignalBank input;
+        input.initialize(1, nEars, nComponents, 1, 1);
+        input.setCentreFreqs(freqs);
+
+        string config = nEars > 1 ? " (2 ears)" : " (1 ear)";
+        StationaryLoudnessANSIS342007 ansi;
+        isValid &= checkModel(ansi, "StationaryLoudnessANSIS342007" + config,
+                input, true);
+        StationaryLoudnessCHGM2011 chgm;
+        isValid &= checkModel(chgm, "StationaryLoudnessCHGM2011" + config,
+                input, true);
+        if (nEars == 1)
+        {
+            StationaryLoudnessDIN456311991 din;
+            isValid &= checkModel(din, "StationaryLoudnessDIN456311991" + config,
+                    input, true);
+        }
+    }
+
+    printf(isValid ? "No allocations while processing.\n"
+                   : "Allocations while processing.\n");
+    return isValid ? 0 : 1;
+}
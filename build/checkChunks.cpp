@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Checks that chunked processing (AudioFileProcessor::setNChunks()) falls
+ * back to sequential processing when the model cannot be cloned. A model
+ * whose clone() returns null processes a temporary audio file in chunks,
+ * with and without pre-roll and with more chunks than frames, and its
+ * aggregated outputs must be identical to those of sequential processing.
+ *
+ * Models exposed to Python can all be cloned, so this case is not covered
+ * by python/tests/test_AudioFileProcessor.py.
+ *
+ * See the check-chunks target in the Makefile.
+ */
+
+#include <cstdio>
+#include <unistd.h>
+#include "../src/models/DynamicLoudnessGM2002.h"
+#include "../src/support/AudioFileProcessor.h"
+
+using namespace loudness;
+
+class UnclonableModel : public DynamicLoudnessGM2002
+{
+    virtual unique_ptr<Model> clone() const
+    {
+        return unique_ptr<Model>();
+    }
+};
+
+/*
+ * Writes one second of a 1 kHz tone whose level changes every 0.25 seconds.
+ */
+static bool writeTestFile(const string& fileName, int fs)
+{
+    const Real levels[] = {40, 70, 55, 80};
+    vector<float> signal(fs);
+    for (int i = 0; i < fs; ++i)
+    {
+        Real level = levels[(4 * i / fs) % 4];
+        signal[i] = 2e-5 * pow(10, level / 20.0) * sqrt(2)
+                    * sin(2 * PI * 1000 * i / fs);
+    }
+
+    SF_INFO fileInfo;
+    fileInfo.samplerate = fs;
+    fileInfo.channels = 1;
+    fileInfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+    SNDFILE* sndFile = sf_open(fileName.c_str(), SFM_WRITE, &fileInfo);
+    if (!sndFile)
+        return false;
+    bool isWritten = sf_writef_float(sndFile, signal.data(), fs) == fs;
+    return (sf_close(sndFile) == 0) && isWritten;
+}
+
+static vector<RealVec> processFile(AudioFileProcessor& processor,
+        Model& model, int nChunks, Real chunkPreRoll)
+{
+    processor.setNChunks(nChunks);
+    processor.setChunkPreRoll(chunkPreRoll);
+    processor.processAllFrames(model);
+    vector<RealVec> outputs;
+    for (const auto& outputName : model.getOutputsToAggregate())
+        outputs.push_back(model.getOutput(outputName).getAggregatedSignals());
+    return outputs;
+}
+
+int main()
+{
+    char fileName[] = "/tmp/loudnessChunksXXXXXX";
+    int fd = mkstemp(fileName);
+    if (fd < 0)
+    {
+        printf("Cannot create a temporary audio file\n");
+        return 1;
+    }
+    close(fd);
+    if (!writeTestFile(fileName, 32000))
+    {
+        printf("Cannot write %s\n", fileName);
+        remove(fileName);
+        return 1;
+    }
+
+    vector<string> outputNames = {"ShortTermLoudness", "LongTermLoudness"};
+    DynamicLoudnessGM2002 model;
+    model.setRate(250);
+    model.setOutputsToAggregate(outputNames);
+    AudioFileProcessor processor(fileName);
+    processor.initialize(model);
+    vector<RealVec> sequential = processFile(processor, model, 1, 0);
+
+    UnclonableModel unclonable;
+    unclonable.setRate(250);
+    unclonable.setOutputsToAggregate(outputNames);
+    processor.initialize(unclonable);
+    int nFrames = processor.getNFrames();
+
+    bool isOK = true;
+    const int nChunks[] = {2, 4, nFrames + 3};
+    const Real chunkPreRolls[] = {0.0, 0.1};
+    printf("%-10s %-10s %s\n", "Chunks", "Pre-roll", "Outputs");
+    for (int n : nChunks)
+    {
+        for (Real chunkPreRoll : chunkPreRolls)
+        {
+            bool isIdentical = processFile(processor, unclonable, n,
+                                           chunkPreRoll) == sequential;
+            printf("%-10d %-10g %s\n", n, chunkPreRoll,
+                    isIdentical ? "identical" : "DIFFERENT");
+            isOK &= isIdentical;
+        }
+    }
+    remove(fileName);
+
+    if (isOK)
+        printf("Models that cannot be cloned are processed sequentially.\n");
+    else
+        printf("Chunked processing of a model that cannot be cloned differs "
+               "from sequential processing.\n");
+
+    return isOK ? 0 : 1;
+}
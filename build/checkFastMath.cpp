@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Sweeps the fast elementary functions of FastMath.h over the arguments used
+ * by the models and reports their largest error in ulp, measured against the
+ * long double functions of the standard library. The program fails if an
+ * error exceeds the bound documented in FastMath.h.
+ *
+ * Ranges:
+ * - fastExp and fastCosh: the whole domain, [-708, 709] and [-708, 708]
+ *   (roex weights use e^-pg, binaural inhibition cosh of loudness ratios).
+ * - fastLog and fastLog10: all positive normal numbers.
+ * - fastPow: x over [1e-300, 1e300] for the exponents of the specific
+ *   loudness and binaural inhibition equations, wherever x^y is a normal
+ *   number (|y log(x)| <= 708).
+ *
+ * See the check-fast-math target in the Makefile.
+ */
+
+#include <cstdio>
+#include <cmath>
+#include "../src/support/FastMath.h"
+
+using namespace loudness;
+
+//Documented bounds (ulp)
+#define EXP_BOUND 1.2
+#define LOG_BOUND 1.0
+#define LOG10_BOUND 2.0
+#define COSH_BOUND 2.0
+#define POW_BOUND(yLogX) (2.0 + 2.0 * std::fabs(yLogX))
+
+static const int nPoints = 2000000;
+
+/** Error of value in ulp of the double nearest to reference. */
+static double ulpError(double value, long double reference)
+{
+    int exponent;
+    std::frexp ((double)reference, &exponent);
+    long double ulp = std::ldexp (1.0L, exponent - 53);
+    return (double)(std::fabs (value - reference) / ulp);
+}
+
+/** Uniform pseudo random number in [0, 1). */
+static double uniform(unsigned long long& seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (seed >> 11) / 9007199254740992.0;
+}
+
+static bool report(const char* name, const char* range, double maxError,
+        double atArg, double bound)
+{
+    bool isOK = maxError <= bound;
+    printf("%-10s %-32s %8.3f %12.4g %8.3f  %s\n", name, range, maxError,
+            atArg, bound, isOK ? "OK" : "FAIL");
+    return isOK;
+}
+
+int main()
+{
+    bool isOK = true;
+    unsigned long long seed = 1;
+    printf("%-10s %-32s %8s %12s %8s\n", "Function", "Range", "Max ulp",
+            "At", "Bound");
+
+    double maxError = 0, atArg = 0;
+    for (int i = 0; i <= nPoints; ++i)
+    {
+        double x = i < nPoints ? -708.0 + 1417.0 * uniform (seed) : 709.0;
+        double error = ulpError (fastExp (x), std::exp ((long double)x));
+        if (error > maxError)
+        {
+            maxError = error;
+            atArg = x;
+        }
+    }
+    isOK &= report ("fastExp", "[-708, 709]", maxError, atArg, EXP_BOUND);
+
+    maxError = 0;
+    for (int i = 0; i < nPoints; ++i)
+    {
+        double x = -708.0 + 1416.0 * uniform (seed);
+        double error = ulpError (fastCosh (x), std::cosh ((long double)x));
+        if (error > maxError)
+        {
+            maxError = error;
+            atArg = x;
+        }
+    }
+    isOK &= report ("fastCosh", "[-708, 708]", maxError, atArg, COSH_BOUND);
+
+    //half of the points close to 1, where the logarithm is small
+    double maxLogError = 0, maxLog10Error = 0, atLogArg = 0, atLog10Arg = 0;
+    for (int i = 0; i < nPoints; ++i)
+    {
+        double x;
+        if (i % 2)
+            x = std::ldexp (1.0 + uniform (seed), (int)(2046 * uniform (seed)) - 1022);
+        else
+            x = 0.5 + 1.5 * uniform (seed);
+        double error = ulpError (fastLog (x), std::log ((long double)x));
+        if (error > maxLogError)
+        {
+            maxLogError = error;
+            atLogArg = x;
+        }
+        error = ulpError (fastLog10 (x), std::log10 ((long double)x));
+        if (error > maxLog10Error)
+        {
+            maxLog10Error = error;
+            atLog10Arg = x;
+        }
+    }
+    isOK &= report ("fastLog", "[2.2e-308, 1.8e308]", maxLogError,
+            atLogArg, LOG_BOUND);
+    isOK &= report ("fastLog10", "[2.2e-308, 1.8e308]", maxLog10Error,
+            atLog10Arg, LOG10_BOUND);
+
+    //ratio of error to bound, which depends on y log(x)
+    const double exponents[] = {0.2, 0.3, 0.5, 1.5, 1.5978};
+    for (int e = 0; e < 5; ++e)
+    {
+        double y = exponents[e];
+        double maxRatio = 0, maxPowError = 0, atRatio = 0;
+        for (int i = 0; i < nPoints; ++i)
+        {
+            double x = std::pow (10.0, -300.0 + 600.0 * uniform (seed));
+            long double yLogX = y * std::log ((long double)x);
+            if (std::fabs (yLogX) > 708)
+                continue;
+            double error = ulpError (fastPow (x, y),
+                    std::pow ((long double)x, (long double)y));
+            double ratio = error / POW_BOUND (yLogX);
+            if (ratio > maxRatio)
+            {
+                maxRatio = ratio;
+                atRatio = x;
+            }
+            maxPowError = std::fmax (maxPowError, error);
+        }
+        char name[32], range[64];
+        snprintf (name, sizeof(name), "fastPow");
+        snprintf (range, sizeof(range), "x^%g, x in [1e-300, 1e300]", y);
+        printf("%-10s %-32s %8.3f %12s %8s\n", name, range, maxPowError, "",
+                "");
+        isOK &= report ("", "  worst error / bound", maxRatio, atRatio, 1.0);
+    }
+
+    if (isOK)
+        printf("All errors within the documented bounds.\n");
+    else
+        printf("Errors exceed the documented bounds.\n");
+
+    return isOK ? 0 : 1;
+}
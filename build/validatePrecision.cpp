@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compares a single-precision build (SINGLE_PRECISION, Real = float) against
+ * the double-precision build for every DynamicLoudnessGM2002 and
+ * DynamicLoudnessCH2012 parameter set.
+ *
+ * Built against the double-precision library, the program writes the
+ * instantaneous, short-term and long-term loudness of a set of test signals
+ * to the reference file. Built against the single-precision library, it
+ * processes the same signals, reads the reference file and reports the
+ * maximum deviation in sones and phons for each parameter set. The program
+ * fails if a deviation exceeds MAX_SONE_DEVIATION or MAX_PHON_DEVIATION.
+ * Measured worst cases are about 1e-2 sones and 5e-3 phons, for the
+ * faster parameter sets (Faster, FasterAndRecent and WEAR2015).
+ *
+ * Usage: validatePrecision <reference file>
+ *
+ * See the validate-precision target in the Makefile.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include "../src/support/AuditoryTools.h"
+#include "../src/models/DynamicLoudnessGM2002.h"
+#include "../src/models/DynamicLoudnessCH2012.h"
+
+using namespace loudness;
+
+//Loudness values below this (in sones) are ignored when comparing phons
+#define MIN_SONE_FOR_PHONS 0.003
+
+//Largest deviations of the single-precision build accepted
+#define MAX_SONE_DEVIATION 0.02
+#define MAX_PHON_DEVIATION 0.01
+
+static const int fs = 32000;
+static const char* outputNames[] = {"InstantaneousLoudness",
+                                    "ShortTermLoudness",
+                                    "LongTermLoudness"};
+
+/*
+ * One second test signal of nEars channels: pink-ish noise at 40 dB SPL, a
+ * 1 kHz tone at 70 dB SPL, noise at 90 dB SPL and a 250 ms gap. The second
+ * ear, if any, is attenuated by 10 dB to exercise binaural inhibition.
+ */
+static void generateSignal(vector<double>& signal, int nEars)
+{
+    int nSamples = fs;
+    signal.assign(nSamples * nEars, 0.0);
+    unsigned int seed = 1;
+    double b0 = 0, b1 = 0;
+    for (int i = 0; i < nSamples; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double white = (seed >> 8) / (double)(1 << 24) - 0.5;
+        b0 = 0.99765 * b0 + white * 0.0990460;
+        b1 = 0.96300 * b1 + white * 0.2965164;
+        double pink = (b0 + b1 + white * 0.1848) * 3.0;
+
+        double x = 0.0;
+        if (i < nSamples / 4)
+            x = 2e-5 * pow(10, 40 / 20.0) * pink;
+        else if (i < nSamples / 2)
+            x = 2e-5 * pow(10, 70 / 20.0) * sqrt(2) * sin(2 * PI * 1000 * i / fs);
+        else if (i < 3 * nSamples / 4)
+            x = 2e-5 * pow(10, 90 / 20.0) * pink;
+
+        for (int ear = 0; ear < nEars; ++ear)
+            signal[ear * nSamples + i] = x * (ear ? 0.316227766 : 1.0);
+    }
+}
+
+static void processSignal(Model& model, int nEars, vector<double>& loudness)
+{
+    model.setOutputsToAggregate(vector<string>(outputNames, outputNames + 3));
+
+    int hopSize = (int)round(fs / model.getRate());
+    SignalBank input;
+    input.initialize(1, nEars, 1, hopSize, fs);
+    model.initialize(input);
+
+    vector<double> signal;
+    generateSignal(signal, nEars);
+    int nSamples = signal.size() / nEars;
+    for (int smp = 0; smp + hopSize <= nSamples; smp += hopSize)
+    {
+        for (int ear = 0; ear < nEars; ++ear)
+        {
+            for (int i = 0; i < hopSize; ++i)
+                input.setSample(0, ear, 0, i, signal[ear * nSamples + smp + i]);
+        }
+        model.process(input);
+    }
+
+    loudness.clear();
+    for (int i = 0; i < 3; ++i)
+    {
+        const RealVec& values = model.getOutput(outputNames[i])
+                                .getAggregatedSignals();
+        loudness.insert(loudness.end(), values.begin(), values.end());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        printf("Usage: %s <reference file>\n", argv[0]);
+        return 1;
+    }
+
+    bool isReference = sizeof(Real) == sizeof(double);
+    FILE* file = fopen(argv[1], isReference ? "w" : "r");
+    if (!file)
+    {
+        printf("Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    const char* setsGM2002[] = {"GM2002", "Faster", "Recent",
+                                "FasterAndRecent", "WEAR2015"};
+    const char* setsCH2012[] = {"CH2012", "Faster"};
+
+    if (!isReference)
+    {
+        printf("%-38s %5s %14s %14s %14s\n", "Parameter set", "Ears",
+               "max |dSone|", "max rel. (%)", "max |dPhon|");
+    }
+
+    bool isValid = true;
+    for (int i = 0; i < 7; ++i)
+    {
+        for (int nEars = 1; nEars <= 2; ++nEars)
+        {
+            string name;
+            vector<double> loudness;
+            if (i < 5)
+            {
+                DynamicLoudnessGM2002 model;
+                model.configureModelParameters(setsGM2002[i]);
+                name = string("DynamicLoudnessGM2002 ") + setsGM2002[i];
+                processSignal(model, nEars, loudness);
+            }
+            else
+            {
+                DynamicLoudnessCH2012 model;
+                model.configureModelParameters(setsCH2012[i - 5]);
+                name = string("DynamicLoudnessCH2012 ") + setsCH2012[i - 5];
+                processSignal(model, nEars, loudness);
+            }
+
+            if (isReference)
+            {
+                fprintf(file, "%zu\n", loudness.size());
+                for (uint j = 0; j < loudness.size(); ++j)
+                    fprintf(file, "%.17g\n", loudness[j]);
+                printf("Wrote %s (%d ear%s)\n", name.c_str(), nEars,
+                       nEars > 1 ? "s" : "");
+                continue;
+            }
+
+            size_t nValues = 0;
+            if ((fscanf(file, "%zu", &nValues) != 1)
+                    || (nValues != loudness.size()))
+            {
+                printf("%s: reference does not match this build\n",
+                       name.c_str());
+                isValid = false;
+                break;
+            }
+
+            bool isANSIS342007 = (i == 2) || (i == 3) || (i == 4);
+            double maxSone = 0, maxRel = 0, maxPhon = 0;
+            for (uint j = 0; j < nValues; ++j)
+            {
+                double ref = 0.0;
+                if (fscanf(file, "%lf", &ref) != 1)
+                    isValid = false;
+                double dif = std::abs(loudness[j] - ref);
+                maxSone = std::max(maxSone, dif);
+                if (ref > MIN_SONE_FOR_PHONS)
+                {
+                    maxRel = std::max(maxRel, 100.0 * dif / ref);
+                    double phon = soneToPhonMGB1997(loudness[j], isANSIS342007);
+                    double refPhon = soneToPhonMGB1997(ref, isANSIS342007);
+                    maxPhon = std::max(maxPhon, std::abs(phon - refPhon));
+                }
+            }
+            bool isAccurate = (maxSone <= MAX_SONE_DEVIATION)
+                              && (maxPhon <= MAX_PHON_DEVIATION);
+            printf("%-38s %5d %14.3e %14.3e %14.3e %s\n", name.c_str(), nEars,
+                   maxSone, maxRel, maxPhon, isAccurate ? "OK" : "FAIL");
+            isValid = isValid && isAccurate;
+        }
+    }
+
+    fclose(file);
+    if (!isReference)
+    {
+        printf(isValid ? "Single precision within %g sones and %g phons.\n"
+                       : "Single precision exceeds %g sones or %g phons.\n",
+               MAX_SONE_DEVIATION, MAX_PHON_DEVIATION);
+    }
+    return isValid ? 0 : 1;
+}
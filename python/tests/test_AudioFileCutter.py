@@ -1,3 +1,6 @@
+import os
+import shutil
+import tempfile
 import numpy as np
 import loudness as ln
 import soundfile as sf
@@ -24,3 +27,82 @@ if np.allclose(y, x):
     print "Test comparing result of AudioFileCutter with sf.read: successful"
 else:
     print "Test comparing result of AudioFileCutter with sf.read: unsuccessful"
+
+# Memory mapped WAV files should give the same frames as libsndfile, for
+# every sample format that can be mapped
+def readFrames(audio):
+    audioBank = audio.getOutput()
+    out = np.zeros((audio.getNFrames(), audioBank.getNEars(), frameSize))
+    for frame in range(audio.getNFrames()):
+        audio.process()
+        for ear in range(audioBank.getNEars()):
+            out[frame, ear] = audioBank.getSignal(ear, 0)
+    return out
+
+tmpDir = tempfile.mkdtemp()
+np.random.seed(1)
+noise = np.clip(np.random.randn(5000, 2) * 0.3, -1, 1)
+for fileFormat in ['WAV', 'WAVEX']:
+    for subtype in ['PCM_16', 'PCM_24', 'PCM_32', 'FLOAT']:
+        fileName = os.path.join(tmpDir, subtype + '.wav')
+        sf.write(fileName, noise, fs, format=fileFormat, subtype=subtype)
+        audio = ln.AudioFileCutter(fileName, frameSize)
+        audio.setGainInDecibels(-3)
+        audio.initialize()
+        mapped = readFrames(audio)
+        isMapped = audio.isMemoryMapped()
+        audio.setMemoryMappingUsed(False)
+        audio.initialize()
+        unmapped = readFrames(audio)
+        if isMapped and np.array_equal(mapped, unmapped):
+            print "Test comparing memory mapped and libsndfile reads of", \
+                fileFormat, subtype, ": successful"
+        else:
+            print "Test comparing memory mapped and libsndfile reads of", \
+                fileFormat, subtype, ": unsuccessful"
+shutil.rmtree(tmpDir)
+
+# With read-ahead, compressed files should give the same frames as decoding
+# on the calling thread, however often the decode thread is restarted by
+# seeking, resetting or initialising part way through a buffer
+tmpDir = tempfile.mkdtemp()
+np.random.seed(2)
+noise = np.clip(np.random.randn(40000, 2) * 0.3, -1, 1)
+fileName = os.path.join(tmpDir, 'noise.flac')
+sf.write(fileName, noise, fs, format='FLAC', subtype='PCM_16')
+for frameSize in [32, 441]:
+    audio = ln.AudioFileCutter(fileName, frameSize)
+    audio.setGainInDecibels(-3)
+    audio.initialize()
+    expected = readFrames(audio)
+    nFrames = audio.getNFrames()
+
+    audio.setReadAheadUsed(True)
+    audio.initialize()
+    assert audio.isReadAhead()
+    audioBank = audio.getOutput()
+    frame = 0
+    for step in range(200):
+        for i in range(np.random.randint(0, 2 * nFrames / 10)):
+            audio.process()
+            out = np.array([audioBank.getSignal(ear, 0)
+                            for ear in range(audioBank.getNEars())])
+            if frame < nFrames:
+                assert np.array_equal(out, expected[frame])
+            else:
+                assert np.all(out == 0)
+            frame += 1
+        action = np.random.randint(0, 3)
+        if action == 0:
+            frame = np.random.randint(-2, nFrames + 2)
+            audio.seek(frame)
+            frame = max(frame, 0)
+        elif action == 1:
+            audio.reset()
+            frame = 0
+        else:
+            audio.initialize()
+            frame = 0
+    assert audio.isReadAhead()
+shutil.rmtree(tmpDir)
+print 'Test of read-ahead with seeking and initialisation: successful'
@@ -1,5 +1,10 @@
+import os
+import shutil
+import tempfile
+import numpy as np
 import matplotlib.pyplot as plt
 import loudness as ln
+import soundfile as sf
 
 model = ln.DynamicLoudnessGM2002()
 model.setRate(250)
@@ -10,12 +15,98 @@ processor = ln.AudioFileProcessor(
     '../../wavs/pureTones/pureTone_1000Hz_40dBSPL_32000Hz.wav'
 )
 processor.setGainInDecibels(10)
+processor.setNThreads(1)
 processor.initialize(model)
 
 processor.processAllFrames(model)
 
+sequential = {}
 for output in outputs:
     bankSTL = model.getOutput(output)
     aggregatedFrames = bankSTL.getAggregatedSignals()
+    sequential[output] = aggregatedFrames.flatten()
     plt.plot(aggregatedFrames.flatten())
 plt.show()
+
+# Block processing equals frame-by-frame processing to rounding (full
+# blocks use a batched FFT plan)
+model.setBlockSize(8)
+processor.initialize(model)
+processor.processAllFrames(model)
+for output in outputs:
+    blocked = model.getOutput(output).getAggregatedSignals().flatten()
+    tolerance = 1000 * np.finfo(blocked.dtype).eps * \
+        np.abs(sequential[output]).max()
+    assert blocked.size == sequential[output].size
+    assert np.abs(blocked - sequential[output]).max() <= tolerance
+print 'Test comparing block and frame-by-frame processing: successful'
+model.setBlockSize(1)
+processor.initialize(model)
+
+# Multithreaded processing is bit-identical to sequential processing
+processor.setNThreads(4)
+processor.processAllFrames(model)
+for output in outputs:
+    threaded = model.getOutput(output).getAggregatedSignals().flatten()
+    assert np.array_equal(threaded, sequential[output])
+print 'Test comparing 4 threads and sequential processing: successful'
+processor.setNThreads(1)
+
+# Chunked processing approximates sequential processing. The test signal is
+# a 1 kHz tone whose level changes every 0.5 seconds, so that the long-term
+# loudness is still changing at every chunk boundary. With a pre-roll of 0.75
+# seconds, chunks match sequential processing to within 1e-3 of the largest
+# value of each output, and so does the stitching discrepancy measured on the
+# first 2 seconds
+def writeSteps(fileName, duration):
+    t = np.arange(int(duration * fs)) / float(fs)
+    levels = np.array([40, 70, 55, 80, 30, 65, 50, 75])
+    level = levels[(t / 0.5).astype('int') % levels.size]
+    x = 2e-5 * 10 ** (level / 20.0) * np.sqrt(2) * np.sin(2 * np.pi * 1000 * t)
+    sf.write(fileName, x, fs, subtype='FLOAT')
+
+
+def processFile(processor, model, nChunks, chunkPreRoll):
+    processor.setNChunks(nChunks)
+    processor.setChunkPreRoll(chunkPreRoll)
+    processor.processAllFrames(model)
+    return [np.copy(model.getOutput(output).getAggregatedSignals().flatten())
+            for output in outputs]
+
+fs = 32000
+tolerance = 1e-3
+tmpDir = tempfile.mkdtemp()
+fileName = os.path.join(tmpDir, 'steps.wav')
+writeSteps(fileName, 8)
+processor = ln.AudioFileProcessor(fileName)
+processor.initialize(model)
+sequential = processFile(processor, model, 1, 0)
+for nChunks in [2, 4]:
+    chunked = processFile(processor, model, nChunks, 0.75)
+    for i in range(len(outputs)):
+        assert chunked[i].size == sequential[i].size
+        assert np.abs(chunked[i] - sequential[i]).max() <= \
+            tolerance * np.abs(sequential[i]).max()
+assert processor.measureStitchingDiscrepancy(model, 2) <= tolerance
+print 'Test comparing chunked and sequential processing: successful'
+
+# More chunks than frames: the empty chunks add no output. Chunks whose
+# pre-roll reaches the start of the file are processed from the start, as
+# sequential processing does
+fileName = os.path.join(tmpDir, 'short.wav')
+writeSteps(fileName, 0.1)
+processor = ln.AudioFileProcessor(fileName)
+processor.initialize(model)
+sequential = processFile(processor, model, 1, 0)
+nChunks = processor.getNFrames() + 15
+chunked = processFile(processor, model, nChunks, 1)
+for i in range(len(outputs)):
+    assert np.array_equal(chunked[i], sequential[i])
+chunked = processFile(processor, model, nChunks, 0)
+for i in range(len(outputs)):
+    assert chunked[i].size == sequential[i].size
+shutil.rmtree(tmpDir)
+print 'Test of more chunks than frames: successful'
+
+# Models that cannot be cloned fall back to sequential processing, see
+# checkChunks.cpp (make check-chunks)
@@ -68,3 +68,63 @@ print ("Python vs loudness equality test applied to "
        + "inhibited specific loudness patterns: %r "
        % np.allclose(inhibitedSpecificLoudness,
                      model.inhibitedSpecificLoudness))
+
+
+def inhibitedPattern(specificLoudness, smoothThis, smoothOther):
+    smoothThis = np.maximum(smoothThis, 1e-12)
+    smoothOther = np.maximum(smoothOther, 1e-12)
+    with np.errstate(over='ignore'):
+        sech = 1.0 / np.cosh(smoothOther / smoothThis)
+    inhib = 2.0 / (1 + sech ** 1.5978)
+    return specificLoudness / inhib
+
+# The smoothing kernel is expanded in a Taylor series whose truncation error is
+# below the kernel tolerance for every weight, so each smoothed value is within
+# the tolerance times the sum of the pattern of the direct convolution. Since
+# the inhibition is monotonic in the ratio of the smoothed values, the output
+# must lie between the outputs for the extreme ratios this allows.
+for camStep in [0.1, 0.25, 1.0]:
+    nFilters = int(round(37.1 / camStep)) + 1
+    g = (np.arange(nFilters).reshape((-1, 1)) - np.arange(nFilters)) * camStep
+    kernel = np.exp(-(0.08 * g) ** 2)
+
+    patterns = [np.random.rand(nFilters, 2)]
+    peak = np.zeros((nFilters, 2))
+    peak[nFilters / 3, 0] = 1.0
+    patterns.append(peak)
+    ends = np.zeros((nFilters, 2))
+    ends[:nFilters / 10, 0] = np.random.rand(nFilters / 10)
+    ends[-(nFilters / 10):, 1] = np.random.rand(nFilters / 10)
+    patterns.append(ends)
+
+    bank = ln.SignalBank()
+    bank.initialize(1, 2, nFilters, 1, 1)
+    bank.setChannelSpacingInCams(camStep)
+    nTerms = []
+    for kernelTolerance in [1e-12, 1e-4]:
+        inhibition = ln.BinauralInhibitionMG2007()
+        inhibition.setKernelTolerance(kernelTolerance)
+        inhibition.initialize(bank)
+        nTerms.append(inhibition.getNKernelTerms())
+        for pattern in patterns:
+            bank.setSignals(pattern.T.reshape((1, 2, nFilters, 1)))
+            inhibition.process(bank)
+            output = inhibition.getOutput().getSignals().reshape(
+                (2, nFilters)).T
+
+            smooth = np.dot(kernel, pattern)
+            error = kernelTolerance * np.sum(pattern, 0)
+            for ear in range(2):
+                this, other = smooth[:, ear], smooth[:, 1 - ear]
+                errThis, errOther = error[ear], error[1 - ear]
+                bounds = np.vstack((
+                    inhibitedPattern(pattern[:, ear], this + errThis,
+                                     other - errOther),
+                    inhibitedPattern(pattern[:, ear], this - errThis,
+                                     other + errOther)))
+                lower = np.min(bounds, 0) * (1 - 1e-12)
+                upper = np.max(bounds, 0) * (1 + 1e-12)
+                assert np.all(output[:, ear] >= lower)
+                assert np.all(output[:, ear] <= upper)
+    assert nTerms[1] < nTerms[0]
+print 'Test of separable smoothing against direct convolution: successful'
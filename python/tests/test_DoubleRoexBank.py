@@ -165,3 +165,28 @@ if __name__ == '__main__':
                  np.log10(excitationLN + 1e-10), 'r--', marker='o')
     plt.show()
     print "Equality test: ", np.allclose(excitationLN, excitationPy[:, 0])
+    assert np.allclose(excitationLN, excitationPy[:, 0])
+
+    # The filter weights are stored as sparse matrices. Weights below the
+    # default tolerance only change the output by rounding, so banks with and
+    # without the tolerance match the dense weighting equally well.
+    nSources = 2
+    psd = 10 ** ((20 * np.random.randn(nSources, 1, halfPoints, 1) + 70) / 10.0)
+    psd /= halfPoints
+    psdLN = ln.SignalBank()
+    psdLN.initialize(nSources, 1, halfPoints, 1, 32000)
+    psdLN.setCentreFreqs(inputFreqs)
+    psdLN.setSignals(psd)
+
+    banks = [ln.DoubleRoexBank, ln.FixedRoexBank, ln.MultiSourceDoubleRoexBank]
+    for Bank in banks:
+        excitation = []
+        for tolerance in [1e-12, 0.0]:
+            bankLN = Bank()
+            bankLN.setWeightTolerance(tolerance)
+            bankLN.initialize(psdLN)
+            bankLN.process(psdLN)
+            excitation.append(np.copy(bankLN.getOutput().getSignals()))
+        dif = np.abs(excitation[0] - excitation[1]).max()
+        assert dif <= 1e-10 * np.abs(excitation[1]).max()
+    print 'Test comparing sparse and dense filter weights: successful'
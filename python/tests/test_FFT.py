@@ -0,0 +1,43 @@
+import os
+import tempfile
+import loudness as ln
+
+# FFT objects of the same size share one plan
+ln.FFT.clearPlans()
+assert ln.FFT.getNPlans() == 0
+
+fft1 = ln.FFT(1024)
+fft1.initialize()
+fft2 = ln.FFT(1024)
+fft2.initialize()
+assert ln.FFT.getNPlans() == 1
+print 'Test sharing of plans: successful'
+
+# A batch needs a plan of its own
+fft3 = ln.FFT(1024, 4)
+fft3.initialize()
+assert ln.FFT.getNPlans() == 2
+
+# Wisdom is written to the file every time a plan is created and can be read
+# back
+wisdomDir = tempfile.mkdtemp()
+wisdomFile = os.path.join(wisdomDir, 'fft.wisdom')
+assert not ln.FFT.setWisdomFile(wisdomFile)
+assert not os.path.exists(wisdomFile)
+
+fft4 = ln.FFT(1000)
+fft4.initialize()
+assert os.path.getsize(wisdomFile) > 0
+assert ln.FFT.importWisdom(wisdomFile)
+
+ln.FFT.setWisdomFile('')
+ln.FFT.clearPlans()
+assert ln.FFT.getNPlans() == 0
+assert ln.FFT.setWisdomFile(wisdomFile)
+
+# No temporary files are left behind
+assert os.listdir(wisdomDir) == ['fft.wisdom']
+ln.FFT.setWisdomFile('')
+os.remove(wisdomFile)
+os.rmdir(wisdomDir)
+print 'Test of wisdom file: successful'
@@ -37,3 +37,38 @@ for i in range(2):
         out[ear, start:end] = outBank.getSignal(0, ear, 0)
 
 print np.allclose(out, y)
+
+# Long filters are applied by partitioned FFT convolution
+nSamples = 4096
+nCoefficients = 2048
+blockSize = 256
+
+x = np.random.randn(2, nSamples)
+b = np.random.randn(nCoefficients)
+
+y = lfilter(b, [1.0], x)
+
+bank = ln.SignalBank()
+bank.initialize(nSources, nEars, 1, blockSize, 1)
+
+fir = ln.FIR(b)
+fir.initialize(bank)
+outBank = fir.getOutput()
+print fir.isConvolutionUsed()
+
+out = np.zeros(x.shape)
+
+for i in range(nSamples / blockSize):
+
+    start = blockSize*i
+    end = start + blockSize
+
+    for ear in range(nEars):
+        bank.setSignal(0, ear, 0, x[ear, start:end])
+
+    fir.process(bank)
+
+    for ear in range(nEars):
+        out[ear, start:end] = outBank.getSignal(0, ear, 0)
+
+print np.allclose(out, y)
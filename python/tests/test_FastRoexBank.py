@@ -0,0 +1,102 @@
+import numpy as np
+import loudness as ln
+
+'''
+FastRoexBank only loops over the components within reach of each filter and
+sums the rest with the weight at the end of its roex table. The excitation
+pattern should equal that of applying the table lookups to every component up
+to g = 2, whatever the level step of the support tables.
+'''
+
+
+def camToHertz(cam):
+    return (10 ** (cam / 21.366) - 1) / 4368e-6
+
+
+def hertzToCam(freq):
+    return 21.366 * np.log10(4368e-6 * freq + 1)
+
+
+def cambridgeERB(freq):
+    return 24.673 * (4368e-6 * freq + 1)
+
+
+def fastRoexBank(psd, freqs, camStep, levelStep=None):
+    '''
+    Applies the roex table to every component. If levelStep is given, the
+    levels per ERB are rounded to the nearest level step.
+    '''
+    # level per ERB of each component, minus 51 dB
+    cams = hertzToCam(freqs)
+    fLo = camToHertz(cams - 0.5)
+    fHi = camToHertz(cams + 0.5)
+    compLevel = np.zeros(freqs.size)
+    for i in range(freqs.size):
+        power = np.sum(psd[(freqs >= fLo[i]) & (freqs <= fHi[i])])
+        compLevel[i] = 10 * np.log10(power) if power > 1e-10 else -100
+    compLevel -= 51
+
+    nFilters = int(np.floor((38.9 - 1.8) / camStep)) + 1
+    fc = camToHertz(1.8 + np.arange(nFilters) * camStep).reshape((-1, 1))
+    pu = 4 * fc / cambridgeERB(fc)
+    levelSlope = 0.35 / (4000.0 / cambridgeERB(1000.0))
+    if levelStep is not None:
+        nLevels = int(np.ceil((1 / levelSlope + 151.0) / levelStep)) + 1
+        level = ((compLevel + 151.0) / levelStep + 0.5).astype('int')
+        compLevel = -151.0 + np.clip(level, 0, nLevels - 1) * levelStep
+
+    step = 20.48 / 1024
+    pgTable = step * np.arange(1024)
+    roexTable = (1 + pgTable) * np.exp(-pgTable)
+
+    g = (freqs - fc) / fc
+    levelFactor = np.maximum(1 - levelSlope * compLevel, 0.1 / pu)
+    p = np.where(g < 0, levelFactor * pu, pu)
+    idx = np.minimum((p * np.abs(g) / step + 0.5).astype('int'), 1023)
+    weights = roexTable[idx]
+    weights[g > 2] = 0
+    return np.dot(weights, psd)
+
+
+def excitationPattern(psd, camStep, levelStep, isLevelQuantised):
+    psdLN = ln.SignalBank()
+    psdLN.initialize(1, 1, psd.size, 1, fs)
+    psdLN.setCentreFreqs(freqs)
+    psdLN.setSignals(psd.reshape((1, 1, psd.size, 1)))
+    bank = ln.FastRoexBank(camStep)
+    bank.setLevelStepInDecibels(levelStep)
+    bank.setLevelQuantised(isLevelQuantised)
+    bank.initialize(psdLN)
+    bank.process(psdLN)
+    return np.copy(bank.getOutput().getSignals().flatten())
+
+fs = 32000
+N = 2048
+freqs = np.arange(N / 2 + 1) * fs / float(N)
+
+# noise at different levels, and a loud tone on quiet noise
+spectra = []
+for level in [20, 70, 100]:
+    spectra.append(10 ** ((10 * np.random.randn(freqs.size) + level) / 10.0))
+tone = 10 ** ((10 * np.random.randn(freqs.size) + 10) / 10.0)
+tone[64] = 10 ** 11
+spectra.append(tone)
+
+for camStep in [0.25, 1.0]:
+    for psd in spectra:
+        expected = fastRoexBank(psd, freqs, camStep)
+        for levelStep in [0.25, 1.0, 6.0]:
+            excitation = excitationPattern(psd, camStep, levelStep, False)
+            assert np.allclose(excitation, expected,
+                               rtol=1e-10, atol=1e-10 * np.max(expected))
+print 'Test of FastRoexBank against all components: successful'
+
+# With quantised levels, the weights come from tables per level step
+for camStep in [0.25, 1.0]:
+    for psd in spectra:
+        for levelStep in [0.5, 1.0]:
+            expected = fastRoexBank(psd, freqs, camStep, levelStep)
+            excitation = excitationPattern(psd, camStep, levelStep, True)
+            assert np.allclose(excitation, expected,
+                               rtol=1e-10, atol=1e-10 * np.max(expected))
+print 'Test of FastRoexBank with quantised levels: successful'
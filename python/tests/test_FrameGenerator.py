@@ -50,5 +50,60 @@ if startAtWindowCentre:
 for ear in range(nEars):
     for i, frame in enumerate(frames[ear]):
         start = i * hopSize
-        if all(frame != x[start:start + frameSize]):
-            print("Frame number %d incorrect" % i)
+        assert np.array_equal(frame, x[start:start + frameSize]), \
+            "Frame number %d incorrect" % i
+print 'Test of frames read without targets: successful'
+
+
+def windowedFrames(frameSize, hopSize, bufSize, isAggregated):
+    '''
+    Windowed frames of a two-ear ramp from a FrameGenerator feeding a Window.
+    The frame is a ring buffer unless the output of the FrameGenerator is
+    aggregated, which linearises it.
+    '''
+    nEars = 2
+    inputBank = ln.SignalBank()
+    inputBank.initialize(1, nEars, 1, bufSize, int(fs))
+    frameGen = ln.FrameGenerator(frameSize, hopSize, True)
+    window = ln.Window(ln.Window.HANN, frameSize, True)
+    frameGen.addTargetModule(window)
+    frameGen.setOutputAggregated(isAggregated)
+    frameGen.initialize(inputBank)
+    outputBank = window.getOutput()
+
+    frames = []
+    for block in range(4 * frameSize / bufSize):
+        for ear in range(nEars):
+            idx = block * bufSize
+            inputBank.setSignal(0, ear, 0,
+                                (ear + 1.0) * np.arange(idx, idx + bufSize))
+        frameGen.process(inputBank)
+        if outputBank.getTrig():
+            frames.append(np.copy(outputBank.getSignals()))
+    return np.array(frames)
+
+# Frames read from the ring buffer equal linearised frames
+for frameSize, hopSize, bufSize in [(2048, 32, 32), (2048, 48, 32), (100, 30, 30)]:
+    ring = windowedFrames(frameSize, hopSize, bufSize, False)
+    linear = windowedFrames(frameSize, hopSize, bufSize, True)
+    assert ring.shape[0] > 0
+    assert np.array_equal(ring, linear)
+print 'Test comparing ring buffer and linearised frames: successful'
+
+# When processing in parallel, the frames are linearised since the Window
+# runs on other threads
+wavFile = '../../wavs/pureTones/pureTone_1000Hz_40dBSPL_32000Hz.wav'
+excitation = []
+for nThreads in [1, 4]:
+    model = ln.DynamicLoudnessGM2002()
+    model.setRate(250)
+    model.setOutputsToAggregate(['Excitation'])
+    cutter = ln.AudioFileCutter(wavFile, 128)
+    cutter.initialize()
+    model.initialize(cutter.getOutput())
+    model.processInParallel(cutter, cutter.getNFrames(), nThreads)
+    excitation.append(
+        np.copy(model.getOutput('Excitation').getAggregatedSignals()))
+assert excitation[0].size > 0
+assert np.array_equal(excitation[0], excitation[1])
+print 'Test comparing sequential and parallel frames: successful'
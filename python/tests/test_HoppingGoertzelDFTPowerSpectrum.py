@@ -0,0 +1,91 @@
+import numpy as np
+import loudness as ln
+
+'''
+The power spectra of HoppingGoertzelDFT compared with those computed by
+FrameGenerator and PowerSpectrum.
+'''
+
+fs = 32000
+windowSize = 2048
+hopSize = 256
+bands = np.array([50, 5000.0])
+
+
+def powerSpectrumModules(nEars):
+    inputBank = ln.SignalBank()
+    inputBank.initialize(1, nEars, 1, hopSize, fs)
+    frameGen = ln.FrameGenerator(windowSize, hopSize, True)
+    spectrum = ln.PowerSpectrum(bands, [windowSize], False)
+    spectrum.setWindow(ln.Window.HANN, True)
+    frameGen.addTargetModule(spectrum)
+    frameGen.initialize(inputBank)
+    return inputBank, frameGen, spectrum
+
+
+# With a target spacing, runs of closely spaced bins are replaced by one bin
+# whose bandwidth spans the run. A tone at the centre frequency of an output
+# bin should then have the power that PowerSpectrum puts in its main lobe (2/3
+# of the power of a tone centred on a bin of a periodic Hann window).
+targetSpacing = 0.5
+maxCentreErrorInDecibels = 1.0
+
+inputBank, frameGen, spectrum = powerSpectrumModules(1)
+full = ln.HoppingGoertzelDFT(bands, [windowSize], hopSize, True, True)
+full.initialize(inputBank)
+compact = ln.HoppingGoertzelDFT(bands, [windowSize], hopSize, True, True)
+compact.setTargetSpacingInCams(targetSpacing)
+compact.initialize(inputBank)
+
+nFullBins = full.getOutput().getNChannels()
+nBins = compact.getOutput().getNChannels()
+assert nFullBins == spectrum.getOutput().getNChannels()
+assert nBins < nFullBins / 4
+print 'Bins with target spacing of %.1f Cams: %d of %d' % (targetSpacing,
+                                                          nBins, nFullBins)
+
+t = np.arange(40 * hopSize) / float(fs)
+for bin in range(nBins):
+    freq = compact.getOutput().getCentreFreq(bin)
+    x = 2e-5 * np.sqrt(2) * 1000 * np.sin(2 * np.pi * freq * t)
+    compact.reset()
+    frameGen.reset()
+    for block in range(40):
+        inputBank.setSignal(0, 0, 0, x[block * hopSize:(block + 1) * hopSize])
+        compact.process(inputBank)
+        frameGen.process(inputBank)
+    binPower = compact.getOutput().getSignals().flatten()[bin]
+    mainLobePower = np.sum(spectrum.getOutput().getSignals()) * 2 / 3.0
+    error = 10 * np.log10(binPower / mainLobePower)
+    assert abs(error) < maxCentreErrorInDecibels, \
+        'Bin %d at %.1f Hz is off by %.2f dB' % (bin, freq, error)
+print 'Test of power at the centre frequencies of the target bins: successful'
+
+# Without a target spacing, the bins of each ear equal those of PowerSpectrum.
+# The ears are given different signals so that mixing them up would show.
+nEars = 2
+inputBank, frameGen, spectrum = powerSpectrumModules(nEars)
+goertzel = ln.HoppingGoertzelDFT(bands, [windowSize], hopSize, True, True)
+goertzel.setFirstSampleAtWindowCentre(True)
+goertzel.initialize(inputBank)
+
+t = np.arange(100 * hopSize) / float(fs)
+x = np.vstack((np.random.randn(t.size),
+               0.1 * np.sin(2 * np.pi * 1000.3 * t)))
+nFrames = 0
+for block in range(100):
+    for ear in range(nEars):
+        inputBank.setSignal(0, ear, 0,
+                            x[ear, block * hopSize:(block + 1) * hopSize])
+    goertzel.process(inputBank)
+    frameGen.process(inputBank)
+    assert goertzel.getOutput().getTrig() == spectrum.getOutput().getTrig()
+    if goertzel.getOutput().getTrig():
+        goertzelPower = goertzel.getOutput().getSignals()
+        spectrumPower = spectrum.getOutput().getSignals()
+        for ear in range(nEars):
+            assert np.allclose(goertzelPower[0, ear], spectrumPower[0, ear],
+                               rtol=1e-4, atol=0)
+        nFrames += 1
+assert nFrames > 90
+print 'Test comparing the spectra of two ears with PowerSpectrum: successful'
@@ -32,4 +32,37 @@ for i in range(2):
     for ear in range(2):
         out[ear, start:end] = outBank.getSignal(0, ear, 0)
 
-print np.allclose(out, y)
+# The filter runs as a cascade of second order sections, which rounds
+# differently from the direct form used by lfilter.
+print np.abs(out - y).max()
+print np.allclose(out, y, atol=1e-5 * np.abs(y).max())
+
+# High order Butterworth filters have poles clustered about the cutoff
+# frequency. They are factored into sections unless the poles are found with
+# too large an error, in which case the direct form is used. Either way, the
+# output should follow the filter given by the coefficients, computed here in
+# extended precision.
+from scipy.signal import butter
+
+nSamples = 8192
+blockSize = 512
+x = np.random.randn(nSamples)
+filters = [(8, 0.05, True, 1e-6), (10, 0.03, False, 1e-3)]
+for order, cutoff, isSecondOrderSections, tolerance in filters:
+    b, a = butter(order, cutoff)
+    y = lfilter(b.astype(np.longdouble), a.astype(np.longdouble),
+                x.astype(np.longdouble)).astype('float')
+
+    bank = ln.SignalBank()
+    bank.initialize(1, 1, 1, blockSize, 44100)
+    iir = ln.IIR(b, a)
+    iir.initialize(bank)
+    assert iir.isSecondOrderSectionsUsed() == isSecondOrderSections
+
+    out = np.zeros(nSamples)
+    for start in range(0, nSamples, blockSize):
+        bank.setSignal(0, 0, 0, x[start:start + blockSize])
+        iir.process(bank)
+        out[start:start + blockSize] = iir.getOutput().getSignal(0, 0, 0)
+    assert np.allclose(out, y, rtol=0, atol=tolerance * np.abs(y).max())
+print 'Test of high order filters with clustered poles: successful'
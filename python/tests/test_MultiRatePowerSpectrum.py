@@ -0,0 +1,54 @@
+import numpy as np
+import loudness as ln
+
+fs = 32000
+x = np.random.randn(fs * 2) * 0.1
+
+bands = np.array([10, 80, 500, 1250, 2540, 4050, 15001.0])
+windowSizes = [2048, 1024, 512, 256, 128, 64]
+hopSize = 32
+blockSize = 32
+
+bankIn = ln.SignalBank()
+bankIn.initialize(1, 1, 1, blockSize, fs)
+
+# reference: FrameGenerator + Window + PowerSpectrum
+frameGenerator = ln.FrameGenerator(windowSizes[0], hopSize, True)
+window = ln.Window(ln.Window.HANN, windowSizes, True)
+powerSpectrum = ln.PowerSpectrum(bands, windowSizes, True)
+frameGenerator.addTargetModule(window)
+window.addTargetModule(powerSpectrum)
+frameGenerator.initialize(bankIn)
+bankRef = powerSpectrum.getOutput()
+
+multiRate = ln.MultiRatePowerSpectrum(bands, windowSizes, hopSize, True)
+multiRate.setFirstSampleAtWindowCentre(True)
+multiRate.initialize(bankIn)
+bankOut = multiRate.getOutput()
+
+print("Decimation factors: ",
+      [multiRate.getDecimationFactor(i) for i in range(len(windowSizes))])
+print("Latency in samples: ", multiRate.getLatency())
+
+sRef, sOut = [], []
+nBlocks = int(x.size / float(blockSize))
+for block in range(nBlocks):
+    bankIn.setSignal(0, 0, 0, x[block * blockSize:(block + 1) * blockSize])
+    frameGenerator.process(bankIn)
+    multiRate.process(bankIn)
+    if bankRef.getTrig():
+        sRef.append(bankRef.getSignals().flatten())
+    if bankOut.getTrig():
+        sOut.append(bankOut.getSignals().flatten())
+
+# frames are delayed by the latency
+lag = multiRate.getLatency() // hopSize
+sRef = np.array(sRef[100:len(sOut) - lag])
+sOut = np.array(sOut[100 + lag:])
+
+assert np.all(bankRef.getCentreFreqs() == bankOut.getCentreFreqs())
+diffdB = np.abs(10 * np.log10(sOut / sRef))
+print("Max difference (dB): ", diffdB.max())
+print("Max difference in total power (dB): ",
+      np.abs(10 * np.log10(sOut.sum(1) / sRef.sum(1))).max())
+assert diffdB.max() < 0.5
@@ -0,0 +1,66 @@
+import numpy as np
+import loudness as ln
+
+'''
+OctaveBank stores the filter responses at the input frequencies as sparse
+weights, dropping those below the weight tolerance. The output should equal
+the dense weighting of the components above 1e-15 to within the tolerance
+times the total input power.
+'''
+
+fs = 32000
+N = 2048
+freqs = np.arange(N / 2 + 1) * fs / float(N)
+
+
+def octaveBank(psd, freqs, centreFreqs, order, isThirdOctave):
+    b = 1.0 / 3.0 if isThirdOctave else 1.0
+    qRef = 1.0 / (2 ** (b / 2.0) - 2 ** (-b / 2.0))
+    c = np.pi / (2.0 * order)
+    qDes = qRef * c / np.sin(c)
+    isUsed = (psd > 1e-15) & (freqs > 0)
+    f = freqs[isUsed]
+    fm = np.array(centreFreqs).reshape((-1, 1))
+    g = f / fm - fm / f
+    weights = 1.0 / (1 + qDes ** (2.0 * order) * g ** (2.0 * order))
+    return np.dot(weights, psd[isUsed])
+
+
+def filterOutput(psd, order, isThirdOctave, weightTolerance):
+    psdLN = ln.SignalBank()
+    psdLN.initialize(1, 1, psd.size, 1, fs)
+    psdLN.setCentreFreqs(freqs)
+    psdLN.setSignals(psd.reshape((1, 1, psd.size, 1)))
+    bank = ln.OctaveBank(order, 0, isThirdOctave, False)
+    bank.setWeightTolerance(weightTolerance)
+    bank.initialize(psdLN)
+    bank.process(psdLN)
+    centreFreqs = bank.getOutput().getCentreFreqs()
+    return np.copy(bank.getOutput().getSignals().flatten()), centreFreqs
+
+# noise with components either side of 1e-15, and a tone on quiet noise
+spectra = []
+for level in [-150, 0, 60]:
+    spectra.append(10 ** ((10 * np.random.randn(freqs.size) + level) / 10.0))
+tone = 10 ** ((10 * np.random.randn(freqs.size) - 160) / 10.0)
+tone[64] = 1.0
+spectra.append(tone)
+
+for order in [3, 6]:
+    for isThirdOctave in [True, False]:
+        for psd in spectra:
+            for weightTolerance in [0, 1e-12, 1e-4]:
+                output, centreFreqs = filterOutput(psd, order, isThirdOctave,
+                                                   weightTolerance)
+                expected = octaveBank(psd, freqs, centreFreqs, order,
+                                      isThirdOctave)
+                atol = weightTolerance * np.sum(psd[psd > 1e-15])
+                assert np.allclose(output, expected, rtol=1e-12, atol=atol)
+print 'Test of sparse weights against dense weighting: successful'
+
+# Components at or below 1e-15 are ignored
+for psd, isZero in [(np.ones(freqs.size) * 1e-15, True),
+                    (np.ones(freqs.size) * 1.1e-15, False)]:
+    output, centreFreqs = filterOutput(psd, 3, True, 0)
+    assert np.all(output == 0) == isZero
+print 'Test of negligible components: successful'
@@ -73,3 +73,60 @@ if np.allclose(spectrumLoudness[0, :, :, 0], spectrumNumpy):
     print "Numpy vs loudness power spectrum test: successful"
 else:
     print "Numpy vs loudness power spectrum test: unsuccessful"
+
+# Windowing applied by PowerSpectrum vs Window + PowerSpectrum
+frame = np.random.randn(nSources, nEars, 1, frameSizes[0])
+frameBuf = ln.SignalBank()
+frameBuf.initialize(nSources, nEars, 1, frameSizes[0], fs)
+frameBuf.setSignals(frame)
+
+window = ln.Window(ln.Window.HANN, frameSizes, True)
+spectrumModule = ln.PowerSpectrum(bandFreqs, frameSizes, uniform)
+window.addTargetModule(spectrumModule)
+window.initialize(frameBuf)
+window.process(frameBuf)
+
+fusedModule = ln.PowerSpectrum(bandFreqs, frameSizes, uniform)
+fusedModule.setWindow(ln.Window.HANN, True)
+fusedModule.initialize(frameBuf)
+fusedModule.process(frameBuf)
+
+if np.array_equal(spectrumModule.getOutput().getSignals(),
+                  fusedModule.getOutput().getSignals()):
+    print "Window + PowerSpectrum vs windowed PowerSpectrum test: successful"
+else:
+    print "Window + PowerSpectrum vs windowed PowerSpectrum test: unsuccessful"
+
+# All sources and ears are transformed in one batch. Each of them should get
+# the spectrum computed on its own.
+nSources = 3
+frames = np.random.randn(nSources, nEars, nBands, frameSizes[0])
+for band in range(1, nBands):
+    frames[:, :, band, frameSizes[band]:] = 0
+for uniform in [True, False]:
+    for isWindowed in [False, True]:
+        batchBuf = ln.SignalBank()
+        batchBuf.initialize(nSources, nEars, nBands, frameSizes[0], fs)
+        batchBuf.setSignals(frames)
+        batched = ln.PowerSpectrum(bandFreqs, frameSizes, uniform)
+        if isWindowed:
+            batched.setWindow(ln.Window.HANN, True)
+        batched.initialize(batchBuf)
+        batched.process(batchBuf)
+        batchedSpectra = batched.getOutput().getSignals()
+
+        singleBuf = ln.SignalBank()
+        singleBuf.initialize(1, 1, nBands, frameSizes[0], fs)
+        single = ln.PowerSpectrum(bandFreqs, frameSizes, uniform)
+        if isWindowed:
+            single.setWindow(ln.Window.HANN, True)
+        single.initialize(singleBuf)
+        for src in range(nSources):
+            for ear in range(nEars):
+                singleBuf.setSignals(
+                    frames[src, ear].reshape((1, 1, nBands, frameSizes[0])))
+                single.process(singleBuf)
+                spectrum = single.getOutput().getSignals()[0, 0]
+                assert np.allclose(batchedSpectra[src, ear], spectrum,
+                                   rtol=1e-12, atol=1e-12 * np.max(spectrum))
+print 'Batched vs single transform power spectrum test: successful'
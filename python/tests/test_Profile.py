@@ -0,0 +1,30 @@
+import numpy as np
+import loudness as ln
+
+fs = 32000
+hopSize = 32
+numFrames = 500
+
+# Profile every module call, logging up to 20000 calls for the timeline
+model = ln.DynamicLoudnessGM2002()
+model.configureModelParameters("FasterAndRecent")
+model.setProfilingEnabled(True, 20000)
+
+sig = ln.SignalBank()
+sig.initialize(1, 1, 1, hopSize, fs)
+model.initialize(sig)
+
+x = 0.01 * np.random.randn(numFrames * hopSize)
+for i in range(numFrames):
+    sig.setSignals(x[i * hopSize:(i + 1) * hopSize].reshape((1, 1, 1, -1)))
+    model.process(sig)
+
+profile = model.getProfile()
+print profile.getSummary()
+
+print("Frames counted: %r" % (profile.getNFrames() == numFrames))
+for i in range(profile.getNModules()):
+    print("%s called: %r" % (profile.getModuleName(i),
+                             profile.getNCalls(i) > 0))
+
+profile.exportChromeTrace("profile.json")
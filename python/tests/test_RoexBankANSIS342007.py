@@ -1,5 +1,6 @@
 import numpy as np
 import matplotlib.pyplot as plt
+import loudness as ln
 
 class RoexBankANSIS342007():
 
@@ -92,7 +93,49 @@ class RoexBankANSIS342007():
         plt.ylim(0,100)
         plt.show()
 
+
+def excitationPatternLN(psd, freqs, weightTolerance, isFastMathEnabled):
+    psdLN = ln.SignalBank()
+    psdLN.initialize(1, 1, psd.size, 1, 32000)
+    psdLN.setCentreFreqs(freqs)
+    psdLN.setSignals(psd.reshape((1, 1, psd.size, 1)))
+    wasFastMathEnabled = ln.isFastMathEnabled()
+    ln.setFastMathEnabled(isFastMathEnabled)
+    bank = ln.RoexBankANSIS342007(1.8, 38.9, 0.1)
+    bank.setWeightTolerance(weightTolerance)
+    bank.initialize(psdLN)
+    bank.process(psdLN)
+    ln.setFastMathEnabled(wasFastMathEnabled)
+    return np.copy(bank.getOutput().getSignals().flatten())
+
 if __name__ == '__main__':
+    '''
+    Dropping the filter weights below the tolerance changes the excitation by
+    at most the tolerance times the total input power. fastExp() changes the
+    excitation by less than 1e-15 of its value.
+    '''
+    f = np.arange(50, 16000, 15.625)
+    spectra = []
+    for level in [30, 60, 90]:
+        spectra.append(10 ** ((10 * np.random.randn(f.size) + level) / 10.0))
+    tone = np.ones(f.size) * 1e-3
+    tone[60] = 1e10
+    spectra.append(tone)
+
+    weightTolerance = 1e-12
+    roex = RoexBankANSIS342007(1.8, 38.9, 0.1)
+    roex.initialize(f)
+    for psd in spectra:
+        roex.process(psd)
+        expected = roex.excitation.flatten()
+        excitation = excitationPatternLN(psd, f, weightTolerance, True)
+        assert np.allclose(excitation, expected, rtol=1e-12,
+                           atol=weightTolerance * np.sum(psd))
+        fast = excitationPatternLN(psd, f, 0, True)
+        exact = excitationPatternLN(psd, f, 0, False)
+        assert np.allclose(fast, exact, rtol=1e-15, atol=0)
+    print 'Test of sparse weights and fastExp against all weights: successful'
+
     freq = 1000.0
     f = np.arange(500, 2000.0, 10)
     psd = np.zeros(f.size)
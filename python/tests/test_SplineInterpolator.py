@@ -0,0 +1,56 @@
+import numpy as np
+import loudness as ln
+
+'''
+Roex banks interpolate their excitation patterns to 0.1 Cam resolution with a
+precomputed interpolation operator. The result should equal the spline
+through the excitation levels of the filters, evaluated point by point.
+'''
+
+fs = 32000
+N = 2048
+halfPoints = N / 2 + 1
+inputFreqs = np.arange(halfPoints) * fs / float(N)
+
+psd = 10 ** ((20 * np.random.randn(halfPoints) + 70) / 10.0)
+psd /= halfPoints
+psdLN = ln.SignalBank()
+psdLN.initialize(1, 1, halfPoints, 1, fs)
+psdLN.setCentreFreqs(inputFreqs)
+psdLN.setSignals(psd.reshape((1, 1, halfPoints, 1)))
+
+
+def excitationPattern(bank):
+    bank.initialize(psdLN)
+    bank.process(psdLN)
+    return np.copy(bank.getOutput().getSignals().flatten())
+
+
+def splineInterpolate(cams, excitation, camsInterp, isCubic):
+    s = ln.spline()
+    s.set_points(list(cams), list(np.log(excitation + 1e-10)), isCubic)
+    return np.exp([s(cam) for cam in camsInterp])
+
+camStep = 0.5
+for isCubic in [True, False]:
+    banks = [
+        (ln.DoubleRoexBank(1.5, 40.2, camStep),
+         ln.DoubleRoexBank(1.5, 40.2, camStep, 1.0, True, isCubic),
+         1.5, 388),
+        (ln.MultiSourceDoubleRoexBank(1.5, 40.2, camStep),
+         ln.MultiSourceDoubleRoexBank(1.5, 40.2, camStep, 1.0, True, isCubic),
+         1.5, 388),
+        (ln.FastRoexBank(camStep),
+         ln.FastRoexBank(camStep, True, isCubic),
+         1.8, 372)
+    ]
+    for bank, interpolatingBank, camLo, nInterp in banks:
+        excitation = excitationPattern(bank)
+        cams = camLo + np.arange(excitation.size) * camStep
+        camsInterp = camLo + np.arange(nInterp) * 0.1
+        expected = splineInterpolate(cams, excitation, camsInterp, isCubic)
+        interpolated = excitationPattern(interpolatingBank)
+        assert interpolated.size == nInterp
+        assert np.allclose(interpolated, expected, rtol=1e-9, atol=0)
+
+print 'Test comparing interpolation operator and spline: successful'
@@ -17,7 +17,6 @@
  * along with Loudness.  If not, see <http://www.gnu.org/licenses/>. 
  */
 
-#include "../thirdParty/cnpy/cnpy.h"
 #include "../support/AuditoryTools.h"
 #include "../modules/FrameGenerator.h"
 #include "../modules/FIR.h"
@@ -25,6 +24,7 @@
 #include "../modules/Window.h"
 #include "../modules/PowerSpectrum.h"
 #include "../modules/HoppingGoertzelDFT.h"
+#include "../modules/MultiRatePowerSpectrum.h"
 #include "../modules/CompressSpectrum.h"
 #include "../modules/WeightSpectrum.h"
 #include "../modules/DoubleRoexBank.h"
@@ -55,6 +55,11 @@ namespace loudness{
     {
     }
 
+    unique_ptr<Model> DynamicLoudnessCH2012::clone() const
+    {
+        return unique_ptr<Model> (new DynamicLoudnessCH2012(*this));
+    }
+
     void DynamicLoudnessCH2012::setFirstSampleAtWindowCentre(bool isFirstSampleAtWindowCentre)
     {
         isFirstSampleAtWindowCentre_ = isFirstSampleAtWindowCentre;
@@ -90,6 +95,11 @@ namespace loudness{
         isHoppingGoertzelDFTUsed_ = isHoppingGoertzelDFTUsed;
     }
 
+    void DynamicLoudnessCH2012::setMultiRateSpectrumUsed (bool isMultiRateSpectrumUsed)
+    {
+        isMultiRateSpectrumUsed_ = isMultiRateSpectrumUsed;
+    }
+
     void DynamicLoudnessCH2012::setExcitationPatternInterpolated(bool isExcitationPatternInterpolated)
     {
         isExcitationPatternInterpolated_ = isExcitationPatternInterpolated;
@@ -153,6 +163,7 @@ namespace loudness{
         setMiddleEarFilter (OME::CHGM2011_MIDDLE_EAR);
         setSpectrumSampledUniformly (true);
         setHoppingGoertzelDFTUsed (false);
+        setMultiRateSpectrumUsed (false);
         setExcitationPatternInterpolated (false);
         setInterpolationCubic (true);
         setPartialLoudnessUsed (false);
@@ -189,24 +200,12 @@ namespace loudness{
         //use spectral weighting to approximate outer and middle ear response
         if(!pathToFilterCoefs_.empty())
         {
-            //load numpy array holding the filter coefficients
-            cnpy::NpyArray arr = cnpy::npy_load(pathToFilterCoefs_);
-            Real *data = reinterpret_cast<Real*> (arr.data);
-
-            //check if filter is IIR or FIR
-            bool iir = false;
-            if(arr.shape[0]==2)
-                iir = true;
-
             //load the coefficients
             RealVec bCoefs, aCoefs;
-            for(unsigned int i=0; i<arr.shape[1];i++)
-            {
-                bCoefs.push_back(data[i]);
-                if(iir)
-                    aCoefs.push_back(data[i+arr.shape[1]]);
-            }
-            
+            if (!Filter::readCoefsFromNumpyArray(pathToFilterCoefs_, bCoefs, aCoefs))
+                return 0;
+            bool iir = !aCoefs.empty();
+
             //create module
             if(iir)
             {
@@ -218,9 +217,6 @@ namespace loudness{
                 modules_.push_back(unique_ptr<Module>
                         (new FIR(bCoefs))); 
             }
-
-            //clean up
-            delete [] data;
         }
 
         /*
@@ -249,13 +245,22 @@ namespace loudness{
         //power spectrum
         if (isHoppingGoertzelDFTUsed_)
         {
-            compressionCriterionInCams_ = 0;
-            modules_.push_back(unique_ptr<Module> 
-                    (new HoppingGoertzelDFT(bandFreqsHz,
-                                            windowSizeSamples,
-                                            hopSize,
-                                            true,
-                                            true)));
+            //multi-resolution bins are not compressed
+            HoppingGoertzelDFT* goertzel = new HoppingGoertzelDFT(bandFreqsHz,
+                                                                  windowSizeSamples,
+                                                                  hopSize,
+                                                                  true,
+                                                                  true);
+            modules_.push_back(unique_ptr<Module> (goertzel));
+        }
+        else if (isMultiRateSpectrumUsed_)
+        {
+            MultiRatePowerSpectrum* spectrum = new MultiRatePowerSpectrum(bandFreqsHz,
+                                                                          windowSizeSamples,
+                                                                          hopSize,
+                                                                          isSpectrumSampledUniformly_);
+            spectrum -> setFirstSampleAtWindowCentre(isFirstSampleAtWindowCentre_);
+            modules_.push_back(unique_ptr<Module> (spectrum));
         }
         else
         {
@@ -264,20 +269,19 @@ namespace loudness{
                                         hopSize,
                                         isFirstSampleAtWindowCentre_)));
 
-            //windowing: Periodic hann window
-            modules_.push_back(unique_ptr<Module>
-                    (new Window(Window::HANN, windowSizeSamples, true)));
-
-            modules_.push_back(unique_ptr<Module> 
-                    (new PowerSpectrum(bandFreqsHz,
-                                       windowSizeSamples,
-                                       isSpectrumSampledUniformly_)));
+            //windowing: Periodic hann window, applied by PowerSpectrum
+            PowerSpectrum* spectrum = new PowerSpectrum(bandFreqsHz,
+                                                        windowSizeSamples,
+                                                        isSpectrumSampledUniformly_);
+            spectrum -> setWindow(Window::HANN, true);
+            modules_.push_back(unique_ptr<Module> (spectrum));
         }
 
         /*
          * Compression
          */
-        if((compressionCriterionInCams_ > 0) && (isSpectrumSampledUniformly_))
+        if((compressionCriterionInCams_ > 0) && (isSpectrumSampledUniformly_)
+           && (!isHoppingGoertzelDFTUsed_))
         {
             modules_.push_back(unique_ptr<Module>
                     (new CompressSpectrum(compressionCriterionInCams_))); 
@@ -121,6 +121,17 @@ namespace loudness{
 
             void setHoppingGoertzelDFTUsed (bool isHoppingGoertzelDFTUsed);
 
+            /**
+             * @brief Computes the power spectrum from low-pass filtered and
+             * decimated signals (see MultiRatePowerSpectrum) rather than
+             * with FrameGenerator, Window and PowerSpectrum.
+             *
+             * The output frames are delayed by the latency of the
+             * decimation filters (a few frames). Ignored if the hopping
+             * Goertzel DFT is used.
+             */
+            void setMultiRateSpectrumUsed (bool isMultiRateSpectrumUsed);
+
             void setExcitationPatternInterpolated(bool isExcitationPatternInterpolated);
 
             void setInterpolationCubic(bool isInterpolationCubic);
@@ -154,6 +165,7 @@ namespace loudness{
 
         private:
             virtual bool initializeInternal(const SignalBank &input);
+            virtual unique_ptr<Model> clone() const;
 
             string pathToFilterCoefs_;
             Real filterSpacingInCams_, compressionCriterionInCams_;
@@ -161,6 +173,7 @@ namespace loudness{
             Real attackTimeLTL_, releaseTimeLTL_;
             Real scalingFactor_;
             bool isSpectrumSampledUniformly_, isHoppingGoertzelDFTUsed_;
+            bool isMultiRateSpectrumUsed_;
             bool isExcitationPatternInterpolated_;
             bool isInterpolationCubic_, isPresentationDiotic_;
             bool isSpecificLoudnessOutput_, isBinauralInhibitionUsed_;
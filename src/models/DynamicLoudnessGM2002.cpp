@@ -17,7 +17,6 @@
  * along with Loudness.  If not, see <http://www.gnu.org/licenses/>. 
  */
 
-#include "../thirdParty/cnpy/cnpy.h"
 #include "../support/AuditoryTools.h"
 #include "../modules/FrameGenerator.h"
 #include "../modules/Butter.h"
@@ -26,6 +25,7 @@
 #include "../modules/Window.h"
 #include "../modules/PowerSpectrum.h"
 #include "../modules/HoppingGoertzelDFT.h"
+#include "../modules/MultiRatePowerSpectrum.h"
 #include "../modules/CompressSpectrum.h"
 #include "../modules/WeightSpectrum.h"
 #include "../modules/FastRoexBank.h"
@@ -58,6 +58,11 @@ namespace loudness{
     {
     }
 
+    unique_ptr<Model> DynamicLoudnessGM2002::clone() const
+    {
+        return unique_ptr<Model> (new DynamicLoudnessGM2002(*this));
+    }
+
     void DynamicLoudnessGM2002::setPartialLoudnessUsed(bool isPartialLoudnessUsed)
     {
         isPartialLoudnessUsed_ = isPartialLoudnessUsed;
@@ -118,6 +123,11 @@ namespace loudness{
         isHoppingGoertzelDFTUsed_ = isHoppingGoertzelDFTUsed;
     }
 
+    void DynamicLoudnessGM2002::setMultiRateSpectrumUsed (bool isMultiRateSpectrumUsed)
+    {
+        isMultiRateSpectrumUsed_ = isMultiRateSpectrumUsed;
+    }
+
     void DynamicLoudnessGM2002::setSpectralResolutionDoubled(bool isSpectralResolutionDoubled)
     {
         isSpectralResolutionDoubled_ = isSpectralResolutionDoubled;
@@ -189,6 +199,7 @@ namespace loudness{
         setMiddleEarFilter(OME::ANSIS342007_MIDDLE_EAR_HPF);
         setSpectrumSampledUniformly(true);
         setHoppingGoertzelDFTUsed(false);
+        setMultiRateSpectrumUsed(false);
         setSpectralResolutionDoubled(false);
         setExcitationPatternInterpolated(false);
         setInterpolationCubic(true);
@@ -274,32 +285,17 @@ namespace loudness{
         else
         { //otherwise, load them
 
-            //load numpy array holding the filter coefficients
-            cnpy::NpyArray arr = cnpy::npy_load(pathToFilterCoefs_);
-            Real *data = reinterpret_cast<Real*> (arr.data);
-
-            //check if filter is IIR or FIR
-            bool iir = false;
-            if(arr.shape[0]==2)
-                iir = true;
-
             //load the coefficients
             RealVec bCoefs, aCoefs;
-            for(unsigned int i=0; i<arr.shape[1];i++)
-            {
-                bCoefs.push_back(data[i]);
-                if(iir)
-                    aCoefs.push_back(data[i+arr.shape[1]]);
-            }
-            
+            if (!Filter::readCoefsFromNumpyArray(pathToFilterCoefs_, bCoefs, aCoefs))
+                return 0;
+            bool iir = !aCoefs.empty();
+
             //create module
             if(iir)
                 modules_.push_back(unique_ptr<Module> (new IIR(bCoefs, aCoefs)));
             else
                 modules_.push_back(unique_ptr<Module> (new FIR(bCoefs)));
-
-            //clean up
-            delete [] data;
         }
 
         /*
@@ -329,15 +325,24 @@ namespace loudness{
         //power spectrum
         if (isHoppingGoertzelDFTUsed_)
         {
-            compressionCriterionInCams_ = 0;
-            modules_.push_back(unique_ptr<Module> 
-                    (new HoppingGoertzelDFT(bandFreqsHz,
-                                            windowSizeSamples,
-                                            hopSize,
-                                            true,
-                                            true)));
+            //multi-resolution bins are not compressed
+            HoppingGoertzelDFT* goertzel = new HoppingGoertzelDFT(bandFreqsHz,
+                                                                  windowSizeSamples,
+                                                                  hopSize,
+                                                                  true,
+                                                                  true);
+            modules_.push_back(unique_ptr<Module> (goertzel));
             //outputModules_["PowerSpectrum"] = modules_.back().get();
         }
+        else if (isMultiRateSpectrumUsed_)
+        {
+            MultiRatePowerSpectrum* spectrum = new MultiRatePowerSpectrum(bandFreqsHz,
+                                                                          windowSizeSamples,
+                                                                          hopSize,
+                                                                          isSpectrumSampledUniformly_);
+            spectrum -> setFirstSampleAtWindowCentre(isFirstSampleAtWindowCentre_);
+            modules_.push_back(unique_ptr<Module> (spectrum));
+        }
         else
         {
             modules_.push_back(unique_ptr<Module> 
@@ -345,20 +350,19 @@ namespace loudness{
                                         hopSize,
                                         isFirstSampleAtWindowCentre_)));
 
-            //windowing: Periodic hann window
-            modules_.push_back(unique_ptr<Module>
-                    (new Window(Window::HANN, windowSizeSamples, true)));
-
-            modules_.push_back(unique_ptr<Module> 
-                    (new PowerSpectrum(bandFreqsHz,
-                                       windowSizeSamples,
-                                       isSpectrumSampledUniformly_)));
+            //windowing: Periodic hann window, applied by PowerSpectrum
+            PowerSpectrum* spectrum = new PowerSpectrum(bandFreqsHz,
+                                                        windowSizeSamples,
+                                                        isSpectrumSampledUniformly_);
+            spectrum -> setWindow(Window::HANN, true);
+            modules_.push_back(unique_ptr<Module> (spectrum));
         }
 
         /*
          * Compression
          */
-        if((compressionCriterionInCams_ > 0) && (isSpectrumSampledUniformly_))
+        if((compressionCriterionInCams_ > 0) && (isSpectrumSampledUniformly_)
+           && (!isHoppingGoertzelDFTUsed_))
         {
             modules_.push_back(unique_ptr<Module>
                     (new CompressSpectrum(compressionCriterionInCams_)));
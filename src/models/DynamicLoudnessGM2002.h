@@ -155,6 +155,17 @@ namespace loudness{
 
             void setHoppingGoertzelDFTUsed (bool isHoppingGoertzelDFTUsed);
 
+            /**
+             * @brief Computes the power spectrum from low-pass filtered and
+             * decimated signals (see MultiRatePowerSpectrum) rather than
+             * with FrameGenerator, Window and PowerSpectrum.
+             *
+             * The output frames are delayed by the latency of the
+             * decimation filters (a few frames). Ignored if the hopping
+             * Goertzel DFT is used.
+             */
+            void setMultiRateSpectrumUsed (bool isMultiRateSpectrumUsed);
+
             void setSpectralResolutionDoubled(bool isSpectralResolutionDoubled);
 
             void setPresentationDiotic(bool isPresentationDiotic);
@@ -189,6 +200,7 @@ namespace loudness{
 
         private:
             virtual bool initializeInternal(const SignalBank &input);
+            virtual unique_ptr<Model> clone() const;
 
             Real filterSpacingInCams_, compressionCriterionInCams_;
             Real attackTimeSTL_, releaseTimeSTL_;
@@ -196,6 +208,7 @@ namespace loudness{
             Real isPresentationDiotic_;
             bool isRoexBankFast_, isExcitationPatternInterpolated_, isInterpolationCubic_;
             bool isSpectrumSampledUniformly_, isHoppingGoertzelDFTUsed_;
+            bool isMultiRateSpectrumUsed_;
             bool isSpectralResolutionDoubled_, isBinauralInhibitionUsed_;
             bool isSpecificLoudnessANSIS342007_, isFirstSampleAtWindowCentre_;
             bool isPartialLoudnessUsed_;
@@ -58,6 +58,32 @@ namespace loudness{
 
     void ARAverager::processInternal(const SignalBank &input)
     {       
+        processFrames(&input, &output_, 1);
+    }
+
+    void ARAverager::processBlockInternal(const SignalBank* inputs,
+                                          int nInputs)
+    {
+        if (!isBlockTriggered(inputs, nInputs))
+        {
+            Module::processBlockInternal(inputs, nInputs);
+            return;
+        }
+
+        processFrames(inputs, outputBlock_.data(), nInputs);
+        for (int i = 0; i < nInputs; ++i)
+            outputBlock_[i].setTrig(true);
+
+        //the filter state
+        output_.copySamples(outputBlock_[nInputs - 1]);
+        output_.setTrig(true);
+    }
+
+    void ARAverager::processFrames(const SignalBank* inputs,
+                                   SignalBank* outputs,
+                                   int nFrames)
+    {
+        const SignalBank& input = inputs[0];
         int lastSampleIdx = input.getNSamples() - 1;
 
         for (int src = 0; src < input.getNSources(); src++)
@@ -66,19 +92,25 @@ namespace loudness{
             {
                 for (int chn = 0; chn < input.getNChannels(); ++chn)
                 {
-                    const Real* x = input.getSignalReadPointer(src,
-                            ear, chn, 0);
-                    Real* y = output_.getSignalWritePointer(src,
-                            ear, chn, 0);
-                    Real yPrev = y[lastSampleIdx];
+                    //previous output is held by output_
+                    Real yPrev = output_.getSignalReadPointer(src,
+                            ear, chn, 0)[lastSampleIdx];
 
-                    for (int smp = 0; smp < input.getNSamples(); ++smp)
+                    for (int frame = 0; frame < nFrames; ++frame)
                     {
-                        if (x[smp] > yPrev)
-                            y[smp] = attackCoef_ * (x[smp] - yPrev) + yPrev;
-                        else
-                            y[smp] = releaseCoef_ * (x[smp] - yPrev) + yPrev;
-                        yPrev = y[smp];
+                        const Real* x = inputs[frame].getSignalReadPointer(src,
+                                ear, chn, 0);
+                        Real* y = outputs[frame].getSignalWritePointer(src,
+                                ear, chn, 0);
+
+                        for (int smp = 0; smp < input.getNSamples(); ++smp)
+                        {
+                            if (x[smp] > yPrev)
+                                y[smp] = attackCoef_ * (x[smp] - yPrev) + yPrev;
+                            else
+                                y[smp] = releaseCoef_ * (x[smp] - yPrev) + yPrev;
+                            yPrev = y[smp];
+                        }
                     }
                 }
             }
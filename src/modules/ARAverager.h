@@ -60,6 +60,10 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual void processBlockInternal(const SignalBank* inputs, int nInputs);
+
+        void processFrames(const SignalBank* inputs, SignalBank* outputs,
+                int nFrames);
 
         Real attackTime_, releaseTime_;
         Real attackCoef_, releaseCoef_;
@@ -30,11 +30,17 @@ namespace loudness{
         frameSizeInSeconds_(0),
         duration_(0),
         gainInDecibels_(0),
-        sndFile_(nullptr)
+        sndFile_(nullptr),
+        isMemoryMappingUsed_(true),
+        framePosition_(0),
+        isReadAheadUsed_(false),
+        currentBuffer_(0),
+        isDecodingStopped_(true)
     {}
     
     AudioFileCutter::~AudioFileCutter()
     {
+        stopDecoding();
         if(sndFile_)
         {
             if(sf_close(sndFile_)>0)
@@ -44,6 +50,8 @@ namespace loudness{
 
     bool AudioFileCutter::initializeInternal()
     {
+        stopDecoding();
+
         // If the file is already opened, first close it
         if (sf_close(sndFile_) > 0)
         {
@@ -80,6 +88,26 @@ namespace loudness{
         nFrames_ = ceil(fileInfo.frames / (float)frameSize_);
         duration_ = fileInfo.frames/(Real)fileInfo.samplerate;
         fs_ = fileInfo.samplerate;
+
+        LOUDNESS_DEBUG(name_ << ": gain (dB): " << gainInDecibels_);
+        linearGain_ = decibelsToAmplitude(gainInDecibels_);
+
+        output_.initialize(1, fileInfo.channels, 1,
+                frameSize_, fileInfo.samplerate);
+
+        //read uncompressed files in place if they agree with libsndfile
+        mappedFile_.close();
+        framePosition_ = 0;
+        if (isMemoryMappingUsed_ && mappedFile_.open(fileName_))
+        {
+            if ((mappedFile_.getNChannels() == fileInfo.channels) &&
+                (mappedFile_.getNFrames() == fileInfo.frames))
+            {
+                LOUDNESS_DEBUG(name_ << ": Audio file is memory mapped.");
+                return 1;
+            }
+            mappedFile_.close();
+        }
  
         //force audio buffer size to be a multiple of frameSize_
         long long totalAudioSamples = fileInfo.frames * fileInfo.channels;
@@ -105,64 +133,154 @@ namespace loudness{
                 << "\n Audio buffer size: " << audioBufferSize_);
 
         bufferIdx_ =  audioBufferSize_;
-        audioBuffer_.assign(audioBufferSize_, 0.0);
+        currentBuffer_ = 0;
+        if (isReadAheadUsed_)
+        {
+            audioBuffer_.assign(2 * audioBufferSize_, 0.0);
+            filledBuffers_.initialize(2);
+            freeBuffers_.initialize(2);
+            startDecoding();
+            LOUDNESS_DEBUG(name_ << ": Decoding on a background thread.");
+        }
+        else
+        {
+            audioBuffer_.assign(audioBufferSize_, 0.0);
+        }
 
-        LOUDNESS_DEBUG(name_ << ": gain (dB): " << gainInDecibels_);
-        linearGain_ = decibelsToAmplitude(gainInDecibels_);
+        return 1;
+    }
 
-        output_.initialize(1, fileInfo.channels, 1,
-                frameSize_, fileInfo.samplerate);
+    void AudioFileCutter::decodeBuffer(float* buffer)
+    {
+        int readCount = sf_readf_float(sndFile_, buffer, nSamplesToLoadPerChannel_);
 
-        return 1;
+        LOUDNESS_PROCESS_DEBUG(name_ 
+                << ": Number of samples extracted per audio channel: "
+                << readCount);
+
+        //Zero pad when towards the end
+        int remainingSamplesPerChannel = nSamplesToLoadPerChannel_ - readCount;
+        if (remainingSamplesPerChannel > 0)
+        {
+            std::fill(buffer + readCount * output_.getNEars(),
+                      buffer + audioBufferSize_, 0.0f);
+
+            LOUDNESS_PROCESS_DEBUG(name_ << ": Padding " 
+                    << remainingSamplesPerChannel
+                    << " sample with zeros per audio channel");
+        }
+    }
+
+    void AudioFileCutter::decode()
+    {
+        int buffer;
+        while (!isDecodingStopped_)
+        {
+            //sleep until a buffer has been handed back
+            while (!freeBuffers_.pop(buffer))
+            {
+                std::unique_lock<std::mutex> lock(decodeMutex_);
+                decodeCondition_.wait(lock, [this]{
+                        return isDecodingStopped_ || !freeBuffers_.isEmpty();});
+                if (isDecodingStopped_)
+                    return;
+            }
+
+            decodeBuffer(&audioBuffer_[buffer * audioBufferSize_]);
+            filledBuffers_.push(buffer);
+            notifyDecoding();
+        }
+    }
+
+    void AudioFileCutter::notifyDecoding()
+    {
+        //taking the lock orders this with the waiting thread's check
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex_);
+        }
+        decodeCondition_.notify_all();
+    }
+
+    void AudioFileCutter::startDecoding()
+    {
+        filledBuffers_.clear();
+        freeBuffers_.clear();
+        freeBuffers_.push(0);
+        freeBuffers_.push(1);
+        currentBuffer_ = -1;
+        isDecodingStopped_ = false;
+        decodeThread_ = std::thread(&AudioFileCutter::decode, this);
+    }
+
+    void AudioFileCutter::stopDecoding()
+    {
+        if (decodeThread_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(decodeMutex_);
+                isDecodingStopped_ = true;
+            }
+            decodeCondition_.notify_all();
+            decodeThread_.join();
+        }
     }
 
     void AudioFileCutter::processInternal()
     {
+        //uncompressed files are converted straight into the output
+        if (mappedFile_.isOpen())
+        {
+            int nSamples = output_.getNSamples();
+            for (int ear = 0; ear < output_.getNEars(); ++ear)
+            {
+                mappedFile_.read(framePosition_, ear, nSamples, linearGain_,
+                                 output_.getSignalWritePointer(0, ear, 0, 0));
+            }
+            framePosition_ += nSamples;
+        }
         //if we have an audio file
-        if (sndFile_)
+        else if (sndFile_)
         {
             //If we have extracted all data from buffer, get more
             if (bufferIdx_ == audioBufferSize_)
             {
-                int readCount = sf_readf_float(sndFile_, &audioBuffer_[0], nSamplesToLoadPerChannel_);
-
-                LOUDNESS_PROCESS_DEBUG(name_ 
-                        << ": Number of samples extracted per audio channel: "
-                        << readCount);
-
-                //Zero pad when towards the end
-                int remainingSamplesPerChannel = nSamplesToLoadPerChannel_ - readCount;
-                if (remainingSamplesPerChannel > 0)
+                if (decodeThread_.joinable())
                 {
-                    fill(audioBuffer_.begin() + readCount * output_.getNEars(), audioBuffer_.end(),0.0);
-
-                    LOUDNESS_PROCESS_DEBUG(name_ << ": Padding " 
-                            << remainingSamplesPerChannel
-                            << " sample with zeros per audio channel");
+                    //hand the used buffer back and take the next one
+                    if (currentBuffer_ >= 0)
+                    {
+                        freeBuffers_.push(currentBuffer_);
+                        notifyDecoding();
+                    }
+                    while (!filledBuffers_.pop(currentBuffer_))
+                    {
+                        std::unique_lock<std::mutex> lock(decodeMutex_);
+                        decodeCondition_.wait(lock, [this]{
+                                return !filledBuffers_.isEmpty();});
+                    }
+                }
+                else
+                {
+                    decodeBuffer(&audioBuffer_[0]);
                 }
 
                 bufferIdx_ = 0;
             }  
 
-            //clear the output signal bank
-            output_.zeroSignals();
-
-            //Fill the output signal bank
+            //Fill the output signal bank, applying the gain
             int nEars = output_.getNEars();
             for (int ear = 0; ear < nEars; ear ++)
             {
-                float* inputSignal = &audioBuffer_[bufferIdx_ + ear];
+                float* inputSignal = &audioBuffer_[currentBuffer_ * audioBufferSize_
+                                                   + bufferIdx_ + ear];
                 Real* outputSignal = output_.getSignalWritePointer(0, ear, 0, 0);
                 int smp = output_.getNSamples();
                 while(smp-- > 0)
                 {
-                    *outputSignal++ = *inputSignal;
+                    *outputSignal++ = linearGain_ * *inputSignal;
                     inputSignal += nEars;
                 }
             }
-
-            //apply gain
-            output_.scale(linearGain_);
             
             //update buffer index
             bufferIdx_ += output_.getNSamples() * nEars;
@@ -174,6 +292,26 @@ namespace loudness{
         gainInDecibels_ = gainInDecibels;
     }
 
+    void AudioFileCutter::setMemoryMappingUsed(bool isMemoryMappingUsed)
+    {
+        isMemoryMappingUsed_ = isMemoryMappingUsed;
+    }
+
+    bool AudioFileCutter::isMemoryMapped() const
+    {
+        return mappedFile_.isOpen();
+    }
+
+    void AudioFileCutter::setReadAheadUsed(bool isReadAheadUsed)
+    {
+        isReadAheadUsed_ = isReadAheadUsed;
+    }
+
+    bool AudioFileCutter::isReadAhead() const
+    {
+        return decodeThread_.joinable();
+    }
+
     void AudioFileCutter::setFrameSize(int frameSize)
     {
         frameSize_ = frameSize;
@@ -189,16 +327,30 @@ namespace loudness{
         fileName_ = fileName;
     }
 
-    void AudioFileCutter::resetInternal()
+    void AudioFileCutter::seek(int frame)
     {
-        if(sndFile_)
+        framePosition_ = (long long)max(frame, 0) * frameSize_;
+        if(sndFile_ && !mappedFile_.isOpen())
         {
+            //the decode thread is restarted from the new position
+            bool isReadAhead = decodeThread_.joinable();
+            stopDecoding();
+
             audioBuffer_.assign(audioBuffer_.size(), 0.0);
             bufferIdx_ =  audioBufferSize_;
-            sf_seek(sndFile_, 0, SEEK_SET);
+            sf_count_t end = sf_seek(sndFile_, 0, SEEK_END);
+            sf_seek(sndFile_, min((sf_count_t)framePosition_, end), SEEK_SET);
+
+            if (isReadAhead)
+                startDecoding();
         }
     }
 
+    void AudioFileCutter::resetInternal()
+    {
+        seek(0);
+    }
+
     int AudioFileCutter::getFrameSize() const
     {
         return frameSize_;
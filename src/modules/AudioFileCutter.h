@@ -21,7 +21,12 @@
 #define AUDIOFILECUTTER_H
 
 #include "../support/Module.h"
+#include "../support/MappedAudioFile.h"
+#include "../support/SPSCQueue.h"
 #include <sndfile.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 //We can exceed this but only by +frameSize
 #define MAX_BUFFER_SIZE 8192
@@ -37,6 +42,17 @@ namespace loudness{
      * This class uses an internal buffer to bring a block of samples into
      * memory, from which frames are extracted.
      *
+     * Uncompressed WAV files (16, 24 or 32 bit PCM, or float) are instead
+     * memory mapped, and each frame is converted, scaled and deinterleaved
+     * straight into the output SignalBank (see MappedAudioFile). Other
+     * formats are decoded through libsndfile.
+     *
+     * Decoding of compressed files (e.g. FLAC or Ogg Vorbis) can be moved to
+     * a background thread with setReadAheadUsed(). The thread decodes the
+     * next buffer while frames are taken from the current one, and hands
+     * filled buffers over through a lock-free queue, so the caller only
+     * waits if decoding falls behind.
+     *
      * Calling \ref process will generate a single frame of samples. If the
      * frame size is less than the length of the audio file or the end of the
      * file is reached, the frame is padded with zeros.
@@ -72,6 +88,27 @@ namespace loudness{
          * */
         void setGainInDecibels(Real gainInDecibels);
 
+        /** Use memory mapping for uncompressed WAV files (default true).
+         * Takes effect on initialisation. */
+        void setMemoryMappingUsed(bool isMemoryMappingUsed);
+
+        /** Returns true if the current file is read through a memory
+         * mapping. */
+        bool isMemoryMapped() const;
+
+        /** Decode on a background thread, one buffer ahead (default false).
+         * Only applies to files that are not memory mapped. Takes effect on
+         * initialisation. */
+        void setReadAheadUsed(bool isReadAheadUsed);
+
+        /** Returns true if the current file is decoded on a background
+         * thread. */
+        bool isReadAhead() const;
+
+        /** Positions the cutter so that the next call to process() extracts
+         * frame number @a frame. The output SignalBank is not modified. */
+        void seek(int frame);
+
         /** Returns the frame size (in samples) */
         int getFrameSize() const;
 
@@ -96,12 +133,33 @@ namespace loudness{
         virtual void processInternal();
         virtual void resetInternal();
 
+        /** Reads the next block of the file into @a buffer, zero padded. */
+        void decodeBuffer(float* buffer);
+        /** Body of the decode thread. */
+        void decode();
+        void startDecoding();
+        void stopDecoding();
+        void notifyDecoding();
+
         string fileName_;
         int frameSize_, nFrames_, fs_;
         int nSamplesToLoadPerChannel_, audioBufferSize_, bufferIdx_, frame_;
         vector<float> audioBuffer_;
         Real frameSizeInSeconds_, duration_, gainInDecibels_, linearGain_;
         SNDFILE* sndFile_;
+        bool isMemoryMappingUsed_;
+        MappedAudioFile mappedFile_;
+        long long framePosition_;
+
+        //read-ahead: audioBuffer_ holds two buffers, passed between the
+        //threads by index
+        bool isReadAheadUsed_;
+        int currentBuffer_;
+        SPSCQueue<int> filledBuffers_, freeBuffers_;
+        std::thread decodeThread_;
+        std::mutex decodeMutex_;
+        std::condition_variable decodeCondition_;
+        std::atomic<bool> isDecodingStopped_;
 
     };
 }
@@ -19,11 +19,14 @@
 
 #include "BinauralInhibitionMG2007.h"
 #include "../support/AuditoryTools.h"
+#include "../support/FastMath.h"
 
 namespace loudness{
 
     BinauralInhibitionMG2007::BinauralInhibitionMG2007() :
-        Module("BinauralInhibitionMG2007")
+        Module("BinauralInhibitionMG2007"),
+        kernelTolerance_(1e-12),
+        nKernelTerms_(0)
     {
         LOUDNESS_DEBUG(name_ << ": Constructed.");
     }
@@ -31,24 +34,63 @@ namespace loudness{
     BinauralInhibitionMG2007::~BinauralInhibitionMG2007()
     {};
 
+    void BinauralInhibitionMG2007::setKernelTolerance(Real kernelTolerance)
+    {
+        kernelTolerance_ = kernelTolerance;
+    }
+
+    int BinauralInhibitionMG2007::getNKernelTerms() const
+    {
+        return nKernelTerms_;
+    }
+
     bool BinauralInhibitionMG2007::initializeInternal(const SignalBank &input)
     {
         LOUDNESS_ASSERT(input.getNEars() == 2, name_
                 << ": This module requires an input SignalBank with two ears.");
 
-        /* Gaussian smoothing kernel. 
-         * Since the kernel is symmetric, we just use one half.
+        /* Gaussian smoothing kernel exp(-a(u - v)^2), with a = (0.08 g)^2
+         * for a channel spacing of g Cams.
+         * Channel positions are normalised by the half width h of the bank,
+         * so that 2a u v = zMax x y with x, y in [-1, 1] and zMax = 2a h^2.
          */
-        Real camStep = input.getChannelSpacingInCams(); 
-        gaussian_.assign (input.getNChannels(), 0.0);
+        int nChannels = input.getNChannels();
+        Real halfWidth = max((nChannels - 1) / 2.0, 1.0);
+        Real arg = 0.08 * input.getChannelSpacingInCams() * halfWidth;
+        Real aHalfWidthSq = arg * arg;
+        Real zMax = 2.0 * aHalfWidthSq;
+
+        position_.resize (nChannels);
+        envelope_.resize (nChannels);
+        for (int chn = 0; chn < nChannels; ++chn)
+        {
+            Real x = (chn - (nChannels - 1) / 2.0) / halfWidth;
+            position_[chn] = x;
+            envelope_[chn] = exp(-aHalfWidthSq * x * x);
+        }
 
-        for (int chn = 0; chn < input.getNChannels(); ++chn)
+        /* Taylor coefficients zMax^p / p! of exp(zMax x y).
+         * The error of a kernel weight is bounded by the first omitted term,
+         * since the envelopes cancel the growth of the remainder.
+         */
+        kernelCoefs_.clear();
+        Real term = 1.0;
+        while (term > kernelTolerance_)
         {
-            Real g = camStep * chn;
-            Real arg = (0.08 * g);
-            gaussian_[chn] = exp(-arg * arg);
+            kernelCoefs_.push_back (term);
+            term *= zMax / kernelCoefs_.size();
         }
+        nKernelTerms_ = (int)kernelCoefs_.size();
+        LOUDNESS_DEBUG(name_ << ": Number of kernel terms: " << nKernelTerms_);
+
+        powers_.assign (nChannels, 0.0);
+        moments_.assign (nKernelTerms_, 0.0);
+        smoothLeft_.assign (nChannels, 0.0);
+        smoothRight_.assign (nChannels, 0.0);
 
+        //inhibition of the left ear followed by the right
+        isFastMathUsed_ = isFastMathEnabled();
+        inhibition_.assign (2 * nChannels, 0.0);
 
         //output is same form as input
         output_.initialize (input);
@@ -56,8 +98,52 @@ namespace loudness{
         return 1;
     }
 
+    void BinauralInhibitionMG2007::smooth(const Real* specificLoudness,
+                                          Real* smoothSpecificLoudness)
+    {
+        int nChannels = (int)position_.size();
+        const Real* position = position_.data();
+        const Real* envelope = envelope_.data();
+        Real* powers = powers_.data();
+
+        //moments of the weighted input
+        for (int chn = 0; chn < nChannels; ++chn)
+            powers[chn] = specificLoudness[chn] * envelope[chn];
+
+        for (int p = 0; p < nKernelTerms_; ++p)
+        {
+            Real moment = 0.0;
+            for (int chn = 0; chn < nChannels; ++chn)
+            {
+                moment += powers[chn];
+                powers[chn] *= position[chn];
+            }
+            moments_[p] = kernelCoefs_[p] * moment;
+        }
+
+        //polynomial evaluation (Horner's method)
+        for (int chn = 0; chn < nChannels; ++chn)
+            smoothSpecificLoudness[chn] = moments_[nKernelTerms_ - 1];
+
+        for (int p = nKernelTerms_ - 2; p >= 0; --p)
+        {
+            Real moment = moments_[p];
+            for (int chn = 0; chn < nChannels; ++chn)
+                smoothSpecificLoudness[chn] = smoothSpecificLoudness[chn] *
+                                              position[chn] + moment;
+        }
+
+        for (int chn = 0; chn < nChannels; ++chn)
+            smoothSpecificLoudness[chn] *= envelope[chn];
+    }
+
     void BinauralInhibitionMG2007::processInternal(const SignalBank &input)
     {       
+        int nChannels = input.getNChannels();
+        Real* smoothLeft = smoothLeft_.data();
+        Real* smoothRight = smoothRight_.data();
+        Real* inhibition = inhibition_.data();
+
         for (int src = 0; src < input.getNSources(); ++src)
         {
             const Real* inputSpecificLoudnessLeft = input
@@ -73,45 +159,33 @@ namespace loudness{
                                                 .getSingleSampleWritePointer
                                                 (src, 1, 0);
 
-            int nChannels = input.getNChannels();
+            /* Stage 1: Smooth the specific loudness patterns */
+            smooth (inputSpecificLoudnessLeft, smoothLeft);
+            smooth (inputSpecificLoudnessRight, smoothRight);
+
+            //to output smoothed specific loudness patterns, copy smoothLeft
+            //and smoothRight to the output and skip stages 2 and 3
             for (int chn = 0; chn < nChannels; ++chn)
             { 
-                /* Stage 1: Smooth the specific loudness patterns */
-                Real smoothLeft = 0.0;
-                Real smoothRight = 0.0;
-
-                //Right side
-                int i = chn, j = 0;
-                while (i < nChannels)
-                {
-                    smoothLeft += inputSpecificLoudnessLeft[i] * gaussian_[j];
-                    smoothRight += inputSpecificLoudnessRight[i++] * gaussian_[j++];
-                }
-
-                //left side
-                j = nChannels - j;
-                i = 0;
-                while (j > 0)
-                {
-                    smoothLeft += inputSpecificLoudnessLeft[i] * gaussian_[j];
-                    smoothRight += inputSpecificLoudnessRight[i++] * gaussian_[j--];
-                }
-
-                /* Stage 2: Inhibition using Eqs 2 and 3 */
-                smoothLeft = max(smoothLeft, 1e-12);
-                smoothRight = max(smoothRight, 1e-12);
-                Real inhibLeft = 2 / (1 + pow(1.0 / cosh(smoothRight / smoothLeft), 1.5978));
-                Real inhibRight = 2 / (1 + pow(1.0 / cosh(smoothLeft / smoothRight), 1.5978));
-
-                /* Stage 3: Apply gains */
+                Real left = max(smoothLeft[chn], (Real)1e-12);
+                Real right = max(smoothRight[chn], (Real)1e-12);
+                inhibition[chn] = right / left;
+                inhibition[nChannels + chn] = left / right;
+            }
+
+            /* Stage 2: Inhibition using Eqs 2 and 3 */
+            vectorCosh (inhibition, inhibition, 2 * nChannels, isFastMathUsed_);
+            for (int i = 0; i < 2 * nChannels; ++i)
+                inhibition[i] = 1.0 / inhibition[i];
+            vectorPow (inhibition, 1.5978, inhibition, 2 * nChannels, isFastMathUsed_);
+
+            /* Stage 3: Apply gains */
+            for (int chn = 0; chn < nChannels; ++chn)
+            {
+                Real inhibLeft = 2 / (1 + inhibition[chn]);
+                Real inhibRight = 2 / (1 + inhibition[nChannels + chn]);
                 outputSpecificLoudnessLeft[chn] = inputSpecificLoudnessLeft[chn] / inhibLeft;
                 outputSpecificLoudnessRight[chn] = inputSpecificLoudnessRight[chn] / inhibRight;
-
-                //to output smoothed specific loudness patterns, uncomment:
-                /*
-                outputSpecificLoudnessLeft[chn] = smoothLeft;
-                outputSpecificLoudnessRight[chn] = smoothRight;
-                */
             }
         }
     }
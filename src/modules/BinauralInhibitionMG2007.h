@@ -42,6 +42,21 @@ namespace loudness{
      * can be used for the convolution, otherwise the shape of the weigthing
      * function would be frequency dependent.
      *
+     * The smoothing is evaluated in linear time by separating the kernel.
+     * With channel positions u and v measured from the centre of the bank,
+     * exp(-a(u - v)^2) = exp(-a u^2) exp(-a v^2) exp(2a u v), and the last
+     * factor is replaced by its Taylor series. The smoothed pattern is then a
+     * polynomial in u whose coefficients are moments of the input, so each
+     * ear costs O(N P) for N channels and P terms rather than O(N^2). P is
+     * the smallest number of terms for which the error of every kernel weight
+     * is below the tolerance set by setKernelTolerance(). This is about 30
+     * terms for a bank spanning the audible range and does not depend on the
+     * channel spacing.
+     *
+     * The inhibition (Eqs 2 and 3) is evaluated over all channels of both ears
+     * at once, using the fast elementary functions if enabled by
+     * setFastMathEnabled().
+     *
      * REFERENCES:
      *
      * Moore, B. C. J., & Glasberg, B. R. (2007). Modeling Binaural Loudness. The
@@ -60,14 +75,32 @@ namespace loudness{
 
         virtual ~BinauralInhibitionMG2007();
 
+        /**
+         * @brief Sets the maximum absolute error of each smoothing kernel
+         * weight (default is 1e-12). The peak weight is one.
+         *
+         * Takes effect on initialisation.
+         */
+        void setKernelTolerance(Real kernelTolerance);
+
+        /** Returns the number of terms of the kernel expansion. */
+        int getNKernelTerms() const;
+
     private:
         virtual bool initializeInternal(const SignalBank &input);
         virtual bool initializeInternal(){return 0;};
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
+
+        Real kernelTolerance_;
+        int nKernelTerms_;
+        bool isFastMathUsed_;
+        RealVec position_, envelope_, kernelCoefs_;
+        RealVec powers_, moments_, smoothLeft_, smoothRight_, inhibition_;
 
-        RealVec gaussian_;
+        void smooth(const Real* specificLoudness, Real* smoothSpecificLoudness);
     };
 }
 #endif
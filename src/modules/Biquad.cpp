@@ -18,6 +18,7 @@
  */
 
 #include "Biquad.h"
+#include "../support/DenormalGuard.h"
 
 namespace loudness{
 
@@ -44,33 +45,41 @@ namespace loudness{
 
     bool Biquad::initializeInternal(const SignalBank &input)
     {
+        //coefficients are designed in double precision whatever Real is
+        vector<double> bCoefs, aCoefs;
         if (type_ == "RLB")
         {
-            RealVec bCoefs = {1.0, -2.0, 1.0};
-            RealVec aCoefs = {1.0, -1.99004745483398, 0.99007225036621};
-            setBCoefs (bCoefs);
-            setACoefs (aCoefs);
+            bCoefs = {1.0, -2.0, 1.0};
+            aCoefs = {1.0, -1.99004745483398, 0.99007225036621};
             setCoefficientFs (48000);
         }
         else if (type_ == "prefilter")
         {
-            RealVec bCoefs = {1.53512485958697,
-                              -2.69169618940638, 
-                              1.19839281085285};
-            RealVec aCoefs = {1.0,
-                              -1.69065929318241, 
-                              0.73248077421585};
-            setBCoefs (bCoefs);
-            setACoefs (aCoefs);
+            bCoefs = {1.53512485958697,
+                      -2.69169618940638, 
+                      1.19839281085285};
+            aCoefs = {1.0,
+                      -1.69065929318241, 
+                      0.73248077421585};
             setCoefficientFs (48000);
         }
+        else
+        {
+            bCoefs.assign (bCoefs_.begin(), bCoefs_.end());
+            aCoefs.assign (aCoefs_.begin(), aCoefs_.end());
+        }
 
-        LOUDNESS_ASSERT( bCoefs_.size() == 3 &&
-                aCoefs_.size() == 3,
+        LOUDNESS_ASSERT( bCoefs.size() == 3 &&
+                aCoefs.size() == 3,
                 "Filter coefficients do not satisfy filter order");
 
         //normalise by a[0]
-        normaliseCoefs();
+        double a0 = aCoefs[0];
+        for (int i = 0; i < 3; ++i)
+        {
+            bCoefs[i] /= a0;
+            aCoefs[i] /= a0;
+        }
 
         //Transform coefficients if sampling frequency is different from
         //the one used in origin filter design
@@ -78,41 +87,42 @@ namespace loudness{
         //by Neunaber (2008)
         if((coefficientFs_ != 0) && (coefficientFs_ != input.getFs()))
         {
-            double fc = (coefficientFs_/PI) * atan( sqrt( (1+aCoefs_[1]+aCoefs_[2]) /
-                        (1-aCoefs_[1]+aCoefs_[2])));
-            double Q = sqrt((aCoefs_[2]+1)*(aCoefs_[2]+1) - aCoefs_[1]*aCoefs_[1]) /
-                        (2*fabs(1-aCoefs_[2]));
-            double Vl = (bCoefs_[0]+bCoefs_[1]+bCoefs_[2]) / (1+aCoefs_[1]+aCoefs_[2]);
-            double Vb = (bCoefs_[0] - bCoefs_[2]) / (1-aCoefs_[2]);
-            double Vh = (bCoefs_[0]-bCoefs_[1]+bCoefs_[2]) / (1-aCoefs_[1]+aCoefs_[2]);
+            double fc = (coefficientFs_/PI) * atan( sqrt( (1+aCoefs[1]+aCoefs[2]) /
+                        (1-aCoefs[1]+aCoefs[2])));
+            double Q = sqrt((aCoefs[2]+1)*(aCoefs[2]+1) - aCoefs[1]*aCoefs[1]) /
+                        (2*fabs(1-aCoefs[2]));
+            double Vl = (bCoefs[0]+bCoefs[1]+bCoefs[2]) / (1+aCoefs[1]+aCoefs[2]);
+            double Vb = (bCoefs[0] - bCoefs[2]) / (1-aCoefs[2]);
+            double Vh = (bCoefs[0]-bCoefs[1]+bCoefs[2]) / (1-aCoefs[1]+aCoefs[2]);
 
             double omega = tan(PI*fc/input.getFs());
             double omegaSqrd = omega*omega;
             double denom = omegaSqrd + omega/Q + 1;
 
-            aCoefs_[0] = 1.0;
-            aCoefs_[1] = 2*(omegaSqrd - 1) / denom;
-            aCoefs_[2] = (omegaSqrd - (omega/Q) + 1)/ denom;
+            aCoefs[0] = 1.0;
+            aCoefs[1] = 2*(omegaSqrd - 1) / denom;
+            aCoefs[2] = (omegaSqrd - (omega/Q) + 1)/ denom;
 
-            bCoefs_[0] = (Vl * omegaSqrd + Vb * (omega/Q) + Vh) / denom;
-            bCoefs_[1] = 2*(Vl*omegaSqrd - Vh) / denom;
-            bCoefs_[2] = (Vl*omegaSqrd - (Vb*omega/Q) + Vh) / denom;
+            bCoefs[0] = (Vl * omegaSqrd + Vb * (omega/Q) + Vh) / denom;
+            bCoefs[1] = 2*(Vl*omegaSqrd - Vh) / denom;
+            bCoefs[2] = (Vl*omegaSqrd - (Vb*omega/Q) + Vh) / denom;
         }
 
         /*
         std::cout << "A" << std::endl;
         for (int i = 0; i < 3; ++i)
-            std::cout << aCoefs_[i] << std::endl;
+            std::cout << aCoefs[i] << std::endl;
         std::cout << "B" << std::endl;
         for (int i = 0; i < 3; ++i)
-            std::cout << bCoefs_[i] << std::endl;
+            std::cout << bCoefs[i] << std::endl;
         */
 
-        delayLine_.initialize(input.getNSources(),
-                              input.getNEars(),
-                              input.getNChannels(),
-                              2,
-                              input.getFs());
+        setBCoefs (RealVec(bCoefs.begin(), bCoefs.end()));
+        setACoefs (RealVec(aCoefs.begin(), aCoefs.end()));
+
+        sections_.setSections ({bCoefs[0], bCoefs[1], bCoefs[2],
+                                aCoefs[0], aCoefs[1], aCoefs[2]});
+        sections_.initialize (input);
 
         //output SignalBank
         output_.initialize(input);
@@ -122,34 +132,8 @@ namespace loudness{
 
     void Biquad::processInternal(const SignalBank &input)
     {
-        for (int src = 0; src < input.getNSources(); ++src)
-        {
-            for (int ear = 0; ear < input.getNEars(); ++ear)
-            {
-                for (int chn = 0; chn < input.getNChannels(); ++chn)
-                {
-                    const Real* inputSignal = input.getSignalReadPointer
-                                                    (src, ear, chn);
-                    Real* outputSignal = output_.getSignalWritePointer
-                                                 (src, ear, chn);
-                    Real* z = delayLine_.getSignalWritePointer
-                                         (src, ear, chn);
-
-                    for (int smp = 0; smp < input.getNSamples(); ++smp)
-                    {
-                        //filter
-                        Real x = inputSignal[smp];
-                        Real y = bCoefs_[0] * x + z[0];
-                        z[0] = bCoefs_[1] * x - aCoefs_[1] * y + z[1];
-                        z[1] = bCoefs_[2] * x - aCoefs_[2] * y;
-                        outputSignal[smp] = y;
-                    }
-
-                    killDenormal (z[0]);
-                    killDenormal (z[1]);
-                }
-            }
-        }
+        DenormalGuard denormalGuard;
+        sections_.process (input, output_);
     }
 
     void Biquad::setCoefficientFs(const Real coefficientFs)
@@ -159,6 +143,6 @@ namespace loudness{
 
     void Biquad::resetInternal()
     {
-        delayLine_.zeroSignals();
+        sections_.reset();
     }
 }
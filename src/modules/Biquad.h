@@ -20,6 +20,7 @@
 #define  BIQUAD_H
 
 #include "../support/Filter.h"
+#include "../support/SecondOrderSections.h"
 
 namespace loudness{
 
@@ -63,6 +64,7 @@ namespace loudness{
 
             std::string type_;
             Real coefficientFs_ = 0;
+            SecondOrderSections sections_;
     };
 }
 #endif
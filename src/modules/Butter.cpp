@@ -18,6 +18,7 @@
  */
 
 #include "Butter.h"
+#include "../support/DenormalGuard.h"
 
 /*
  * Third order coefficients can be represented slightly better
@@ -42,23 +43,35 @@ namespace loudness{
         {
             case 3:
             {
-                aCoefs_.resize(4);
+                double T = 1.0/input.getFs();
+                double wc = 2.0/T * tan(2*PI*fc_*T/2.0);
+                double c1 = T*T*wc*wc;
+                double c2 = c1*T*wc/8.0;
+                double c3 = T*wc;
+                double a0 = c2 + 0.5 * c1 + c3 + 1;
+
+                //normalised coefficients, for reference only
                 bCoefs_.resize(4);
-
-                Real T = 1.0/input.getFs();
-                Real wc = 2.0/T * tan(2*PI*fc_*T/2.0);
-                Real c1 = T*T*wc*wc;
-                Real c2 = c1*T*wc/8.0;
-                Real c3 = T*wc;
-
-                bCoefs_[0] = 1.0;
-                bCoefs_[1] = -3.0;
-                bCoefs_[2] = 3.0;
-                bCoefs_[3] = -1.0;
-                aCoefs_[0] = c2 + 0.5 * c1 + c3 + 1;
-                aCoefs_[1] = 3*c2 + 0.5 * c1 - c3 - 3;
-                aCoefs_[2] = 3*c2 - 0.5 * c1 - c3 + 3;
-                aCoefs_[3] = c2 - 0.5 * c1 + c3 - 1;
+                aCoefs_.resize(4);
+                bCoefs_[0] = 1.0 / a0;
+                bCoefs_[1] = -3.0 / a0;
+                bCoefs_[2] = 3.0 / a0;
+                bCoefs_[3] = -1.0 / a0;
+                aCoefs_[0] = 1.0;
+                aCoefs_[1] = (3*c2 + 0.5 * c1 - c3 - 3) / a0;
+                aCoefs_[2] = (3*c2 - 0.5 * c1 - c3 + 3) / a0;
+                aCoefs_[3] = (c2 - 0.5 * c1 + c3 - 1) / a0;
+
+                /*
+                 * The analogue prototype factors as
+                 * s^3 / ((s + wc) (s^2 + wc s + wc^2)).
+                 * Bilinear transform of each factor, with h = wc T / 2.
+                 */
+                double h = 0.5 * c3;
+                sections_.setSections ({1.0, -1.0, 0.0,
+                                        1 + h, h - 1, 0.0,
+                                        1.0, -2.0, 1.0,
+                                        1 + h + h*h, 2*h*h - 2, 1 - h + h*h});
 
                 break;
             }
@@ -69,14 +82,7 @@ namespace loudness{
             }
         }
 
-        //normalise by a[0]
-        normaliseCoefs();
-
-        delayLine_.initialize(input.getNSources(),
-                              input.getNEars(),
-                              input.getNChannels(),
-                              2 * order_,
-                              input.getFs());
+        sections_.initialize(input);
 
         //output SignalBank
         output_.initialize(input);
@@ -86,57 +92,12 @@ namespace loudness{
 
     void Butter::processInternal(const SignalBank &input)
     {
-        switch(order_)
-        {
-            case 3:
-                for (int src = 0; src < input.getNSources(); ++src)
-                {
-                    for (int ear = 0; ear < input.getNEars(); ++ear)
-                    {
-                        for (int chn = 0; chn < input.getNChannels(); ++chn)
-                        {
-                            const Real* inputSignal = input
-                                                      .getSignalReadPointer
-                                                      (src, ear, chn);
-                            Real* outputSignal = output_
-                                                 .getSignalWritePointer
-                                                 (src, ear, chn);
-                            Real* z = delayLine_
-                                      .getSignalWritePointer
-                                      (src, ear, chn);
-
-                            for (int smp = 0; smp < input.getNSamples(); smp++)
-                            {
-                                //input sample
-                                Real x = inputSignal[smp];
-                                
-                                //filter
-                                Real y = bCoefs_[0]*(x-z[2]) + bCoefs_[2]*
-                                         (z[1]-z[0]) - aCoefs_[1]*z[3] -
-                                         aCoefs_[2]*z[4] - aCoefs_[3]*z[5];
-
-                                //update delay line
-                                z[5] = z[4];
-                                z[4] = z[3];
-                                z[3] = y;
-                                z[2] = z[1];
-                                z[1] = z[0];
-                                z[0] = x;
-
-                                //output sample
-                                outputSignal[smp] = y;
-                            }
-
-                            for (int i = 3; i < 6; ++i)
-                                killDenormal (z[i]);
-                        }
-                    }
-                }
-        }
+        DenormalGuard denormalGuard;
+        sections_.process(input, output_);
     }
 
     void Butter::resetInternal()
     {
-        delayLine_.zeroSignals();
+        sections_.reset();
     }
 }
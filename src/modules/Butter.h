@@ -21,6 +21,7 @@
 #define  BUTTER_H
 
 #include "../support/Filter.h"
+#include "../support/SecondOrderSections.h"
 
 namespace loudness{
 
@@ -31,6 +32,11 @@ namespace loudness{
      *
      * At present, this algorithm is limited to a third order high-pass filter.
      * At present, this algorithm supports multiple ears but not multiple channels.
+     *
+     * The filter is applied as a first order section followed by a second
+     * order section, held in double precision regardless of Real: with a low
+     * cut-off the poles lie too close to the unit circle for a
+     * single-precision filter to be stable (see SecondOrderSections).
      */
     class Butter : public Module, public Filter
     {
@@ -50,6 +56,7 @@ namespace loudness{
 
         int type_;
         Real fc_;
+        SecondOrderSections sections_;
     };
 }
 #endif
@@ -45,7 +45,7 @@ namespace loudness{
         int i=0, binIdxPrev = 0;
         Real dif = hertzToCam(input.getCentreFreq(1)) - 
                    hertzToCam(input.getCentreFreq(0));
-        int groupSize = max(2.0, std::floor(alpha_/(dif)));
+        int groupSize = max((Real)2.0, std::floor(alpha_/(dif)));
         int groupSizePrev = groupSize;
         vector<int> groupSizeStore, binIdx;
 
@@ -87,7 +87,7 @@ namespace loudness{
                 {
                     dif = hertzToCam(input.getCentreFreq(store)) - 
                           hertzToCam(input.getCentreFreq(store-1));
-                    groupSize = max((double)groupSize, std::floor(alpha_/dif));
+                    groupSize = max((Real)groupSize, std::floor(alpha_/dif));
                 }
 
                 //fill variables
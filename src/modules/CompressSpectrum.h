@@ -63,6 +63,7 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
 
         vector<int> upperBandIdx_;
         Real alpha_;
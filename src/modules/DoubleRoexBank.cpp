@@ -33,12 +33,18 @@ namespace loudness{
         camHi_(camHi),
         camStep_(camStep),
         scalingFactor_(scalingFactor),
+        weightTolerance_(1e-12),
         isExcitationPatternInterpolated_(isExcitationPatternInterpolated),
         isInterpolationCubic_(isInterpolationCubic)
     {}
 
     DoubleRoexBank::~DoubleRoexBank() {}
 
+    void DoubleRoexBank::setWeightTolerance(Real weightTolerance)
+    {
+        weightTolerance_ = weightTolerance;
+    }
+
     bool DoubleRoexBank::initializeInternal(const SignalBank &input)
     {
 
@@ -91,12 +97,25 @@ namespace loudness{
         output_.setFrameRate (input.getFrameRate());
 
         //filter variables
-        wPassive_.resize (nFilters_);
-        wActive_.resize (nFilters_);
+        wPassive_.initialize (nFilters_, input.getNChannels());
+        wActive_.initialize (nFilters_, input.getNChannels());
         maxGdB_.resize (nFilters_);
         thirdGainTerm_.resize (nFilters_);
 
+        //filter outputs for each frame of a block
+        excitationLinP_.assign (blockSize_, RealVec(nFilters_, 0.0));
+        excitationLinA_.assign (blockSize_, RealVec(nFilters_, 0.0));
+        inputSpectra_.resize (blockSize_);
+        excitationLinPPtrs_.resize (blockSize_);
+        excitationLinAPtrs_.resize (blockSize_);
+        for (int frame = 0; frame < blockSize_; ++frame)
+        {
+            excitationLinPPtrs_[frame] = excitationLinP_[frame].data();
+            excitationLinAPtrs_[frame] = excitationLinA_[frame].data();
+        }
+
         //fill the above arrays
+        RealVec passive, active;
         for (int i = 0; i < nFilters_; ++i)
         {
             //filter frequency in Cams
@@ -121,6 +140,8 @@ namespace loudness{
             thirdGainTerm_[i] = maxGdB_[i] / (1 + exp (0.05 * (100 - maxGdB_[i])));
 
             //compute the fixed filters
+            passive.clear();
+            active.clear();
             int j = 0;
             while (j < input.getNChannels())
             {
@@ -144,14 +165,29 @@ namespace loudness{
                     }
 
                     //Eq. 4 and Eq. 7
-                    wPassive_[i].push_back ((1 + pgPassive) * exp (-pgPassive)); 
-                    wActive_[i].push_back ((1 + pgActive) * exp (-pgActive)); 
+                    passive.push_back ((1 + pgPassive) * exp (-pgPassive)); 
+                    active.push_back ((1 + pgActive) * exp (-pgActive)); 
                 }
                 else
                     break;
                 j++;
             }
+
+            //keep the non-negligible weights only
+            wPassive_.setRow (passive, 0, weightTolerance_);
+            wActive_.setRow (active, 0, weightTolerance_);
         }
+        //precompute the interpolation of the excitation pattern
+        if (isExcitationPatternInterpolated_)
+        {
+            RealVec camsInterp (388);
+            for (int i = 0; i < 388; ++i)
+                camsInterp[i] = camLo_ + i * 0.1;
+            interpolator_.initialize (cams_, camsInterp, isInterpolationCubic_);
+        }
+
+        LOUDNESS_DEBUG(name_ << ": Filter weights used: "
+                << wPassive_.getNNonZero() + wActive_.getNNonZero());
         LOUDNESS_DEBUG(name_ << ": Passive and active filters configured.");
         LOUDNESS_DEBUG(name_ << ": Excitation pattern will be scaled by: " 
                 << scalingFactor_);
@@ -162,71 +198,96 @@ namespace loudness{
 
     void DoubleRoexBank::processInternal(const SignalBank &input)
     {
-        /*
-         * Perform the excitation transformation
-         */
-        for (int src = 0; src < input.getNSources(); ++src)
+        processFrames(&input, &output_, 1);
+    }
+
+    void DoubleRoexBank::processBlockInternal(const SignalBank* inputs,
+                                              int nInputs)
+    {
+        if (!isBlockTriggered(inputs, nInputs))
         {
-            for (int ear = 0; ear < input.getNEars(); ++ear)
+            Module::processBlockInternal(inputs, nInputs);
+            return;
+        }
+
+        processFrames(inputs, outputBlock_.data(), nInputs);
+        for (int i = 0; i < nInputs; ++i)
+            outputBlock_[i].setTrig(true);
+    }
+
+    void DoubleRoexBank::processFrames(const SignalBank* inputs,
+                                       SignalBank* outputs,
+                                       int nFrames)
+    {
+        for (int src = 0; src < inputs[0].getNSources(); ++src)
+        {
+            for (int ear = 0; ear < inputs[0].getNEars(); ++ear)
             {
-                const Real* inputSpectrum = input
-                                            .getSingleSampleReadPointer
-                                            (src, ear, 0);
-                Real* outputExcitationPattern = output_
-                                                .getSingleSampleWritePointer
-                                                (src, ear, 0);
-
-                for (int i = 0; i < nFilters_; ++i)
+                //passive and active filter outputs for all frames
+                for (int frame = 0; frame < nFrames; ++frame)
                 {
-                    Real excitationLinP = 0.0;
-                    Real excitationLinA = 0.0;
+                    inputSpectra_[frame] = inputs[frame]
+                                           .getSingleSampleReadPointer
+                                           (src, ear, 0);
+                }
+                wPassive_.multiply (inputSpectra_.data(),
+                                    excitationLinPPtrs_.data(),
+                                    nFrames);
+                wActive_.multiply (inputSpectra_.data(),
+                                   excitationLinAPtrs_.data(),
+                                   nFrames);
+
+                //Perform the excitation transformation
+                for (int frame = 0; frame < nFrames; ++frame)
+                {
+                    Real* outputExcitationPattern = outputs[frame]
+                                                    .getSingleSampleWritePointer
+                                                    (src, ear, 0);
 
-                    //passive filter output
-                    for (uint j = 0; j < wPassive_[i].size(); ++j)
-                        excitationLinP += wPassive_[i][j] * inputSpectrum[j];
+                    for (int i = 0; i < nFilters_; ++i)
+                    {
+                        Real excitationLinP = excitationLinP_[frame][i];
 
-                    //convert to dB
-                    Real excitationLog = powerToDecibels (excitationLinP);
+                        //convert to dB
+                        Real excitationLog = powerToDecibels (excitationLinP);
 
-                    //compute gain (Complete Eq. 6 for <= 30)
-                    Real gain = maxGdB_[i] - (maxGdB_[i] / 
-                            (1 + exp (-0.05*(excitationLog - (100 - maxGdB_[i]))))) +
-                            thirdGainTerm_[i];
+                        //compute gain (Complete Eq. 6 for <= 30)
+                        Real gain = maxGdB_[i] - (maxGdB_[i] / 
+                                (1 + exp (-0.05*(excitationLog - (100 - maxGdB_[i]))))) +
+                                thirdGainTerm_[i];
 
-                    //check for higher levels
-                    if (excitationLog > 30)
-                    {
-                        //complete Eq. 6 for > 30
-                        Real excitationLogMinus30 = excitationLog - 30;
-                        gain = gain - 0.003 * excitationLogMinus30 * excitationLogMinus30;
-                    }
+                        //check for higher levels
+                        if (excitationLog > 30)
+                        {
+                            //complete Eq. 6 for > 30
+                            Real excitationLogMinus30 = excitationLog - 30;
+                            gain = gain - 0.003 * excitationLogMinus30 * excitationLogMinus30;
+                        }
 
-                    //convert to linear gain
-                    gain = decibelsToPower(gain);
+                        //convert to linear gain
+                        gain = decibelsToPower(gain);
 
-                    //active filter output
-                    for (uint j = 0; j < wActive_[i].size(); ++j)
-                        excitationLinA += wActive_[i][j] * inputSpectrum[j];
-                    excitationLinA *= gain;
+                        //active filter output
+                        Real excitationLinA = gain * excitationLinA_[frame][i];
 
-                    //excitation pattern
-                    Real excitation = scalingFactor_ * (excitationLinP + excitationLinA);
+                        //excitation pattern
+                        Real excitation = scalingFactor_ * (excitationLinP + excitationLinA);
 
-                    if (isExcitationPatternInterpolated_)
-                        logExcitation_[i] = log(excitation + 1e-10);
-                    else
-                        outputExcitationPattern[i] = excitation;
-                }
+                        if (isExcitationPatternInterpolated_)
+                            logExcitation_[i] = log(excitation + 1e-10);
+                        else
+                            outputExcitationPattern[i] = excitation;
+                    }
 
-                //Interpolate to estimate 0.1~Cam res excitation pattern
-                if (isExcitationPatternInterpolated_)
-                {
-                    spline_.set_points (cams_,
-                                        logExcitation_,
-                                        isInterpolationCubic_);
+                    //Interpolate to estimate 0.1~Cam res excitation pattern
+                    if (isExcitationPatternInterpolated_)
+                    {
+                        interpolator_.process (logExcitation_.data(),
+                                               outputExcitationPattern);
 
-                    for (int i = 0; i < 388; ++i)
-                        outputExcitationPattern[i] = exp (spline_ (camLo_ + i * 0.1));
+                        for (int i = 0; i < 388; ++i)
+                            outputExcitationPattern[i] = exp (outputExcitationPattern[i]);
+                    }
                 }
             }
         }
@@ -21,7 +21,8 @@
 #define DOUBLEROEXBANK_H
 
 #include "../support/Module.h"
-#include "../thirdParty/spline/Spline.h"
+#include "../support/SparseMatrix.h"
+#include "../support/SplineInterpolator.h"
 
 namespace loudness{
 
@@ -78,6 +79,15 @@ namespace loudness{
 
         virtual ~DoubleRoexBank();
 
+        /**
+         * @brief Sets the magnitude below which filter weights are treated
+         * as zero (default is 1e-12).
+         *
+         * Only the contiguous range of input channels with larger weights
+         * is applied by each filter. Takes effect on initialisation.
+         */
+        void setWeightTolerance(Real weightTolerance);
+
     private:
 
         virtual bool initializeInternal(const SignalBank &input);
@@ -85,13 +95,21 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
+        virtual void processBlockInternal(const SignalBank* inputs, int nInputs);
+
+        void processFrames(const SignalBank* inputs, SignalBank* outputs,
+                int nFrames);
 
-        Real camLo_, camHi_, camStep_, scalingFactor_;
+        Real camLo_, camHi_, camStep_, scalingFactor_, weightTolerance_;
         bool isExcitationPatternInterpolated_, isInterpolationCubic_;
         int nFilters_;
         RealVec maxGdB_, thirdGainTerm_, cams_, logExcitation_;
-        RealVecVec wPassive_, wActive_;
-        spline spline_;
+        RealVecVec excitationLinP_, excitationLinA_;
+        SparseMatrix wPassive_, wActive_;
+        vector<const Real*> inputSpectra_;
+        vector<Real*> excitationLinPPtrs_, excitationLinAPtrs_;
+        SplineInterpolator interpolator_;
     };
 }
 
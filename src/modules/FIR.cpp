@@ -21,16 +21,32 @@
 
 namespace loudness{
 
-    FIR::FIR() : Module("FIR") {}
+    FIR::FIR() :
+        Module("FIR"),
+        convolutionThreshold_(64),
+        isConvolutionUsed_(false)
+    {}
 
     FIR::FIR(const RealVec &bCoefs) :
-        Module("FIR")
+        Module("FIR"),
+        convolutionThreshold_(64),
+        isConvolutionUsed_(false)
     {
         setBCoefs(bCoefs);
     }
 
     FIR::~FIR() {}
 
+    void FIR::setConvolutionThreshold(int convolutionThreshold)
+    {
+        convolutionThreshold_ = convolutionThreshold;
+    }
+
+    bool FIR::isConvolutionUsed() const
+    {
+        return isConvolutionUsed_;
+    }
+
     bool FIR::initializeInternal(const SignalBank &input)
     {
         LOUDNESS_ASSERT(bCoefs_.size() > 0, name_ << ": No filter coefficients");
@@ -40,12 +56,28 @@ namespace loudness{
         orderMinus1_ = order_ - 1;
         LOUDNESS_DEBUG("FIR: Filter order is: " << order_);
 
-        //internal delay line - single vector for all ears
-        delayLine_.initialize (input.getNSources(),
-                   input.getNEars(),
-                   input.getNChannels(),
-                   order_,
-                   input.getFs());
+        //long filters are cheaper by FFT unless the blocks are tiny
+        isConvolutionUsed_ = ((int)bCoefs_.size() >= convolutionThreshold_) &&
+                             (input.getNSamples() >= 16);
+        if (isConvolutionUsed_)
+        {
+            convolution_.setImpulseResponse (bCoefs_);
+            if (!convolution_.initialize (input))
+                return 0;
+            LOUDNESS_DEBUG(name_ << ": Using FFT convolution with "
+                    << convolution_.getNPartitions()
+                    << " partitions of "
+                    << convolution_.getPartitionSize() << " samples");
+        }
+        else
+        {
+            //internal delay line - single vector for all ears
+            delayLine_.initialize (input.getNSources(),
+                       input.getNEars(),
+                       input.getNChannels(),
+                       order_,
+                       input.getFs());
+        }
 
         //output SignalBank
         output_.initialize (input);
@@ -55,6 +87,12 @@ namespace loudness{
 
     void FIR::processInternal(const SignalBank &input)
     {
+        if (isConvolutionUsed_)
+        {
+            convolution_.process (input, output_);
+            return;
+        }
+
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for(int ear = 0; ear < input.getNEars(); ++ear)
@@ -89,6 +127,9 @@ namespace loudness{
 
     void FIR::resetInternal()
     {
-        delayLine_.zeroSignals();
+        if (isConvolutionUsed_)
+            convolution_.reset();
+        else
+            delayLine_.zeroSignals();
     }
 }
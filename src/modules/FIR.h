@@ -21,6 +21,7 @@
 #define FIR_H
 
 #include "../support/Filter.h"
+#include "../support/PartitionedConvolution.h"
 
 
 namespace loudness{
@@ -30,9 +31,13 @@ namespace loudness{
      *
      * @brief Performs FIR filtering of an input SignalBank using direct form 2.
      *
-     * At present, this algorithm supports multiple ears but not multiple channels.
+     * Filters with at least as many taps as the convolution threshold (see
+     * setConvolutionThreshold()) are instead applied by uniformly partitioned
+     * FFT convolution, with partitions of the input block size. This is
+     * only done for blocks of at least 16 samples; the output is the same
+     * either way, apart from rounding.
      *
-     * @sa Filter
+     * @sa Filter, PartitionedConvolution
      */
     class FIR : public Module, public Filter
     {
@@ -45,12 +50,25 @@ namespace loudness{
 
         virtual ~FIR();
 
+        /**
+         * @brief Sets the number of taps from which FFT convolution is used
+         * (default 64). Takes effect on initialisation.
+         */
+        void setConvolutionThreshold(int convolutionThreshold);
+
+        /** Returns true if the filter is applied by FFT convolution. */
+        bool isConvolutionUsed() const;
+
     private:
         virtual bool initializeInternal(const SignalBank &input);
         virtual bool initializeInternal(){return 0;};
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+
+        int convolutionThreshold_;
+        bool isConvolutionUsed_;
+        PartitionedConvolution convolution_;
     };
 }
 
@@ -27,17 +27,35 @@ namespace loudness{
             bool isInterpolationCubic) :
         Module("FastRoexBank"),
         camStep_(camStep),
+        levelStepInDecibels_(1.0),
         isExcitationPatternInterpolated_(isExcitationPatternInterpolated),
-        isInterpolationCubic_(isInterpolationCubic)
+        isInterpolationCubic_(isInterpolationCubic),
+        isLevelQuantised_(false)
     {}
 
     FastRoexBank::~FastRoexBank() {}
 
+    void FastRoexBank::setLevelStepInDecibels(Real levelStepInDecibels)
+    {
+        levelStepInDecibels_ = levelStepInDecibels;
+    }
+
+    void FastRoexBank::setLevelQuantised(bool isLevelQuantised)
+    {
+        isLevelQuantised_ = isLevelQuantised;
+    }
+
     bool FastRoexBank::initializeInternal(const SignalBank &input)
     {
         //Camstep limit is 0.1
         if(camStep_ <= 0.1)
             isExcitationPatternInterpolated_ = false;
+
+        if (levelStepInDecibels_ <= 0)
+        {
+            LOUDNESS_ERROR(name_ << ": Level step must be positive.");
+            return 0;
+        }
         
         /*
          * Level per ERB precalculations
@@ -103,11 +121,24 @@ namespace loudness{
         //p upper is level invariant
         pu_.assign (nFilters_, 0.0);
         
-        //p lower is level dependent
-        pl_.assign (nFilters_, 0.0);
-
-        //comp_level holds level per ERB on each component
-        compLevel_.assign (input.getNChannels(), 0.0);
+        /* p lower is level dependent:
+         * pu - pl * (L - 51) = pu * (1 - levelSlope * (L - 51)) 
+         * The right hand factor is the same for all filters, and p >= 0.1
+         * gives a minimum per filter.
+         */
+        levelSlope_ = 0.35 / p51_1k;
+        minLevelFactor_.assign (nFilters_, 0.0);
+
+        //levelFactor holds the level dependent factor on each component,
+        //for every frame of a block
+        levelFactor_.assign (blockSize_, RealVec(input.getNChannels(), 0.0));
+        levelIdx_.assign (blockSize_, 0);
+        componentLevelIdx_.assign (blockSize_,
+                                   vector<int>(input.getNChannels(), 0));
+        cumulativePower_.assign (blockSize_,
+                                 RealVec(input.getNChannels() + 1, 0.0));
+        excitationLin_.assign (blockSize_, 0.0);
+        inputPowerSpectra_.assign (blockSize_, 0);
 
         //centre freqs in Hz
         fc_.assign (nFilters_, 0.0);
@@ -119,7 +150,7 @@ namespace loudness{
             cams_.assign (nFilters_, 0.0);
 
             //required for log interpolation
-            excitationLevel_.assign (nFilters_, 0.0);
+            excitationLevel_.assign (blockSize_, RealVec(nFilters_, 0.0));
 
             //372 filters over [1.8, 38.9] in 0.1 steps
             output_.initialize (input.getNSources(),
@@ -160,18 +191,165 @@ namespace loudness{
             Real erb = centreFreqToCambridgeERB (fc_[i]);
             //ANSI S3.4 sec 3.5 p.11
             pu_[i] = 4.0 * fc_[i] / erb;
-            //from Eq (3)
-            pl_[i] = 0.35 * (pu_[i] / p51_1k);
+            //from Eq (3): p = max(pu * levelFactor, 0.1)
+            minLevelFactor_[i] = 0.1 / pu_[i];
+        }
+
+        //precompute the interpolation of the excitation pattern
+        if (isExcitationPatternInterpolated_)
+        {
+            RealVec camsInterp (372);
+            for (int i = 0; i < 372; ++i)
+                camsInterp[i] = 1.8 + i * 0.1;
+            interpolator_.initialize (cams_, camsInterp, isInterpolationCubic_);
         }
         
         //generate lookup table for rounded exponential
         generateRoexTable(1024);
+
+        //bins reached by each filter
+        configureFilterSupport(input);
         
         return 1;
     }
 
+    void FastRoexBank::configureFilterSupport(const SignalBank &input)
+    {
+        int nChannels = input.getNChannels();
+
+        //levels per ERB (minus 51 dB) are floored at -151 dB, and the level
+        //factor reaches zero at 1 / levelSlope_
+        minCompLevel_ = -151.0;
+        nLevels_ = std::ceil ((1.0 / levelSlope_ - minCompLevel_) /
+                              levelStepInDecibels_) + 1;
+
+        centreBinIdx_.assign (nFilters_, 0);
+        endBinIdx_.assign (nFilters_, 0);
+        tailEndBinIdx_.assign (nFilters_, 0);
+        startBinIdx_.assign (nFilters_ * nLevels_, 0);
+        lowerSkirtPg_.resize (nFilters_);
+        upperSkirtWeights_.resize (nFilters_);
+        lowerSkirtWeights_.resize (nFilters_);
+        size_t nTableWeights = 0;
+
+        for (int i = 0; i < nFilters_; ++i)
+        {
+            /*
+             * Lower skirt: p * abs(g) / step_ without the level factor
+             */
+            int j = 0;
+            lowerSkirtPg_[i].clear();
+            while ((j < nChannels) && (input.getCentreFreq(j) < fc_[i]))
+            {
+                Real g = (input.getCentreFreq(j) - fc_[i]) / fc_[i];
+                lowerSkirtPg_[i].push_back (-pu_[i] * g / step_);
+                j++;
+            }
+            centreBinIdx_[i] = j;
+
+            /*
+             * Upper skirt: level invariant weights up to g = 2, followed by
+             * the components clamped to the end of the table
+             */
+            upperSkirtWeights_[i].clear();
+            while (j < nChannels)
+            {
+                Real g = (input.getCentreFreq(j) - fc_[i]) / fc_[i];
+                if (g > 2)
+                    break;
+                int idx = (int)(pu_[i] * g / step_ + 0.5);
+                if (idx >= roexIdxLimit_)
+                    break;
+                upperSkirtWeights_[i].push_back (roexTable_[idx]);
+                j++;
+            }
+            endBinIdx_[i] = j;
+            while ((j < nChannels) &&
+                   ((input.getCentreFreq(j) - fc_[i]) / fc_[i] <= 2))
+                j++;
+            tailEndBinIdx_[i] = j;
+
+            /*
+             * First bin not clamped to the end of the table for the level at
+             * the top of each level step. pg decreases towards the centre
+             * frequency and lower levels can only increase it.
+             */
+            int start = 0;
+            for (int level = nLevels_ - 1; level >= 0; --level)
+            {
+                Real levelFactor = quantisedLevelFactor (i, level);
+                while ((start < centreBinIdx_[i]) &&
+                       (levelFactor * lowerSkirtPg_[i][start] + 0.5 >= roexIdxLimit_))
+                    start++;
+                startBinIdx_[i * nLevels_ + level] = start;
+            }
+
+            /*
+             * Lower skirt weights of the components within reach at the
+             * highest level, for every level step
+             */
+            lowerSkirtWeights_[i].clear();
+            if (isLevelQuantised_)
+            {
+                int first = startBinIdx_[i * nLevels_ + nLevels_ - 1];
+                lowerSkirtWeights_[i].resize
+                    ((centreBinIdx_[i] - first) * nLevels_);
+                for (int j = first; j < centreBinIdx_[i]; ++j)
+                {
+                    Real* weights = &lowerSkirtWeights_[i]
+                                    [(j - first) * nLevels_];
+                    for (int level = 0; level < nLevels_; ++level)
+                    {
+                        Real pg = quantisedLevelFactor (i, level) *
+                                  lowerSkirtPg_[i][j];
+                        int idx = min ((int)(pg + 0.5), roexIdxLimit_);
+                        weights[level] = roexTable_[idx];
+                    }
+                }
+                nTableWeights += lowerSkirtWeights_[i].size();
+            }
+        }
+
+        if (isLevelQuantised_)
+        {
+            LOUDNESS_DEBUG(name_ << ": lower skirt weight tables hold "
+                    << nTableWeights << " weights over "
+                    << nLevels_ << " levels.");
+        }
+    }
+
+    Real FastRoexBank::quantisedLevelFactor(int filter, int level) const
+    {
+        Real compLevel = minCompLevel_ + level * levelStepInDecibels_;
+        Real levelFactor = 1.0 - levelSlope_ * compLevel;
+        return max (levelFactor, minLevelFactor_[filter]);
+    }
+
     void FastRoexBank::processInternal(const SignalBank &input)
     {
+        processFrames(&input, &output_, 1);
+    }
+
+    void FastRoexBank::processBlockInternal(const SignalBank* inputs,
+                                            int nInputs)
+    {
+        if (!isBlockTriggered(inputs, nInputs))
+        {
+            Module::processBlockInternal(inputs, nInputs);
+            return;
+        }
+
+        processFrames(inputs, outputBlock_.data(), nInputs);
+        for (int i = 0; i < nInputs; ++i)
+            outputBlock_[i].setTrig(true);
+    }
+
+    void FastRoexBank::processFrames(const SignalBank* inputs,
+                                     SignalBank* outputs,
+                                     int nFrames)
+    {
+        const SignalBank& input = inputs[0];
+        int nChannels = input.getNChannels();
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for (int ear = 0; ear < input.getNEars(); ++ear)
@@ -179,71 +357,132 @@ namespace loudness{
                 /*
                  * Part 1: Obtain the level per ERB about each input component
                  */
-                int nChannels = input.getNChannels();
-                const Real* inputPowerSpectrum = input
-                                                 .getSingleSampleReadPointer
-                                                 (src, ear, 0);
-                Real* outputExcitationPattern = output_
-                                                .getSingleSampleWritePointer
-                                                (src, ear, 0);
-
-                Real runningSum = 0.0;
-                int j = 0;
-                int k = rectBinIndices_[0][0];
-                for (int i = 0; i < nChannels; ++i)
+                for (int frame = 0; frame < nFrames; ++frame)
                 {
-                    //running sum of component powers
-                    while (j < rectBinIndices_[i][1])
-                        runningSum += inputPowerSpectrum[j++];
+                    const Real* inputPowerSpectrum = inputs[frame]
+                                                     .getSingleSampleReadPointer
+                                                     (src, ear, 0);
+                    inputPowerSpectra_[frame] = inputPowerSpectrum;
+                    Real* levelFactor = levelFactor_[frame].data();
+                    int* componentLevelIdx = componentLevelIdx_[frame].data();
+                    Real* cumulativePower = cumulativePower_[frame].data();
+
+                    Real runningSum = 0.0, maxCompLevel = minCompLevel_;
+                    int j = 0;
+                    int k = rectBinIndices_[0][0];
+                    for (int i = 0; i < nChannels; ++i)
+                    {
+                        //running sum of component powers
+                        while (j < rectBinIndices_[i][1])
+                            runningSum += inputPowerSpectrum[j++];
+
+                        //subtract components outside the window
+                        while (k < rectBinIndices_[i][0])
+                            runningSum -= inputPowerSpectrum[k++];
+
+                        //convert to dB, subtract 51 here to save operations later
+                        Real compLevel = powerToDecibels (runningSum, (Real)1e-10, (Real)-100.0) - 51;
+                        maxCompLevel = max (maxCompLevel, compLevel);
 
-                    //subtract components outside the window
-                    while (k < rectBinIndices_[i][0])
-                        runningSum -= inputPowerSpectrum[k++];
+                        //level dependent part of Eq (3)
+                        levelFactor[i] = 1.0 - levelSlope_ * compLevel;
+
+                        //nearest level step
+                        if (isLevelQuantised_)
+                        {
+                            int level = (int)((compLevel - minCompLevel_) /
+                                              levelStepInDecibels_ + 0.5);
+                            componentLevelIdx[i] = min (max (level, 0),
+                                                        nLevels_ - 1);
+                        }
+
+                        //for the components clamped to the end of the table
+                        cumulativePower[i + 1] = cumulativePower[i] +
+                                                 inputPowerSpectrum[i];
+                    }
 
-                    //convert to dB, subtract 51 here to save operations later
-                    compLevel_[i] = powerToDecibels (runningSum, 1e-10, -100.0) - 51;
+                    //round up to the next level step
+                    int level = std::ceil ((maxCompLevel - minCompLevel_) /
+                                           levelStepInDecibels_);
+                    levelIdx_[frame] = min (max (level, 0), nLevels_ - 1);
                 }
 
                 /*
                  * Part 2: Complete roex filter response and compute excitation per ERB
+                 * Each filter is applied to all frames before moving on.
                  */
-                Real g = 0.0, p = 0.0, pg = 0.0, excitationLin = 0.0;
-                int idx = 0;
                 for (int i = 0; i < nFilters_; ++i)
                 {
-                    excitationLin = 0.0;
-                    j = 0;
-
-                    while (j < nChannels)
+                    const Real* lowerSkirtPg = lowerSkirtPg_[i].data();
+                    const Real* upperSkirtWeights = upperSkirtWeights_[i].data();
+                    const Real minLevelFactor = minLevelFactor_[i];
+                    const int centre = centreBinIdx_[i];
+                    const int end = endBinIdx_[i];
+                    const int nUpper = end - centre;
+                    const int tailEnd = tailEndBinIdx_[i];
+                    const int first = startBinIdx_[i * nLevels_ + nLevels_ - 1];
+                    const Real tailWeight = roexTable_[roexIdxLimit_];
+
+                    for (int frame = 0; frame < nFrames; ++frame)
                     {
-                        //normalised deviation
-                        g = (input.getCentreFreq(j) - fc_[i]) / fc_[i];
-
-                        if (g > 2)
-                            break;
-                        if (g < 0) //lower skirt - level dependent
+                        const Real* levelFactor = levelFactor_[frame].data();
+                        const Real* inputPowerSpectrum = inputPowerSpectra_[frame];
+                        const Real* cumulativePower = cumulativePower_[frame].data();
+                        int start = startBinIdx_[i * nLevels_ + levelIdx_[frame]];
+
+                        //components clamped to the end of the table
+                        Real excitationLin = tailWeight *
+                                             (cumulativePower[start] +
+                                              cumulativePower[tailEnd] -
+                                              cumulativePower[end]);
+
+                        //lower skirt - level dependent
+                        if (isLevelQuantised_)
                         {
-                            //Complete Eq (3)
-                            p = pu_[i] - (pl_[i] * compLevel_[j]); //51dB subtracted above
-                            p = max(p, 0.1); //p can go negative for very high levels
-                            pg = -p * g; //p * abs (g)
+                            const int* componentLevelIdx =
+                                componentLevelIdx_[frame].data();
+                            const Real* weights = lowerSkirtWeights_[i].data();
+                            for (int j = start; j < centre; ++j)
+                            {
+                                excitationLin += weights[(j - first) * nLevels_ +
+                                                         componentLevelIdx[j]] *
+                                                 inputPowerSpectrum[j];
+                            }
                         }
-                        else //upper skirt
+                        else
                         {
-                            pg = pu_[i] * g; //p * abs(g)
+                            for (int j = start; j < centre; ++j)
+                            {
+                                //p can go negative for very high levels
+                                Real pg = max (levelFactor[j], minLevelFactor) *
+                                          lowerSkirtPg[j];
+                                int idx = min ((int)(pg + 0.5), roexIdxLimit_);
+                                excitationLin += roexTable_[idx] *
+                                                 inputPowerSpectrum[j];
+                            }
                         }
-                        
-                        //excitation
-                        idx = (int)(pg / step_ + 0.5);
-                        idx = min (idx, roexIdxLimit_);
-                        excitationLin += roexTable_[idx] * inputPowerSpectrum[j++]; 
+
+                        //upper skirt
+                        const Real* upperInput = inputPowerSpectrum + centre;
+                        for (int j = 0; j < nUpper; ++j)
+                            excitationLin += upperSkirtWeights[j] * upperInput[j];
+
+                        excitationLin_[frame] = excitationLin;
                     }
 
                     //excitation level
-                    if (isExcitationPatternInterpolated_)
-                        excitationLevel_[i] = log (excitationLin + 1e-10);
-                    else
-                        outputExcitationPattern[i] = excitationLin;
+                    for (int frame = 0; frame < nFrames; ++frame)
+                    {
+                        if (isExcitationPatternInterpolated_)
+                        {
+                            excitationLevel_[frame][i] = log (excitationLin_[frame] + 1e-10);
+                        }
+                        else
+                        {
+                            outputs[frame].getSingleSampleWritePointer
+                                (src, ear, 0)[i] = excitationLin_[frame];
+                        }
+                    }
                 }
 
                 /*
@@ -252,13 +491,15 @@ namespace loudness{
                  */
                 if (isExcitationPatternInterpolated_)
                 {
-                    spline_.set_points (cams_,
-                            excitationLevel_,
-                            isInterpolationCubic_);
-                    for (int i = 0; i < 372; ++i)
+                    for (int frame = 0; frame < nFrames; ++frame)
                     {
-                        excitationLin = exp (spline_ (1.8 + i * 0.1));
-                        outputExcitationPattern[i] = excitationLin;
+                        Real* outputExcitationPattern = outputs[frame]
+                                                        .getSingleSampleWritePointer
+                                                        (src, ear, 0);
+                        interpolator_.process (excitationLevel_[frame].data(),
+                                               outputExcitationPattern);
+                        for (int i = 0; i < 372; ++i)
+                            outputExcitationPattern[i] = exp (outputExcitationPattern[i]);
                     }
                 }
             }
@@ -21,7 +21,7 @@
 #define FASTROEXBANK_H
 
 #include "../support/Module.h"
-#include "../thirdParty/spline/Spline.h"
+#include "../support/SplineInterpolator.h"
 
 namespace loudness{
 
@@ -36,7 +36,15 @@ namespace loudness{
      * 38.9.
      *
      * A lookup table is employed for the computing the rounded exponential
-     * filter.
+     * filter. Weights beyond the end of the table (pg > 20.46, i.e. below
+     * -75 dB) are clamped to its last entry. These components are summed once
+     * per frame and weighted together, so each filter only loops over the
+     * components within reach of the table. The upper skirt weights are
+     * precomputed. For the level dependent lower skirt, p * |g| is factored
+     * into a per component level term and a per filter term, and the first
+     * component within reach of each filter is tabulated against the largest
+     * level per ERB of the frame, quantised in steps of
+     * setLevelStepInDecibels().
      *
      * Cubinc spline interpolated can be applied to yield a 0.1 Cam resolution
      * excitation pattern.
@@ -70,6 +78,25 @@ namespace loudness{
 
         virtual ~FastRoexBank();
 
+        /** Sets the level step (in dB) of the tables holding the lower skirt
+         * support of each filter. Levels are rounded up, so coarser steps give
+         * smaller tables but longer supports. The default is 1 dB. Unless
+         * setLevelQuantised() is used, this does not change the output. */
+        void setLevelStepInDecibels(Real levelStepInDecibels);
+
+        /**
+         * @brief Set true to look up the lower skirt weights in tables
+         * indexed by the level per ERB of each component, rounded to the
+         * nearest level step.
+         *
+         * This saves computing a table index for every weight but changes the
+         * output by rounding the levels. The tables of each filter hold one
+         * weight per component and level step, megabytes in total at 1 dB,
+         * so the lookups are usually slower than computing the index from a
+         * spectrum of 1025 components. The default is false.
+         */
+        void setLevelQuantised(bool isLevelQuantised);
+
     private:
 
         virtual bool initializeInternal(const SignalBank &input);
@@ -77,16 +104,28 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
+        virtual void processBlockInternal(const SignalBank* inputs, int nInputs);
 
+        void processFrames(const SignalBank* inputs, SignalBank* outputs,
+                int nFrames);
         void generateRoexTable(int size = 1024);
+        void configureFilterSupport(const SignalBank &input);
+        Real quantisedLevelFactor(int filter, int level) const;
 
-        Real camStep_;
+        Real camStep_, levelStepInDecibels_;
         bool isExcitationPatternInterpolated_, isInterpolationCubic_;
-        int nFilters_, roexIdxLimit_;
-        Real step_;
-        vector<vector<int> > rectBinIndices_;
-        RealVec cams_, pu_, pl_, fc_, compLevel_, roexTable_, excitationLevel_;
-        spline spline_;
+        bool isLevelQuantised_;
+        int nFilters_, roexIdxLimit_, nLevels_;
+        Real step_, levelSlope_, minCompLevel_;
+        vector<vector<int> > rectBinIndices_, componentLevelIdx_;
+        vector<int> centreBinIdx_, endBinIdx_, tailEndBinIdx_, startBinIdx_;
+        vector<int> levelIdx_;
+        RealVec cams_, pu_, minLevelFactor_, fc_, roexTable_, excitationLin_;
+        RealVecVec levelFactor_, excitationLevel_, lowerSkirtPg_, upperSkirtWeights_;
+        RealVecVec lowerSkirtWeights_, cumulativePower_;
+        vector<const Real*> inputPowerSpectra_;
+        SplineInterpolator interpolator_;
     };
 }
 
@@ -31,12 +31,18 @@ namespace loudness{
         camLo_ (camLo),
         camHi_ (camHi),
         camStep_ (camStep),
-        level_ (level)
+        level_ (level),
+        weightTolerance_ (1e-12)
     {}
 
     FixedRoexBank::~FixedRoexBank()
     {}
 
+    void FixedRoexBank::setWeightTolerance(Real weightTolerance)
+    {
+        weightTolerance_ = weightTolerance;
+    }
+
     bool FixedRoexBank::initializeInternal(const SignalBank &input)
     {
 
@@ -57,10 +63,13 @@ namespace loudness{
         const Real p51_1k = 4000.0 / centreFreqToCambridgeERB(1000.0);
 
         //filter shapes
-        roex_.resize(nFilters);
+        roex_.initialize(nFilters, input.getNChannels());
+        inputSpectra_.resize(blockSize_);
+        outputExcitationPatterns_.resize(blockSize_);
 
         //fill the above arrays
         Real cam, erb, fc, p, pu, t2, g, pg;
+        RealVec roex;
         for (int chn = 0; chn < nFilters; ++chn)
         {
             cam = camLo_ + camStep_ * chn;
@@ -72,6 +81,7 @@ namespace loudness{
 
             t2 = 0.35 * (pu / p51_1k);
 
+            roex.clear();
             int j = 0;
             while (j < input.getNChannels())
             {
@@ -91,12 +101,15 @@ namespace loudness{
                     }
 
                     //roex magnitude response
-                    roex_[chn].push_back ((1.0 + pg) * std::exp (-pg));
+                    roex.push_back ((1.0 + pg) * std::exp (-pg));
                 }
                 else
                     break;
                 j++;
             }
+
+            //keep the non-negligible weights only
+            roex_.setRow (roex, 0, weightTolerance_);
         }
 
         return 1;
@@ -105,25 +118,45 @@ namespace loudness{
 
     void FixedRoexBank::processInternal(const SignalBank &input)
     {
-        for (int src = 0; src < input.getNSources(); ++src)
+        processFrames(&input, &output_, 1);
+    }
+
+    void FixedRoexBank::processBlockInternal(const SignalBank* inputs,
+                                             int nInputs)
+    {
+        if (!isBlockTriggered(inputs, nInputs))
         {
-            for (int ear = 0; ear < input.getNEars(); ++ear)
+            Module::processBlockInternal(inputs, nInputs);
+            return;
+        }
+
+        processFrames(inputs, outputBlock_.data(), nInputs);
+        for (int i = 0; i < nInputs; ++i)
+            outputBlock_[i].setTrig(true);
+    }
+
+    void FixedRoexBank::processFrames(const SignalBank* inputs,
+                                      SignalBank* outputs,
+                                      int nFrames)
+    {
+        for (int src = 0; src < inputs[0].getNSources(); ++src)
+        {
+            for (int ear = 0; ear < inputs[0].getNEars(); ++ear)
             {
-                for (int chn = 0; chn < output_.getNChannels(); ++chn)
+                for (int frame = 0; frame < nFrames; ++frame)
                 {
-                    const Real* inputSpectrum = input.
-                                                getSingleSampleReadPointer 
-                                                (src, ear, 0);
-                    Real* outputExcitationPattern = output_.
-                                                    getSingleSampleWritePointer
-                                                    (src, ear, 0);
-                    Real excitationLin = 0.0;
-
-                    for (unsigned int j = 0; j < roex_[chn].size(); ++j)
-                        excitationLin += roex_[chn][j] * inputSpectrum[j];
-
-                    outputExcitationPattern[chn] = excitationLin;
+                    inputSpectra_[frame] = inputs[frame].
+                                           getSingleSampleReadPointer 
+                                           (src, ear, 0);
+                    outputExcitationPatterns_[frame] = outputs[frame].
+                                                       getSingleSampleWritePointer
+                                                       (src, ear, 0);
                 }
+
+                //each filter is applied to all frames before moving on
+                roex_.multiply (inputSpectra_.data(),
+                                outputExcitationPatterns_.data(),
+                                nFrames);
             }
         }
     }
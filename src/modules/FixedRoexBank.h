@@ -21,6 +21,7 @@
 #define FIXEDROEXBANK_H
 
 #include "../support/Module.h"
+#include "../support/SparseMatrix.h"
 
 namespace loudness{
 
@@ -35,15 +36,28 @@ namespace loudness{
 
         virtual ~FixedRoexBank();
 
+        /**
+         * @brief Sets the magnitude below which filter weights are treated
+         * as zero (default is 1e-12). Takes effect on initialisation.
+         */
+        void setWeightTolerance(Real weightTolerance);
+
     private:
         virtual bool initializeInternal(const SignalBank &input);
         virtual bool initializeInternal(){return 0;};
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
+        virtual void processBlockInternal(const SignalBank* inputs, int nInputs);
+
+        void processFrames(const SignalBank* inputs, SignalBank* outputs,
+                int nFrames);
 
-        Real camLo_, camHi_, camStep_, level_;
-        RealVecVec roex_;
+        Real camLo_, camHi_, camStep_, level_, weightTolerance_;
+        SparseMatrix roex_;
+        vector<const Real*> inputSpectra_;
+        vector<Real*> outputExcitationPatterns_;
     };
 }
 
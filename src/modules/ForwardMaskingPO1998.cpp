@@ -18,6 +18,7 @@
  */
 
 #include "ForwardMaskingPO1998.h"
+#include "../support/DenormalGuard.h"
 
 namespace loudness{
 
@@ -38,29 +39,27 @@ namespace loudness{
 
     bool ForwardMaskingPO1998::initializeInternal(const SignalBank &input)
     {
-        Real weight2 = 1 - weight_;
-        Real alpha1 = std::exp (-1.0 / (timeConstant1_ * input.getFrameRate()));
-        Real alpha2 = std::exp (-1.0 / (timeConstant2_ * input.getFrameRate()));
+        double weight2 = 1 - weight_;
+        double alpha1 = std::exp (-1.0 / (timeConstant1_ * input.getFrameRate()));
+        double alpha2 = std::exp (-1.0 / (timeConstant2_ * input.getFrameRate()));
 
         // coefs for  n-1
-        RealVec bCoefs = {-(weight2 * alpha2 + weight_ * alpha1)};
+        vector<double> bCoefs = {-(weight2 * alpha2 + weight_ * alpha1)};
         // coefs for n, n-1 and n-2
-        RealVec aCoefs = {1.0, -alpha1 - alpha2, alpha1 * alpha2};
+        vector<double> aCoefs = {1.0, -alpha1 - alpha2, alpha1 * alpha2};
 
         aCoefs[0] = 1.0 / ((1 - weight_) * timeConstant1_ + 
                     weight_ * timeConstant2_);
         aCoefs[0] /= input.getFrameRate();
 
-        setBCoefs (bCoefs);
-        setACoefs (aCoefs);
+        setBCoefs (RealVec(bCoefs.begin(), bCoefs.end()));
+        setACoefs (RealVec(aCoefs.begin(), aCoefs.end()));
 
-        delayLine_.initialize (
-                input.getNSources(),
-                input.getNEars(),
-                input.getNChannels(),
-                2,
-                input.getFs());
-                    
+        //a single section with output gain aCoefs[0]
+        sections_.setSections ({1.0, bCoefs[0], 0.0,
+                                1.0, aCoefs[1], aCoefs[2]});
+        sections_.setGain (aCoefs[0]);
+        sections_.initialize (input);
 
         //output SignalBank
         output_.initialize(input);
@@ -70,49 +69,12 @@ namespace loudness{
 
     void ForwardMaskingPO1998::processInternal(const SignalBank &input)
     {       
-        for (int src = 0; src < input.getNSources(); ++src)
-        {
-            for(int ear = 0; ear < input.getNEars(); ++ear)
-            {
-                for (int chn = 0; chn < input.getNChannels(); ++chn)
-                {
-                    const Real* inputSignal = input.getSignalReadPointer
-                                              (src, ear, chn);
-                    Real* outputSignal = output_.getSignalWritePointer
-                                         (src, ear, chn);
-                    Real* z = delayLine_.getSignalWritePointer
-                                         (src, ear, chn);
-
-                    for (int smp = 0; smp < input.getNSamples(); ++smp)
-                    {
-                        //input sample
-                        Real x = inputSignal[smp];
-
-                        //output sample
-                        outputSignal[smp] = x + z[0];
-
-                        // b[n-1] ...
-                        z[0] = bCoefs_[0] * x + z[1];
-                        z[1] = 0.0;
-
-                        // a[n-1] ...
-                        z[0] -= aCoefs_[1] * outputSignal[smp];
-
-                        // a[n-2] ...
-                        z[1] -= aCoefs_[2] * outputSignal[smp];
-                        
-                        outputSignal[smp] *= aCoefs_[0];
-                            
-                    }
-
-                    killDenormal (z[0]);
-                    killDenormal (z[1]);
-                }
-            }
-        }
+        DenormalGuard denormalGuard;
+        sections_.process (input, output_);
     }
 
-    //output SignalBanks are cleared so not to worry about filter state
     void ForwardMaskingPO1998::resetInternal()
-    {}
+    {
+        sections_.reset();
+    }
 }
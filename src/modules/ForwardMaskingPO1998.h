@@ -21,6 +21,7 @@
 #define FORWARDMASKINGPO1998_H
 
 #include "../support/Filter.h"
+#include "../support/SecondOrderSections.h"
 
 namespace loudness{
 
@@ -42,6 +43,7 @@ namespace loudness{
             virtual void resetInternal();
 
             Real timeConstant1_, timeConstant2_, weight_;
+            SecondOrderSections sections_;
     };
 }
 
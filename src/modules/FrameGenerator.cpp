@@ -70,6 +70,7 @@ namespace loudness{
             writeIdx_ = 0;
 
         remainingSamples_ = 0;
+        ringOffset_ = 0;
         overlap_ = frameSize_ - hopSize_;
 
         //initialise the output signal
@@ -84,20 +85,82 @@ namespace loudness{
         return 1;
     }
 
+    bool FrameGenerator::targetsReadRingBuffers() const
+    {
+        //without targets the output is read by the caller
+        if (targetModules_.empty())
+            return false;
+
+        for (uint i = 0; i < targetModules_.size(); ++i)
+        {
+            if (!targetModules_[i] -> readsRingBuffers())
+                return false;
+        }
+        return true;
+    }
+
+    void FrameGenerator::linearizeFrame()
+    {
+        if (ringOffset_)
+        {
+            for (int src = 0; src < output_.getNSources(); ++src)
+            {
+                for (int ear = 0; ear < output_.getNEars(); ++ear)
+                {
+                    for (int chn = 0; chn < output_.getNChannels(); ++chn)
+                    {
+                        Real* frame = output_.getSignalWritePointer(src, ear, chn);
+                        std::rotate(frame, frame + ringOffset_, frame + frameSize_);
+                    }
+                }
+            }
+            ringOffset_ = 0;
+            output_.setRingOffset(0);
+        }
+    }
+
+    void FrameGenerator::writeSamples(const SignalBank &input,
+                                      int readIdx,
+                                      int nSamples)
+    {
+        //position of writeIdx_ in the circular buffer
+        int bufferIdx = (ringOffset_ + writeIdx_) % frameSize_;
+        int nSamplesToEnd = frameSize_ - bufferIdx;
+        if (nSamples <= nSamplesToEnd)
+        {
+            output_.copySamples(bufferIdx, input, readIdx, nSamples);
+        }
+        else
+        {
+            output_.copySamples(bufferIdx, input, readIdx, nSamplesToEnd);
+            output_.copySamples(0, input, readIdx + nSamplesToEnd,
+                                nSamples - nSamplesToEnd);
+        }
+        writeIdx_ += nSamples;
+    }
+
     void FrameGenerator::processInternal(const SignalBank &input)
     {
-        //pull all signals back by hop samples
+        //move on by hop samples
         if(writeIdx_ == frameSize_)
         {
-            output_.pullBack(hopSize_);
+            if (!isOutputAggregated_ && targetsReadRingBuffers())
+            {
+                //the oldest hopSize_ samples are overwritten by new ones
+                ringOffset_ = (ringOffset_ + hopSize_) % frameSize_;
+            }
+            else
+            {
+                linearizeFrame();
+                output_.pullBack(hopSize_);
+            }
             writeIdx_ = overlap_;
         }
 
         //copy to output (input buf can't be < than hopSize_ so safe)
         if(remainingSamples_)
         {
-            output_.copySamples(writeIdx_, audioBufferBank_, 0, remainingSamples_);
-            writeIdx_ += remainingSamples_;
+            writeSamples(audioBufferBank_, 0, remainingSamples_);
             remainingSamples_ = 0;
         }
 
@@ -109,8 +172,7 @@ namespace loudness{
         else
             remainingSamples_ = nSamples - nSamplesToFill;
 
-        output_.copySamples(writeIdx_, input, 0, nSamplesToFill);
-        writeIdx_ += nSamplesToFill;
+        writeSamples(input, 0, nSamplesToFill);
 
         //if samples remaining store them
         if(remainingSamples_)
@@ -119,6 +181,8 @@ namespace loudness{
             audioBufferBank_.copySamples(0, input, readIdx, remainingSamples_);
         }
 
+        output_.setRingOffset(ringOffset_);
+
         //if frames worth -> output
         if(writeIdx_ == frameSize_)
             output_.setTrig(true);
@@ -134,6 +198,7 @@ namespace loudness{
             writeIdx_ = 0;
 
         remainingSamples_ = 0;
+        ringOffset_ = 0;
         audioBufferBank_.zeroSignals();
         output_.setTrig(false);
     }
@@ -38,6 +38,12 @@ namespace loudness{
      *
      * FrameGenerator can generate frames for signals in the inputSignalBank,
      * and so multiple ear/channel processing is supported.
+     *
+     * The frame is held in a circular buffer. If the module has targets,
+     * all of which read ring buffers (see Module::readsRingBuffers()), and
+     * the output is not aggregated, a hop only advances the ring offset of
+     * the output SignalBank, so no samples are moved. Otherwise the frame is
+     * linearised and pulled back by the hop size as before.
      */
     class FrameGenerator : public Module
     {
@@ -78,8 +84,12 @@ namespace loudness{
         virtual void processInternal(){};
         virtual void resetInternal();
 
+        bool targetsReadRingBuffers() const;
+        void linearizeFrame();
+        void writeSamples(const SignalBank &input, int readIdx, int nSamples);
+
         int frameSize_, hopSize_, audioBufferSize_, inputBufferSize_;
-        int writeIdx_, overlap_, remainingSamples_;
+        int writeIdx_, overlap_, remainingSamples_, ringOffset_;
         bool startAtCentreOfFrame_;
         SignalBank audioBufferBank_;
     };
@@ -1,7 +1,48 @@
 #include "HoppingGoertzelDFT.h"
+#include "../support/AuditoryTools.h"
 
 namespace loudness{
-    
+
+    /*
+     * Runs the resonators [kBegin, kEnd) over nSamples comb filter outputs:
+     * v[n] = comb[n] + 2cos(phi) v[n-1] - v[n-2].
+     *
+     * The resonators are independent, so the loop over them is vectorised.
+     * Each pass advances every resonator by four samples while its state is
+     * held in registers, reducing the loads and stores per sample.
+     */
+    static inline void processResonators(const Real* comb, int nSamples,
+            const Real* cosineTimes2, int kBegin, int kEnd,
+            Real* vPrev, Real* vPrev2)
+    {
+        int smp = 0;
+        for (; smp + 3 < nSamples; smp += 4)
+        {
+            Real comb0 = comb[smp], comb1 = comb[smp + 1];
+            Real comb2 = comb[smp + 2], comb3 = comb[smp + 3];
+            for (int k = kBegin; k < kEnd; ++k)
+            {
+                Real c = cosineTimes2[k];
+                Real v1 = vPrev[k], v2 = vPrev2[k];
+                Real v3 = comb0 + c * v1 - v2;
+                Real v4 = comb1 + c * v3 - v1;
+                Real v5 = comb2 + c * v4 - v3;
+                Real v6 = comb3 + c * v5 - v4;
+                vPrev2[k] = v5;
+                vPrev[k] = v6;
+            }
+        }
+        for (; smp < nSamples; ++smp)
+        {
+            for (int k = kBegin; k < kEnd; ++k)
+            {
+                Real v = comb[smp] + cosineTimes2[k] * vPrev[k] - vPrev2[k];
+                vPrev2[k] = vPrev[k];
+                vPrev[k] = v;
+            }
+        }
+    }
+
     HoppingGoertzelDFT::HoppingGoertzelDFT(const RealVec& frequencyBandEdges,
                 const vector<int>& windowSizes,
                 int hopSize,
@@ -14,69 +55,171 @@ namespace loudness{
             isHannWindowUsed_ (isHannWindowUsed),
             isPowerSpectrum_ (isPowerSpectrum),
             isFirstSampleAtWindowCentre_ (true),
-            referenceValue_ (2e-5)
+            referenceValue_ (2e-5),
+            targetSpacingInCams_ (0.0)
     {}
 
     HoppingGoertzelDFT::~HoppingGoertzelDFT() {}
 
+    /*
+     * Finds a window size for which the centre of a group of groupSize bins
+     * of a windowSize-point DFT, starting at bin firstBin, falls on a bin.
+     * The window is groupSize times shorter, so the bandwidth of that bin
+     * spans the group. Returns false if the bin is too close to DC or the
+     * highest positive frequency, or the window exceeds maxWindowSize.
+     */
+    static bool findTargetWindow(int firstBin, int groupSize, int windowSize,
+            int maxWindowSize, int minBin, int& targetWindowSize,
+            int& targetBin)
+    {
+        Real centreBin = firstBin + 0.5 * (groupSize - 1);
+        targetBin = std::max (minBin, (int)round (centreBin / groupSize));
+        // even, so the window centre is aligned with the others
+        targetWindowSize = 2 * (int)round (0.5 * targetBin * windowSize / centreBin);
+        return (targetWindowSize <= maxWindowSize) &&
+               (targetBin + minBin <= targetWindowSize / 2);
+    }
+
     bool HoppingGoertzelDFT::initializeInternal(const SignalBank &input)
     {   
         // Sampling frequency
         int fs = input.getFs();
 
-        nWindows_ = windowSizes_.size();
-        // bin indices of components at the band edges
-        vector< vector<int>> bandEdgeIdx (nWindows_, vector<int> (2, 0));
-        largestWindowSize_ = 0;
-        int nBins = 0, nAdditionalBins = 0;
-        for (int w = 0; w < nWindows_; ++w)
+        int nBands = windowSizes_.size();
+        largestWindowSize_ = *std::max_element (windowSizes_.begin(),
+                                                windowSizes_.end());
+
+        // window size and bin index of each output component
+        vector< std::pair<int, int> > components;
+        int nTargets = 0;
+        for (int w = 0; w < nBands; ++w)
         {
             // These are NOT the nearest components but satisfies f_k in [f_lo, f_hi)
-            bandEdgeIdx[w][0] = std::ceil (frequencyBandEdges_[w] * windowSizes_[w] / fs);
-            // use < bandEdgeIdx[w][1] to exclude f_hi
-            bandEdgeIdx[w][1] = std::ceil (frequencyBandEdges_[w + 1] * windowSizes_[w] / fs);
+            int loBin = std::ceil (frequencyBandEdges_[w] * windowSizes_[w] / fs);
+            // use < hiBin to exclude f_hi
+            int hiBin = std::ceil (frequencyBandEdges_[w + 1] * windowSizes_[w] / fs);
 
             LOUDNESS_DEBUG(name_ 
-                    << ": LoFreq: " << bandEdgeIdx[w][0] * fs / (Real)windowSizes_[w]
-                    << ": HiFreq: " << (bandEdgeIdx[w][1] - 1) * fs / (Real)windowSizes_[w]);
+                    << ": LoFreq: " << loBin * fs / (Real)windowSizes_[w]
+                    << ": HiFreq: " << (hiBin - 1) * fs / (Real)windowSizes_[w]);
 
             int highestBin = windowSizes_[w] / 2;
 
-            LOUDNESS_ASSERT(bandEdgeIdx[w][1] != 0, ": No components found in band number ");
-            LOUDNESS_ASSERT(bandEdgeIdx[w][1] >= bandEdgeIdx[w][0],
+            LOUDNESS_ASSERT(hiBin != 0, ": No components found in band number ");
+            LOUDNESS_ASSERT(hiBin >= loBin,
                 ": upper band edge is not > lower band edge!");
-            LOUDNESS_ASSERT(bandEdgeIdx[w][1] <= highestBin,
+            LOUDNESS_ASSERT(hiBin <= highestBin,
                     ": upper band edge is > highest positive frequency.");
 
-            nBins += bandEdgeIdx[w][1] - bandEdgeIdx[w][0];
-            if (windowSizes_[w] > largestWindowSize_)
-                largestWindowSize_ = windowSizes_[w];
-
             // windowing constraints
             if (isHannWindowUsed_)
             {
-                if (bandEdgeIdx[w][0] == 0)
+                if (loBin == 0)
                 {
                     LOUDNESS_ERROR (name_ 
                             << ": This implementation does not support windowing with DC.");
                     return 0;
                 }
-                if (bandEdgeIdx[w][1] == highestBin)
+                if (hiBin == highestBin)
                 {
                     LOUDNESS_ERROR (name_
                             << ": This implementation does not support windowing with the highest positive frequency.");
                     return 0;
                 }
-                bandEdgeIdx[w][0] -= 1;
-                bandEdgeIdx[w][1] += 1;
-                nAdditionalBins += 2;
             }
+
+            /*
+             * Where the bins are closer than the target spacing, a group of
+             * bins is replaced by a single bin of a shorter window centred
+             * on the group.
+             */
+            int bin = loBin;
+            while (bin < hiBin)
+            {
+                int groupSize = 1;
+                if (targetSpacingInCams_ > 0)
+                {
+                    Real camStep = hertzToCam ((bin + 1) * fs / (Real)windowSizes_[w])
+                                   - hertzToCam (bin * fs / (Real)windowSizes_[w]);
+                    groupSize = std::min (hiBin - bin,
+                                          (int)std::floor (targetSpacingInCams_ / camStep));
+                }
+
+                int targetWindowSize, targetBin;
+                if ((groupSize > 1) &&
+                    findTargetWindow (bin, groupSize, windowSizes_[w],
+                        largestWindowSize_, isHannWindowUsed_ ? 2 : 1,
+                        targetWindowSize, targetBin))
+                {
+                    components.push_back (std::make_pair (targetWindowSize,
+                                                          targetBin));
+                    bin += groupSize;
+                    nTargets++;
+                }
+                else
+                {
+                    components.push_back (std::make_pair (windowSizes_[w], bin));
+                    bin++;
+                }
+            }
+        }
+
+        /*
+         * Resonators, one per bin and window size, sharing one comb filter
+         * per window size. The Hann window is applied in the frequency
+         * domain, so neighbouring bins are also required.
+         */
+        map<int, map<int, int> > resonatorIdx;
+        for (const auto& component : components)
+        {
+            map<int, int>& bins = resonatorIdx[component.first];
+            bins[component.second] = 0;
+            if (isHannWindowUsed_)
+            {
+                bins[component.second - 1] = 0;
+                bins[component.second + 1] = 0;
+            }
+        }
+
+        // longest window first
+        nCombs_ = resonatorIdx.size();
+        combSizes_.clear();
+        binIdxForGoertzels_.assign (nCombs_, vector<int> (2, 0));
+        sine_.clear();
+        cosineTimes2_.clear();
+        int c = 0, k = 0;
+        for (auto comb = resonatorIdx.rbegin(); comb != resonatorIdx.rend(); ++comb, ++c)
+        {
+            combSizes_.push_back (comb -> first);
+            binIdxForGoertzels_[c][0] = k;
+            for (auto& bin : comb -> second)
+            {
+                bin.second = k++;
+
+                // filter coefficients
+                Real phi = 2.0 * PI * bin.first / (Real)comb -> first;
+                sine_.push_back (std::sin (phi));
+                cosineTimes2_.push_back (2.0 * std::cos (phi));
+
+                LOUDNESS_DEBUG(name_ 
+                        << "k: " << bin.second
+                        << "phi: "
+                        << phi
+                        << "sine: "
+                        << sine_.back() 
+                        << ", cos2: " 
+                        << cosineTimes2_.back());
+            }
+            binIdxForGoertzels_[c][1] = k;
         }
 
-        int nTotalBins = nBins + nAdditionalBins;
+        int nBins = components.size();
+        int nTotalBins = k;
         LOUDNESS_DEBUG (name_ 
                 << ": Total number of bins comprising the output spectrum: " 
                 << nBins
+                << ": Number of target bins: "
+                << nTargets
                 << ": Total number of bins used by this algorithm: "
                 << nTotalBins);
 
@@ -89,18 +232,19 @@ namespace loudness{
 
         LOUDNESS_DEBUG(name_ << ": delay line size: " << delayLineSize_);
 
+        // the delay line is stored twice in a row, so that any run of up to
+        // delayLineSize_ samples can be read without wrapping
         delayLine_.initialize (input.getNSources(),
                                input.getNEars(),
                                input.getNChannels(),
-                               delayLineSize_,
+                               2 * delayLineSize_,
                                input.getFs());
-        // read points for time n and n - windowSizes_[w]
-        readIdx_.assign (nWindows_, vector<int> (2, 0));
+        comb_.assign (blockSize, 0.0);
+        // read points for time n and n - combSizes_[c]
+        readIdx_.assign (nCombs_, vector<int> (2, 0));
         configureDelayLineIndices();
 
         // Goertzel filter variables
-        sine_.assign (nTotalBins, 0.0);
-        cosineTimes2_.assign (nTotalBins, 0.0);
         vPrev_.initialize (input.getNSources(),
                            input.getNEars(),
                            nTotalBins,
@@ -113,73 +257,34 @@ namespace loudness{
                             1,
                             fs);
 
-        binIdxForGoertzels_.assign (nWindows_, vector<int> (2, 0));
-
         // output bank
-        if (isPowerSpectrum_)
-        {
-            output_.initialize (input.getNSources(),
-                                input.getNEars(),
-                                nBins,
-                                1,
-                                fs);
-            normFactors_.assign (nWindows_, 1.0);
-        }
-        else
-        {
-            output_.initialize (input.getNSources(),
-                                input.getNEars(),
-                                nBins,
-                                2,
-                                fs);
-        }
+        output_.initialize (input.getNSources(),
+                            input.getNEars(),
+                            nBins,
+                            isPowerSpectrum_ ? 1 : 2,
+                            fs);
         output_.setFrameRate (fs / (Real)hopSize_);
         output_.setTrig (false);
 
-        // Complete arrays
-        int k = 0, k2 = 0;
-        for (int w = 0; w < nWindows_; ++w)
+        outputBinIdx_.assign (nBins, 0);
+        normFactors_.assign (nBins, 1.0);
+        for (int i = 0; i < nBins; ++i)
         {
-            std::cout << "window size[w] " << windowSizes_[w] << std::endl;
-            binIdxForGoertzels_[w][0] = k;
-            for (int j = bandEdgeIdx[w][0]; j < bandEdgeIdx[w][1]; ++j, ++k)
-            {
-                // bin frequency in Hz
-                if (isHannWindowUsed_)
-                {
-                    if ((j > bandEdgeIdx[w][0]) && (j < (bandEdgeIdx[w][1] - 1)))
-                        output_.setCentreFreq (k2++, j * fs / (Real)windowSizes_[w]);
-                }
-                else
-                    output_.setCentreFreq (k2++, j * fs / (Real)windowSizes_[w]);
+            int windowSize = components[i].first, bin = components[i].second;
+            outputBinIdx_[i] = resonatorIdx[windowSize][bin];
 
-                // filter coefficients
-                Real phi = 2.0 * PI * j / (Real)windowSizes_[w];
-                Real sinPhi = std::sin (phi);
-                Real cosPhi = std::cos (phi);
-                sine_[k] = sinPhi;
-                cosineTimes2_[k] = 2.0 * cosPhi;
+            // bin frequency in Hz
+            output_.setCentreFreq (i, bin * fs / (Real)windowSize);
 
-                LOUDNESS_DEBUG(name_ 
-                        << "k: " << k
-                        << "phi: "
-                        << phi
-                        << "sine: "
-                        << sine_[k] 
-                        << ", cos2: " 
-                        << cosineTimes2_[k]);
-            }
-            binIdxForGoertzels_[w][1] = k;
             if (isPowerSpectrum_)
             {
                 Real refSquared = referenceValue_ * referenceValue_;
-                Real windowSizeSquared = windowSizes_[w] * windowSizes_[w];
-                normFactors_[w] = 2.0 / (refSquared * windowSizeSquared);
+                Real windowSizeSquared = windowSize * windowSize;
+                normFactors_[i] = 2.0 / (refSquared * windowSizeSquared);
                 // 3/8 for hann window and 16 for gain introduced by
                 // selected hann coefficients
                 if (isHannWindowUsed_)
-                    normFactors_[w] /= 16.0 * 0.375;
-                LOUDNESS_DEBUG(name_ << "normFactor:" << normFactors_[w]);
+                    normFactors_[i] /= 16.0 * 0.375;
             }
         }
 
@@ -190,76 +295,61 @@ namespace loudness{
     {
         output_.setTrig (false);
 
-        int nSamplesToProcess = input.getNSamples();
-        int nRemainingSamples = nSamplesToProcess;
+        int nSamples = input.getNSamples();
 
-        // Write to the delay line
+        // Write to both copies of the delay line
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for (int ear = 0; ear < input.getNEars(); ++ear)
             {
                 const Real* x = input.getSignalReadPointer(src, ear, 0);
-                Real* delay = delayLine_.getSignalWritePointer
-                              (src, ear, 0, writeIdx_);
-                for (int smp = 0; smp < nSamplesToProcess; ++smp)
-                    delay[smp] = x[smp];
+                Real* delay = delayLine_.getSignalWritePointer(src, ear, 0);
+                std::copy (x, x + nSamples, delay + writeIdx_);
+                std::copy (x, x + nSamples, delay + writeIdx_ + delayLineSize_);
             }
         }
-        writeIdx_ = (writeIdx_ + nSamplesToProcess) % delayLineSize_;
-
-        // number of samples to process until DFT is ready
-        if (nSamplesUntilTrigger_ <= nRemainingSamples)
-            nSamplesToProcess = nSamplesUntilTrigger_;
+        writeIdx_ = (writeIdx_ + nSamples) % delayLineSize_;
 
-        // Goertzel resonators
+        // Goertzel resonators, up to the next trigger at a time
+        int nRemainingSamples = nSamples;
         while (nRemainingSamples)
         {
+            int nSamplesToProcess = std::min (nSamplesUntilTrigger_,
+                                              nRemainingSamples);
+
             for (int src = 0; src < input.getNSources(); ++src)
             {
                 for (int ear = 0; ear < input.getNEars(); ++ear)
                 {
-                    Real* delay = delayLine_.getSignalWritePointer
-                                  (src, ear, 0);
+                    const Real* delay = delayLine_.getSignalReadPointer
+                                        (src, ear, 0);
                     Real* vPrev = vPrev_.getSingleSampleWritePointer
                                   (src, ear, 0);
                     Real* vPrev2 = vPrev2_.getSingleSampleWritePointer
                                    (src, ear, 0);
 
-                    for (int w = 0; w < nWindows_; ++w)
+                    for (int c = 0; c < nCombs_; ++c)
                     {
-                        int idx1 = readIdx_[w][0];
-                        int idx2 = readIdx_[w][1];
-
+                        // comb filter x[n] - x[n - N]
+                        const Real* x = delay + readIdx_[c][0];
+                        const Real* xDelayed = delay + readIdx_[c][1];
                         for (int smp = 0; smp < nSamplesToProcess; ++smp)
-                        {
-                            Real comb = delay[idx1] - delay[idx2];
-                            ++idx1 = idx1 % delayLineSize_;
-                            ++idx2 = idx2 % delayLineSize_;
-
-                            // compute v[n] for each frequency
-                            for (int k = binIdxForGoertzels_[w][0]; k < binIdxForGoertzels_[w][1]; ++k)
-                            {
-                                Real v = comb + cosineTimes2_[k] * 
-                                         vPrev[k] - vPrev2[k];
-                                vPrev2[k] = vPrev[k];
-                                vPrev[k] = v;
-                            }
-                        }
-
-                        for (int k = binIdxForGoertzels_[w][0]; k < binIdxForGoertzels_[w][1]; ++k)
-                        {
-                            killDenormal (vPrev[k]);
-                            killDenormal (vPrev2[k]);
-                        }
+                            comb_[smp] = x[smp] - xDelayed[smp];
+
+                        processResonators (comb_.data(), nSamplesToProcess,
+                                cosineTimes2_.data(),
+                                binIdxForGoertzels_[c][0],
+                                binIdxForGoertzels_[c][1],
+                                vPrev, vPrev2);
                     }
                 }
             }
 
             // update delay indices
-            for (int w = 0; w < nWindows_; ++w)
+            for (int c = 0; c < nCombs_; ++c)
             {
-                readIdx_[w][0] = (readIdx_[w][0] + nSamplesToProcess) % delayLineSize_;
-                readIdx_[w][1] = (readIdx_[w][1] + nSamplesToProcess) % delayLineSize_;
+                readIdx_[c][0] = (readIdx_[c][0] + nSamplesToProcess) % delayLineSize_;
+                readIdx_[c][1] = (readIdx_[c][1] + nSamplesToProcess) % delayLineSize_;
             }
 
             nSamplesUntilTrigger_ -= nSamplesToProcess;
@@ -267,6 +357,8 @@ namespace loudness{
             // compute the complex-real multiplication
             if(nSamplesUntilTrigger_ == 0)
             {
+                killDenormals();
+
                 if (isHannWindowUsed_)
                 {
                     if (isPowerSpectrum_)
@@ -286,7 +378,23 @@ namespace loudness{
                 output_.setTrig (true);
             }
             nRemainingSamples -= nSamplesToProcess;
-            nSamplesToProcess = nRemainingSamples;
+        }
+    }
+
+    void HoppingGoertzelDFT::killDenormals()
+    {
+        for (int src = 0; src < vPrev_.getNSources(); ++src)
+        {
+            for (int ear = 0; ear < vPrev_.getNEars(); ++ear)
+            {
+                Real* vPrev = vPrev_.getSingleSampleWritePointer (src, ear, 0);
+                Real* vPrev2 = vPrev2_.getSingleSampleWritePointer (src, ear, 0);
+                for (int k = 0; k < vPrev_.getNChannels(); ++k)
+                {
+                    killDenormal (vPrev[k]);
+                    killDenormal (vPrev2[k]);
+                }
+            }
         }
     }
 
@@ -306,20 +414,20 @@ namespace loudness{
         else
             nSamplesUntilTrigger_ = largestWindowSize_;
 
-        for (int w = 0; w < nWindows_; ++w)
+        for (int c = 0; c < nCombs_; ++c)
         {
-            readIdx_[w][0] = (delayLineSize_ - 
-                    ((largestWindowSize_ - windowSizes_[w]) / 2)) %
+            readIdx_[c][0] = (delayLineSize_ - 
+                    ((largestWindowSize_ - combSizes_[c]) / 2)) %
                 delayLineSize_;
-            readIdx_[w][1] = (delayLineSize_ + readIdx_[w][0] - windowSizes_[w]) %
+            readIdx_[c][1] = (delayLineSize_ + readIdx_[c][0] - combSizes_[c]) %
                 delayLineSize_;
 
             LOUDNESS_DEBUG(name_ << ": window : "
-                    << w
+                    << c
                     << ", start idx: "
-                    << readIdx_[w][0]
+                    << readIdx_[c][0]
                     << ", end idx: "
-                    << readIdx_[w][1]);
+                    << readIdx_[c][1]);
         }
     }
 
@@ -327,15 +435,16 @@ namespace loudness{
     {
         for (int src = 0; src < output_.getNSources(); ++src)
         {
-            for (int ear = 0; ear < output_.getNSources(); ++ear)
+            for (int ear = 0; ear < output_.getNEars(); ++ear)
             {
-                const Real* vPrev = vPrev_.getSignalReadPointer(src, ear, 0);
+                const Real* vPrev = vPrev_.getSingleSampleReadPointer(src, ear, 0);
                 const Real* vPrev2 = vPrev2_.getSingleSampleReadPointer(src, ear, 0);
                 for (int chn = 0; chn < output_.getNChannels(); chn++)
                 {
+                    int k = outputBinIdx_[chn];
                     Real* y = output_.getSignalWritePointer(src, ear, chn);
-                    y[0] = 0.5 * cosineTimes2_[chn] * vPrev[chn] - vPrev2[chn];
-                    y[1] = sine_[chn] * vPrev[chn];	
+                    y[0] = 0.5 * cosineTimes2_[k] * vPrev[k] - vPrev2[k];
+                    y[1] = sine_[k] * vPrev[k];	
                 }
             }
         }
@@ -348,17 +457,14 @@ namespace loudness{
             for (int ear = 0; ear < output_.getNEars(); ++ear)
             {
                 Real* y = output_.getSingleSampleWritePointer (src, ear, 0);
-                const Real* vPrev = vPrev_.getSignalReadPointer(src, ear, 0);
+                const Real* vPrev = vPrev_.getSingleSampleReadPointer(src, ear, 0);
                 const Real* vPrev2 = vPrev2_.getSingleSampleReadPointer(src, ear, 0);
-                for (int w = 0; w < nWindows_; ++w)
+                for (int chn = 0; chn < output_.getNChannels(); chn++)
                 {
-                    for (int k = binIdxForGoertzels_[w][0]; k < binIdxForGoertzels_[w][1]; ++k)
-                    {
-                        Real real = 0.5 * cosineTimes2_[k] * (*vPrev)
-                                    - (*vPrev2++);
-                        Real imag = sine_[k] * (*vPrev++);	
-                        *(y++) = normFactors_[w] * (real * real + imag * imag);
-                    }
+                    int k = outputBinIdx_[chn];
+                    Real real = 0.5 * cosineTimes2_[k] * vPrev[k] - vPrev2[k];
+                    Real imag = sine_[k] * vPrev[k];	
+                    y[chn] = normFactors_[chn] * (real * real + imag * imag);
                 }
             }
         }
@@ -370,32 +476,21 @@ namespace loudness{
         {
             for (int ear = 0; ear < output_.getNEars(); ++ear)
             {
-                int chn = 0;
-                const Real* vPrev = vPrev_.getSignalReadPointer(src, ear, 0);
+                const Real* vPrev = vPrev_.getSingleSampleReadPointer(src, ear, 0);
                 const Real* vPrev2 = vPrev2_.getSingleSampleReadPointer(src, ear, 0);
-                for (int w = 0; w < nWindows_; ++w)
+                for (int chn = 0; chn < output_.getNChannels(); chn++)
                 {
-                    int i = 0;
-                    RealVec reals(3, 0.0), imags(3, 0.0);
-                    for (int k = binIdxForGoertzels_[w][0]; k < binIdxForGoertzels_[w][1]; ++k)
+                    Real reals[3], imags[3];
+                    for (int i = 0, k = outputBinIdx_[chn] - 1; i < 3; ++i, ++k)
                     { 
-                        reals[i] = 0.5 * cosineTimes2_[k] * (*vPrev)
-                                   - (*vPrev2++);
-                        imags[i++] = sine_[k] * (*vPrev++);	
-
-                        if (i == 3)
-                        {
-                            Real* y = output_.getSignalWritePointer(src, ear, chn++);
-                                         // X_k-1           X_k+1            X_k
-                            *y =     (-0.25*reals[0] - 0.25*reals[2] + 0.5 * reals[1]);
-                            *(++y) = (-0.25*imags[0] - 0.25*imags[2] + 0.5 * imags[1]);
-                            reals[0] = reals[1];
-                            reals[1] = reals[2];
-                            imags[0] = imags[1];
-                            imags[1] = imags[2];
-                            i = 2;
-                        }
+                        reals[i] = 0.5 * cosineTimes2_[k] * vPrev[k] - vPrev2[k];
+                        imags[i] = sine_[k] * vPrev[k];	
                     }
+
+                    Real* y = output_.getSignalWritePointer(src, ear, chn);
+                                 // X_k-1           X_k+1            X_k
+                    y[0] = (-0.25*reals[0] - 0.25*reals[2] + 0.5 * reals[1]);
+                    y[1] = (-0.25*imags[0] - 0.25*imags[2] + 0.5 * imags[1]);
                 }
             }
         }
@@ -408,31 +503,21 @@ namespace loudness{
             for (int ear = 0; ear < output_.getNEars(); ++ear)
             {
                 Real* y = output_.getSingleSampleWritePointer (src, ear, 0);
-                const Real* vPrev = vPrev_.getSignalReadPointer(src, ear, 0);
+                const Real* vPrev = vPrev_.getSingleSampleReadPointer(src, ear, 0);
                 const Real* vPrev2 = vPrev2_.getSingleSampleReadPointer(src, ear, 0);
-                for (int w = 0; w < nWindows_; ++w)
+                for (int chn = 0; chn < output_.getNChannels(); chn++)
                 {
-                    int i = 0;
-                    RealVec reals(3, 0.0), imags(3, 0.0);
-                    for (int k = binIdxForGoertzels_[w][0]; k < binIdxForGoertzels_[w][1]; ++k)
+                    Real reals[3], imags[3];
+                    for (int i = 0, k = outputBinIdx_[chn] - 1; i < 3; ++i, ++k)
                     { 
-                        reals[i] = 0.5 * cosineTimes2_[k] * (*vPrev)
-                                   - (*vPrev2++);
-                        imags[i++] = sine_[k] * (*vPrev++);	
-
-                        if (i == 3)
-                        {
-                                       // X_k-1      X_k+1            X_k
-                            Real real = (-reals[0] - reals[2] + 2.0 * reals[1]);
-                            Real imag = (-imags[0] - imags[2] + 2.0 * imags[1]);
-                            *y++ = normFactors_[w] * (real * real + imag * imag);
-                            reals[0] = reals[1];
-                            reals[1] = reals[2];
-                            imags[0] = imags[1];
-                            imags[1] = imags[2];
-                            i = 2;
-                        }
+                        reals[i] = 0.5 * cosineTimes2_[k] * vPrev[k] - vPrev2[k];
+                        imags[i] = sine_[k] * vPrev[k];	
                     }
+
+                               // X_k-1      X_k+1            X_k
+                    Real real = (-reals[0] - reals[2] + 2.0 * reals[1]);
+                    Real imag = (-imags[0] - imags[2] + 2.0 * imags[1]);
+                    y[chn] = normFactors_[chn] * (real * real + imag * imag);
                 }
             }
         }
@@ -443,6 +528,11 @@ namespace loudness{
         referenceValue_ = referenceValue;
     }
 
+    void HoppingGoertzelDFT::setTargetSpacingInCams (Real targetSpacingInCams)
+    {
+        targetSpacingInCams_ = targetSpacingInCams;
+    }
+
     void HoppingGoertzelDFT::setFirstSampleAtWindowCentre (bool isFirstSampleAtWindowCentre)
     {
         isFirstSampleAtWindowCentre_ = isFirstSampleAtWindowCentre;
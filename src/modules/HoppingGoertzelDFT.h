@@ -58,6 +58,22 @@ namespace loudness{
      *   squared). The default value is 2e-5 which corresponds to the common sound
      *   pressure reference of 20 micro pascals. Use setReferenceValue() to change
      *   this.
+     * - The delay line is stored twice in a row so the comb filter reads
+     *   contiguous samples, and the resonators of each band are updated
+     *   together, several samples at a time (vectorised across bins).
+     * - setTargetSpacingInCams() reduces the number of bins where they are
+     *   more closely spaced than the given Cam interval (typically at low
+     *   frequencies within a band). Each run of such bins is replaced by a
+     *   single bin centred on the run, taken from a window as many times
+     *   shorter as there are bins in the run, so that its bandwidth spans
+     *   the run. Since a sliding DFT can only compute integer bins, the
+     *   window length is adjusted so the bin falls on the centre frequency.
+     *   All bins sharing a window length share one comb filter. The
+     *   default (0) computes every bin. This pays off for long windows
+     *   spanning many Cams (e.g. 316 bins from 50 Hz to 5 kHz with a
+     *   2048-sample window at 32 kHz become 65 at 0.5 Cams), but the
+     *   multi-resolution windows of the dynamic loudness models already
+     *   space their bins at about a Cam, so those models compute every bin.
      *
      *
      * Note: This module probably does too much. However, implementing a module
@@ -83,6 +99,14 @@ namespace loudness{
         void setReferenceValue (Real referenceValue);
         void setFirstSampleAtWindowCentre (bool isFirstSampleAtWindowCentre);
 
+        /**
+         * @brief Sets the minimum spacing in Cams between output bins.
+         *
+         * Bins spaced more closely are combined as described above. The
+         * default value of 0 outputs all bins of each band.
+         */
+        void setTargetSpacingInCams (Real targetSpacingInCams);
+
     private:
         virtual bool initializeInternal(const SignalBank &input);
         virtual bool initializeInternal(){return 0;};
@@ -90,6 +114,8 @@ namespace loudness{
         virtual void processInternal(){};
         virtual void resetInternal();
         void configureDelayLineIndices();
+        /** Flushes tiny resonator states, once per hop. */
+        void killDenormals();
         void calculateSpectrum();
         void calculatePowerSpectrum();
         void calculateSpectrumAndApplyHannWindow();
@@ -99,11 +125,12 @@ namespace loudness{
         vector<int> windowSizes_;
         int hopSize_;
         bool isHannWindowUsed_, isPowerSpectrum_, isFirstSampleAtWindowCentre_;
-        Real referenceValue_;
+        Real referenceValue_, targetSpacingInCams_;
         int nSamplesUntilTrigger_, writeIdx_;
-        int nWindows_, delayLineSize_, largestWindowSize_;
+        int nCombs_, delayLineSize_, largestWindowSize_;
+        vector<int> combSizes_, outputBinIdx_;
         vector< vector<int>> binIdxForGoertzels_, readIdx_;
-        RealVec sine_, cosineTimes2_, normFactors_;
+        RealVec sine_, cosineTimes2_, normFactors_, comb_;
         SignalBank delayLine_, vPrev_, vPrev2_;
     };
 }
@@ -18,13 +18,18 @@
  */
 
 #include "IIR.h"
+#include "../support/DenormalGuard.h"
 
 namespace loudness{
 
-    IIR::IIR() : Module("IIR") {};
+    IIR::IIR() :
+        Module("IIR"),
+        isSecondOrderSectionsUsed_(false)
+    {};
 
     IIR::IIR(const RealVec &bCoefs, const RealVec &aCoefs) :
-        Module("IIR")
+        Module("IIR"),
+        isSecondOrderSectionsUsed_(false)
     {
         setBCoefs(bCoefs);
         setACoefs(aCoefs);
@@ -34,6 +39,11 @@ namespace loudness{
     {
     }
 
+    bool IIR::isSecondOrderSectionsUsed() const
+    {
+        return isSecondOrderSectionsUsed_;
+    }
+
     bool IIR::initializeInternal(const SignalBank &input)
     {
         //constants
@@ -48,22 +58,49 @@ namespace loudness{
             }
             else
             {
-                bCoefs_.resize(n_b,0);
+                bCoefs_.resize(n_a,0);
                 order_ = n_a-1;
             }
 
             LOUDNESS_DEBUG("IIR: Filter order is: " << order_);
             orderMinus1_ = order_-1;
 
+            if (aCoefs_[0] == 0.0)
+            {
+                LOUDNESS_ERROR(name_ << ": The first feedback coefficient"
+                        << " must be nonzero.");
+                return 0;
+            }
+
+            //cascade of second order sections for all signals, factored
+            //in double precision before the coefficients are normalised
+            vector<double> bCoefs(bCoefs_.begin(), bCoefs_.end());
+            vector<double> aCoefs(aCoefs_.begin(), aCoefs_.end());
+            isSecondOrderSectionsUsed_ = sections_.setTransferFunction(bCoefs,
+                                                                       aCoefs);
+
             //Normalise coefficients if a[0] != 1
             normaliseCoefs();
 
-            //internal delay line - single vector for all ears
-            delayLine_.initialize(input.getNSources(),
-                       input.getNEars(),
-                       input.getNChannels(),
-                       order_,
-                       input.getFs());
+            if (isSecondOrderSectionsUsed_)
+            {
+                sections_.initialize(input);
+                LOUDNESS_DEBUG(name_ << ": Number of second order sections: "
+                        << sections_.getNSections());
+            }
+            else
+            {
+                LOUDNESS_WARNING(name_ << ": Could not factor the transfer"
+                        << " function into second order sections,"
+                        << " using direct form 2.");
+
+                //internal delay line - single vector for all ears
+                delayLine_.initialize(input.getNSources(),
+                           input.getNEars(),
+                           input.getNChannels(),
+                           order_,
+                           input.getFs());
+            }
 
             //output SignalBank
             output_.initialize(input);
@@ -78,6 +115,13 @@ namespace loudness{
 
     void IIR::processInternal(const SignalBank &input)
     {
+        DenormalGuard denormalGuard;
+        if (isSecondOrderSectionsUsed_)
+        {
+            sections_.process(input, output_);
+            return;
+        }
+
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for(int ear = 0; ear < input.getNEars(); ++ear)
@@ -118,6 +162,9 @@ namespace loudness{
 
     void IIR::resetInternal()
     {
-        delayLine_.zeroSignals();
+        if (isSecondOrderSectionsUsed_)
+            sections_.reset();
+        else
+            delayLine_.zeroSignals();
     }
 }
@@ -21,15 +21,20 @@
 #define  IIR_H
 
 #include "../support/Filter.h"
+#include "../support/SecondOrderSections.h"
 
 namespace loudness{
 
     /**
      * @class IIR
      *
-     * @brief Performs IIR filtering of an input SignalBank using direct form 2.
+     * @brief Performs IIR filtering of an input SignalBank.
      *
-     * At present, this algorithm supports multiple ears but not multiple channels.
+     * The transfer function is factored into a cascade of second order
+     * sections on initialisation, which is applied to all channels, ears and
+     * sources at once (see SecondOrderSections). If the transfer function
+     * cannot be factored accurately, as for high order filters with
+     * clustered poles, the filter is applied in direct form 2 instead.
      *
      */
     class IIR : public Module, public Filter
@@ -42,6 +47,11 @@ namespace loudness{
         IIR(const RealVec &bCoefs, const RealVec &aCoefs);
 
         virtual ~IIR();
+
+        /** Returns true if the filter is applied as second order sections,
+         * false if in direct form 2. */
+        bool isSecondOrderSectionsUsed() const;
+
     private:
         virtual bool initializeInternal(const SignalBank &input);
         virtual bool initializeInternal(){return 0;};
@@ -49,6 +59,8 @@ namespace loudness{
         virtual void processInternal(){};
         virtual void resetInternal();
 
+        bool isSecondOrderSectionsUsed_;
+        SecondOrderSections sections_;
     };
 }
 
@@ -59,6 +59,7 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
 
         Real cParam_;
         bool dioticPresentation_;
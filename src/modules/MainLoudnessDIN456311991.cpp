@@ -112,6 +112,10 @@ namespace loudness{
             output_.setCentreFreq (i, fc);
         }
 
+        // Working levels (third octave bands and critical bands)
+        thirdOctaveLevels_.assign (input.getNChannels(), -60.0);
+        lE_.assign (20, 0.0);
+
         return 1;
     }
 
@@ -129,40 +133,40 @@ namespace loudness{
                                      (src, ear, 0);
                 
                 // Levels only acceptable between -60 and 120 dB SPL
-                RealVec thirdOctaveLevels(input.getNChannels(), -60.0);
+                std::fill (thirdOctaveLevels_.begin(), thirdOctaveLevels_.end(), -60.0);
                 for (int i = 0; i < input.getNChannels(); ++i)
                 {
                     if (inputLevels[i] > 120)
-                        thirdOctaveLevels[i] = 120;
+                        thirdOctaveLevels_[i] = 120;
                     else if (inputLevels[i] > -60)
-                        thirdOctaveLevels[i] = inputLevels[i];
+                        thirdOctaveLevels_[i] = inputLevels[i];
                 }
 
                 // Determination of levels (LCB) within the first three critical bands
                 int nCriticalBands = 20;
-                RealVec lE(nCriticalBands, 0.0);
+                std::fill (lE_.begin(), lE_.end(), 0.0);
                 Real tI = 0.0;
                 for (uint i = 0; i < dLL_.size(); ++i) // size = 11
                 {
                     int j = 0;
-                    while ((thirdOctaveLevels[i] > (rAP_[j] - dLL_[i][j])) && (j < 7))
+                    while ((thirdOctaveLevels_[i] > (rAP_[j] - dLL_[i][j])) && (j < 7))
                         j++;
-                    Real xP = thirdOctaveLevels[i] + dLL_[i][j];
+                    Real xP = thirdOctaveLevels_[i] + dLL_[i][j];
                     tI += decibelsToPower (xP);
 
                     if (i == 5) // Sum of 6 third octave bands from 25 Hz to 80 Hz
                     {
-                        lE[0] = powerToDecibels (tI);
+                        lE_[0] = powerToDecibels (tI);
                         tI = 0.0;
                     }
                     else if (i == 8) // Sum of 3 third octave bands from 100 Hz to 160 Hz
                     {
-                        lE[1] = powerToDecibels (tI);
+                        lE_[1] = powerToDecibels (tI);
                         tI = 0.0;
                     }
                     else if (i == 10) // Sum of 2 third octave bands from 200 Hz to 250 Hz
                     {
-                        lE[2] = powerToDecibels (tI);
+                        lE_[2] = powerToDecibels (tI);
                     }
                 }
 
@@ -171,20 +175,20 @@ namespace loudness{
                 {
                     // First three bands derived from summed third octave bands
                     if (i > 2)
-                        lE[i] = thirdOctaveLevels[i + 8];
+                        lE_[i] = thirdOctaveLevels_[i + 8];
 
                     if (outerEarType_ == OuterEarFilter::FREEFIELD)
-                        lE[i] = lE[i] - a0_[i];
+                        lE_[i] = lE_[i] - a0_[i];
                     else if (outerEarType_ == OuterEarFilter::DIFFUSEFIELD)
-                        lE[i] = lE[i] - a0_[i] + dDF_[i];
+                        lE_[i] = lE_[i] - a0_[i] + dDF_[i];
 
                     mainLoudness[i] = 0.0;
 
-                    if (lE[i] > lTQ_[i])
+                    if (lE_[i] > lTQ_[i])
                     {
-                        lE[i] = lE[i] - dCB_[i];
+                        lE_[i] = lE_[i] - dCB_[i];
                         Real mP1 = 0.0635 * std::pow (10, 0.025 * lTQ_[i]);
-                        Real powerRatio = decibelsToPower (lE[i] - lTQ_[i]);
+                        Real powerRatio = decibelsToPower (lE_[i] - lTQ_[i]);
                         Real s = 0.25;
                         Real mP2 = std::pow (1 - s + s * powerRatio, 0.25) - 1;
                         mainLoudness[i] = mP1 * mP2;
@@ -81,7 +81,7 @@ namespace loudness{
         
         OuterEarFilter outerEarType_;
         RealVecVec dLL_;
-        RealVec rAP_, a0_, dDF_, lTQ_, dCB_;
+        RealVec rAP_, a0_, dDF_, lTQ_, dCB_, thirdOctaveLevels_, lE_;
     };
 }
 
@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MultiRatePowerSpectrum.h"
+#include "Window.h"
+
+namespace loudness{
+
+    /*
+     * Zeroth order modified Bessel function of the first kind.
+     */
+    static Real besselI0 (Real x)
+    {
+        Real sum = 1.0, term = 1.0;
+        for (int k = 1; term > 1e-12 * sum; ++k)
+        {
+            Real halfXOverK = 0.5 * x / k;
+            term *= halfXOverK * halfXOverK;
+            sum += term;
+        }
+        return sum;
+    }
+
+    /*
+     * Linear-phase low-pass filter designed using the Kaiser window method
+     * (80 dB stopband attenuation). The cutoff and transition width are
+     * normalised by the sampling rate. The filter has an odd number of taps
+     * and unity gain at DC.
+     */
+    static RealVec designLowPassFilter (Real cutoff, Real transitionWidth)
+    {
+        const Real attenuation = 80.0;
+        Real beta = 0.1102 * (attenuation - 8.7);
+        int order = (int)std::ceil ((attenuation - 8.0) /
+                                    (2.285 * 2.0 * PI * transitionWidth));
+        order += order % 2;
+
+        RealVec taps (order + 1);
+        Real sum = 0.0;
+        for (int n = 0; n <= order; ++n)
+        {
+            Real m = n - 0.5 * order;
+            Real sinc = (m == 0) ? 2.0 * cutoff :
+                        std::sin (2.0 * PI * cutoff * m) / (PI * m);
+            Real r = 2.0 * n / order - 1.0;
+            taps[n] = sinc * besselI0 (beta * std::sqrt (1.0 - r * r)) /
+                      besselI0 (beta);
+            sum += taps[n];
+        }
+        for (int n = 0; n <= order; ++n)
+            taps[n] /= sum;
+        return taps;
+    }
+
+    /*
+     * Dot product using four partial sums, which the compiler maps onto SIMD
+     * registers.
+     */
+    static inline Real dot (const Real* w, const Real* x, int n)
+    {
+        Real sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+        int j = 0;
+        for (; j + 3 < n; j += 4)
+        {
+            sum0 += w[j] * x[j];
+            sum1 += w[j + 1] * x[j + 1];
+            sum2 += w[j + 2] * x[j + 2];
+            sum3 += w[j + 3] * x[j + 3];
+        }
+        for (; j < n; ++j)
+            sum0 += w[j] * x[j];
+        return (sum0 + sum1) + (sum2 + sum3);
+    }
+
+    MultiRatePowerSpectrum::MultiRatePowerSpectrum(const RealVec& bandFreqsHz,
+                const vector<int>& windowSizes,
+                int hopSize,
+                bool sampleSpectrumUniformly) :
+            Module("MultiRatePowerSpectrum"),
+            bandFreqsHz_ (bandFreqsHz),
+            windowSizes_ (windowSizes),
+            hopSize_ (hopSize),
+            sampleSpectrumUniformly_ (sampleSpectrumUniformly),
+            isFirstSampleAtWindowCentre_ (true),
+            referenceValue_ (2e-5),
+            latency_ (0)
+    {}
+
+    MultiRatePowerSpectrum::~MultiRatePowerSpectrum()
+    {}
+
+    bool MultiRatePowerSpectrum::initializeInternal(const SignalBank &input)
+    {
+        ffts_.clear();
+
+        nBands_ = (int)windowSizes_.size();
+        LOUDNESS_ASSERT(input.getNChannels() == 1,
+                name_ << ": Input should have a single channel.");
+        LOUDNESS_ASSERT((int)bandFreqsHz_.size() == (nBands_ + 1),
+                name_ << ": Number of frequency bands should equal number of windows + 1.");
+        LOUDNESS_ASSERT(!anyAscendingValues(windowSizes_),
+                name_ << ": Window lengths must be in descending order.");
+
+        int blockSize = input.getNSamples();
+        if (hopSize_ < blockSize)
+        {
+            LOUDNESS_ERROR(name_
+                    << ": Hop size cannot be less than the input buffer size.");
+            return 0;
+        }
+
+        int fs = input.getFs();
+        int largestWindowSize = windowSizes_[0];
+
+        // index of the last input sample of the first frame, as with
+        // FrameGenerator
+        int centreIdx = isFirstSampleAtWindowCentre_ ? 0 : largestWindowSize / 2;
+        int lastSampleIdx = centreIdx + largestWindowSize / 2 - 1;
+
+        decimationFactors_.assign (nBands_, 1);
+        frameSizes_.assign (nBands_, 0);
+        filters_.resize (nBands_);
+        vector<int> lastDecimationIdx (nBands_, 0);
+        int longestFilter = 1, maxDelay = 0;
+        for (int w = 0; w < nBands_; ++w)
+        {
+            // largest power of two keeping three samples per period of the
+            // upper band edge
+            int d = 1;
+            while ((hopSize_ % (2 * d) == 0) &&
+                   (windowSizes_[w] % (4 * d) == 0) &&
+                   (fs / (2.0 * d) >= 3.0 * bandFreqsHz_[w + 1]))
+                d *= 2;
+            decimationFactors_[w] = d;
+            frameSizes_[w] = windowSizes_[w] / d;
+
+            if (d > 1)
+            {
+                Real transitionWidth = 1.0 / d - 2.0 * bandFreqsHz_[w + 1] / fs;
+                filters_[w] = designLowPassFilter (0.5 / d, transitionWidth);
+            }
+            else
+            {
+                filters_[w].assign (1, 1.0);
+            }
+            int filterSize = (int)filters_[w].size();
+            longestFilter = std::max (longestFilter, filterSize);
+
+            // input sample at which the last decimated sample of the first
+            // frame is computed, given the filter delay
+            lastDecimationIdx[w] = centreIdx + windowSizes_[w] / 2 - d +
+                                   (filterSize - 1) / 2;
+            maxDelay = std::max (maxDelay, lastDecimationIdx[w] - lastSampleIdx);
+
+            LOUDNESS_DEBUG(name_ << ": Band: " << w
+                    << ", decimation factor: " << d
+                    << ", frame size: " << frameSizes_[w]
+                    << ", filter taps: " << filterSize);
+        }
+
+        // whole number of hops, so frames correspond to those of
+        // FrameGenerator
+        latency_ = hopSize_ * (int)std::ceil (maxDelay / (Real)hopSize_);
+        int triggerIdx = lastSampleIdx + latency_;
+        LOUDNESS_DEBUG(name_ << ": Latency in samples: " << latency_);
+
+        // the decimated signals hold the frame plus the samples computed
+        // since its end
+        firstDecimationIdx_.assign (nBands_, 0);
+        ringSizes_.assign (nBands_, 0);
+        int largestRingSize = 0;
+        for (int w = 0; w < nBands_; ++w)
+        {
+            int d = decimationFactors_[w];
+            firstDecimationIdx_[w] = lastDecimationIdx[w] % d;
+            int lastComputedIdx = triggerIdx - (triggerIdx - firstDecimationIdx_[w]) % d;
+            ringSizes_[w] = frameSizes_[w] + (lastComputedIdx - lastDecimationIdx[w]) / d;
+            largestRingSize = std::max (largestRingSize, ringSizes_[w]);
+        }
+
+        // FFT configuration, bins and normalisation per band
+        int uniformFftSize = nextPowerOfTwo (largestWindowSize);
+        bandBinIndices_.resize (nBands_);
+        normFactors_.resize (nBands_);
+        windows_.resize (nBands_);
+        Window window (Window::HANN, largestWindowSize, true);
+        int nBins = 0, largestFrameSize = 0;
+        for (int w = 0; w < nBands_; ++w)
+        {
+            int d = decimationFactors_[w];
+            int fftSize = sampleSpectrumUniformly_ ?
+                          uniformFftSize : nextPowerOfTwo (windowSizes_[w]);
+
+            // These are NOT the nearest components but satisfies f_k in [f_lo, f_hi)
+            bandBinIndices_[w].assign (2, 0);
+            bandBinIndices_[w][0] = ceil (bandFreqsHz_[w] * fftSize / fs);
+            bandBinIndices_[w][1] = ceil (bandFreqsHz_[w + 1] * fftSize / fs);
+            LOUDNESS_ASSERT(bandBinIndices_[w][1] > 0,
+                    name_ << ": No components found in band number " << w);
+
+            //exclude DC and Nyquist if found
+            int nyqIdx = (fftSize / 2) + (fftSize % 2);
+            if (bandBinIndices_[w][0] == 0)
+            {
+                LOUDNESS_WARNING(name_ << ": DC found...excluding.");
+                bandBinIndices_[w][0] = 1;
+            }
+            if ((bandBinIndices_[w][1] - 1) >= nyqIdx)
+            {
+                LOUDNESS_WARNING(name_ <<
+                        ": Bin is >= nyquist...excluding.");
+                bandBinIndices_[w][1] = nyqIdx;
+            }
+            nBins += bandBinIndices_[w][1] - bandBinIndices_[w][0];
+
+            // same bins at the decimated rate
+            ffts_.push_back (unique_ptr<FFT> (new FFT (fftSize / d)));
+            ffts_[w] -> initialize();
+
+            // average power
+            Real refSquared = referenceValue_ * referenceValue_;
+            normFactors_[w] = 2.0 / (refSquared * (fftSize / d) * frameSizes_[w]);
+
+            // periodic Hann window normalised for energy
+            windows_[w].assign (frameSizes_[w], 0.0);
+            window.generateWindow (windows_[w], Window::HANN, true);
+            window.normaliseWindow (windows_[w], Window::ENERGY);
+            largestFrameSize = std::max (largestFrameSize, frameSizes_[w]);
+        }
+        windowedFrame_.assign (largestFrameSize, 0.0);
+
+        LOUDNESS_DEBUG(name_
+                << ": Total number of bins comprising the output spectrum: " << nBins);
+
+        // input samples read by the filters, stored twice in a row as the
+        // delay line of HoppingGoertzelDFT
+        delayLineSize_ = blockSize * ((longestFilter + blockSize - 1) / blockSize + 1);
+        delayLine_.initialize (input.getNSources(),
+                               input.getNEars(),
+                               1,
+                               2 * delayLineSize_,
+                               fs);
+
+        // decimated signals, one per channel, also stored twice
+        decimatedSignals_.initialize (input.getNSources(),
+                                      input.getNEars(),
+                                      nBands_,
+                                      2 * largestRingSize,
+                                      fs);
+        configureDelayLineIndices();
+
+        output_.initialize (input.getNSources(),
+                            input.getNEars(),
+                            nBins,
+                            1,
+                            fs);
+        output_.setFrameRate (fs / (Real)hopSize_);
+        output_.setTrig (false);
+
+        int k = 0;
+        for (int w = 0; w < nBands_; ++w)
+        {
+            // FFT size at the input rate
+            Real fftSize = ffts_[w] -> getFftSize() * decimationFactors_[w];
+            for (int j = bandBinIndices_[w][0]; j < bandBinIndices_[w][1]; ++j)
+                output_.setCentreFreq (k++, j * fs / fftSize);
+        }
+
+        return 1;
+    }
+
+    void MultiRatePowerSpectrum::processInternal(const SignalBank &input)
+    {
+        output_.setTrig (false);
+
+        int nSamples = input.getNSamples();
+        for (int src = 0; src < input.getNSources(); ++src)
+        {
+            for (int ear = 0; ear < input.getNEars(); ++ear)
+            {
+                const Real* x = input.getSignalReadPointer (src, ear, 0);
+                Real* delay = delayLine_.getSignalWritePointer (src, ear, 0);
+                std::copy (x, x + nSamples, delay + writeIdx_);
+                std::copy (x, x + nSamples, delay + writeIdx_ + delayLineSize_);
+            }
+        }
+
+        // decimate up to the next trigger at a time
+        int startIdx = writeIdx_;
+        int nRemainingSamples = nSamples;
+        while (nRemainingSamples)
+        {
+            int nSamplesToProcess = std::min (nSamplesUntilTrigger_,
+                                              nRemainingSamples);
+            decimate (startIdx, nSamplesToProcess);
+            startIdx += nSamplesToProcess;
+            nRemainingSamples -= nSamplesToProcess;
+            nSamplesUntilTrigger_ -= nSamplesToProcess;
+
+            if (nSamplesUntilTrigger_ == 0)
+            {
+                calculatePowerSpectrum();
+                nSamplesUntilTrigger_ = hopSize_;
+                output_.setTrig (true);
+            }
+        }
+        writeIdx_ = (writeIdx_ + nSamples) % delayLineSize_;
+    }
+
+    void MultiRatePowerSpectrum::decimate(int startIdx, int nSamples)
+    {
+        for (int w = 0; w < nBands_; ++w)
+        {
+            const Real* filter = filters_[w].data();
+            int filterSize = (int)filters_[w].size();
+            int d = decimationFactors_[w];
+            int ringSize = ringSizes_[w];
+
+            int smp = nSamplesUntilDecimation_[w];
+            for (; smp < nSamples; smp += d)
+            {
+                // oldest input sample of the filter, read from the second copy
+                int readIdx = startIdx + smp + delayLineSize_ - filterSize + 1;
+                int ringIdx = ringWriteIdx_[w];
+                for (int src = 0; src < delayLine_.getNSources(); ++src)
+                {
+                    for (int ear = 0; ear < delayLine_.getNEars(); ++ear)
+                    {
+                        const Real* x = delayLine_.getSignalReadPointer
+                                        (src, ear, 0) + readIdx;
+                        Real* y = decimatedSignals_.getSignalWritePointer
+                                  (src, ear, w);
+                        Real value = dot (filter, x, filterSize);
+                        y[ringIdx] = value;
+                        y[ringIdx + ringSize] = value;
+                    }
+                }
+                ringWriteIdx_[w] = (ringIdx + 1) % ringSize;
+            }
+            nSamplesUntilDecimation_[w] = smp - nSamples;
+        }
+    }
+
+    void MultiRatePowerSpectrum::calculatePowerSpectrum()
+    {
+        for (int src = 0; src < output_.getNSources(); ++src)
+        {
+            for (int ear = 0; ear < output_.getNEars(); ++ear)
+            {
+                Real* y = output_.getSingleSampleWritePointer (src, ear, 0);
+                for (int w = 0; w < nBands_; ++w)
+                {
+                    // the frame is the oldest frameSizes_[w] samples held
+                    const Real* x = decimatedSignals_.getSignalReadPointer
+                                    (src, ear, w) + ringWriteIdx_[w];
+                    const Real* window = windows_[w].data();
+                    for (int smp = 0; smp < frameSizes_[w]; ++smp)
+                        windowedFrame_[smp] = window[smp] * x[smp];
+
+                    FFT& fft = *ffts_[w];
+                    fft.process (windowedFrame_.data(), frameSizes_[w]);
+
+                    for (int bin = bandBinIndices_[w][0];
+                         bin < bandBinIndices_[w][1]; ++bin)
+                    {
+                        Real re = fft.getReal (bin);
+                        Real im = fft.getImag (bin);
+                        *y++ = normFactors_[w] * (re * re + im * im);
+                    }
+                }
+            }
+        }
+    }
+
+    void MultiRatePowerSpectrum::resetInternal()
+    {
+        delayLine_.zeroSignals();
+        decimatedSignals_.zeroSignals();
+        configureDelayLineIndices();
+    }
+
+    void MultiRatePowerSpectrum::configureDelayLineIndices()
+    {
+        writeIdx_ = 0;
+        ringWriteIdx_.assign (nBands_, 0);
+        nSamplesUntilDecimation_ = firstDecimationIdx_;
+        int largestWindowSize = windowSizes_[0];
+        if (isFirstSampleAtWindowCentre_)
+            nSamplesUntilTrigger_ = largestWindowSize / 2 + latency_;
+        else
+            nSamplesUntilTrigger_ = largestWindowSize + latency_;
+    }
+
+    void MultiRatePowerSpectrum::setReferenceValue (Real referenceValue)
+    {
+        referenceValue_ = referenceValue;
+    }
+
+    void MultiRatePowerSpectrum::setFirstSampleAtWindowCentre (bool isFirstSampleAtWindowCentre)
+    {
+        isFirstSampleAtWindowCentre_ = isFirstSampleAtWindowCentre;
+    }
+
+    int MultiRatePowerSpectrum::getDecimationFactor (int band) const
+    {
+        return decimationFactors_[band];
+    }
+
+    int MultiRatePowerSpectrum::getLatency() const
+    {
+        return latency_;
+    }
+}
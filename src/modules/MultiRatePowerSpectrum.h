@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MULTIRATEPOWERSPECTRUM_H
+#define MULTIRATEPOWERSPECTRUM_H
+
+#include "../support/Module.h"
+#include "../support/FFT.h"
+
+namespace loudness{
+
+    /**
+     * @class MultiRatePowerSpectrum
+     *
+     * @brief Computes a multi-resolution power spectrum from decimated
+     * signals.
+     *
+     * This module computes the same band-limited power spectrum as
+     * FrameGenerator, Window (periodic Hann) and PowerSpectrum used in
+     * series, but takes the input signal directly. The band edges (in Hz),
+     * window sizes (in samples at the input rate, in descending order) and
+     * hop size (in samples) are specified as for HoppingGoertzelDFT:
+     *
+     * @code
+     *      RealVec bandFreqs {10, 80, 500, 1250, 2540, 4050, 15001};
+     *      vector<int> windowSizes {2048, 1024, 512, 256, 128, 64};
+     *      MultiRatePowerSpectrum object(bandFreqs, windowSizes, 32, false);
+     * @endcode
+     *
+     * Only frequencies below the upper edge of a band are kept from its
+     * window, so each band is low-pass filtered and decimated by the largest
+     * power of two D for which the decimated sampling rate is at least three
+     * times the upper band edge (D must also divide the window and hop
+     * sizes). The window of N samples then becomes a window of N/D samples,
+     * transformed by an FFT D times shorter. With the bands above, every
+     * window is 64 samples long at 32 kHz.
+     *
+     * The anti-aliasing filters are linear-phase Kaiser-windowed sinc FIR
+     * filters (80 dB stopband), whose outputs are only computed at the
+     * decimated rate. Their delay is compensated so that all windows remain
+     * aligned at their centres. Frames are output at the same rate as
+     * FrameGenerator, but the largest filter delay beyond half the longest
+     * window is added as latency, rounded up to a whole number of hops (see
+     * getLatency()). Otherwise the spectrum matches PowerSpectrum (same bins,
+     * average power normalisation, DC and Nyquist excluded) to within the
+     * filter ripple and aliasing.
+     *
+     * The boolean argument @a sampleSpectrumUniformly has the same meaning
+     * as for PowerSpectrum.
+     *
+     * The hop size must not be less than the number of input samples.
+     *
+     * @sa PowerSpectrum, HoppingGoertzelDFT
+     */
+    class MultiRatePowerSpectrum : public Module
+    {
+    public:
+
+        /**
+         * @brief Constructs a MultiRatePowerSpectrum object.
+         *
+         * @param bandFreqsHz A vector of band edges (in Hz) in ascending order.
+         * @param windowSizes A vector of window sizes (in samples) for each band.
+         * @param hopSize The hop size in samples.
+         * @param sampleSpectrumUniformly Set true to use the same FFT size for
+         * all bands (relative to the input rate).
+         */
+        MultiRatePowerSpectrum(const RealVec& bandFreqsHz,
+                const vector<int>& windowSizes,
+                int hopSize,
+                bool sampleSpectrumUniformly);
+
+        virtual ~MultiRatePowerSpectrum();
+
+        void setReferenceValue (Real referenceValue);
+        void setFirstSampleAtWindowCentre (bool isFirstSampleAtWindowCentre);
+
+        /** Returns the decimation factor of a band (after initialisation). */
+        int getDecimationFactor (int band) const;
+
+        /** Returns the delay (in samples) of the output frames relative to
+         * FrameGenerator (after initialisation). */
+        int getLatency() const;
+
+    private:
+        virtual bool initializeInternal(const SignalBank &input);
+        virtual bool initializeInternal(){return 0;};
+        virtual void processInternal(const SignalBank &input);
+        virtual void processInternal(){};
+        virtual void resetInternal();
+        void configureDelayLineIndices();
+        void decimate(int startIdx, int nSamples);
+        void calculatePowerSpectrum();
+
+        RealVec bandFreqsHz_;
+        vector<int> windowSizes_;
+        int hopSize_;
+        bool sampleSpectrumUniformly_, isFirstSampleAtWindowCentre_;
+        Real referenceValue_;
+        int nBands_, delayLineSize_, writeIdx_, nSamplesUntilTrigger_, latency_;
+        vector<int> decimationFactors_, frameSizes_, ringSizes_, ringWriteIdx_;
+        vector<int> firstDecimationIdx_, nSamplesUntilDecimation_;
+        vector<vector<int> > bandBinIndices_;
+        vector<RealVec> filters_, windows_;
+        RealVec normFactors_, windowedFrame_;
+        SignalBank delayLine_, decimatedSignals_;
+        vector<unique_ptr<FFT>> ffts_;
+    };
+}
+
+#endif
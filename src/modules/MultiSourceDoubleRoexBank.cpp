@@ -33,12 +33,18 @@ namespace loudness{
         camHi_(camHi),
         camStep_(camStep),
         scalingFactor_(scalingFactor),
+        weightTolerance_(1e-12),
         isExcitationPatternInterpolated_(isExcitationPatternInterpolated),
         isInterpolationCubic_(isInterpolationCubic)
     {}
 
     MultiSourceDoubleRoexBank::~MultiSourceDoubleRoexBank() {}
 
+    void MultiSourceDoubleRoexBank::setWeightTolerance(Real weightTolerance)
+    {
+        weightTolerance_ = weightTolerance;
+    }
+
     bool MultiSourceDoubleRoexBank::initializeInternal(const SignalBank &input)
     {
 
@@ -91,12 +97,27 @@ namespace loudness{
         output_.setFrameRate (input.getFrameRate());
 
         //filter variables
-        wPassive_.resize (nFilters_);
-        wActive_.resize (nFilters_);
+        wPassive_.initialize (nFilters_, input.getNChannels());
+        wActive_.initialize (nFilters_, input.getNChannels());
         maxGdB_.resize (nFilters_);
         thirdGainTerm_.resize (nFilters_);
+        gain_.resize (nFilters_);
+
+        //filter outputs for each source
+        int nSources = input.getNSources();
+        excitationLinP_.assign (nSources, RealVec(nFilters_, 0.0));
+        excitationLinA_.assign (nSources, RealVec(nFilters_, 0.0));
+        inputSpectra_.resize (nSources);
+        excitationLinPPtrs_.resize (nSources);
+        excitationLinAPtrs_.resize (nSources);
+        for (int src = 0; src < nSources; ++src)
+        {
+            excitationLinPPtrs_[src] = excitationLinP_[src].data();
+            excitationLinAPtrs_[src] = excitationLinA_[src].data();
+        }
 
         //fill the above arrays
+        RealVec passive, active;
         for (int i = 0; i < nFilters_; ++i)
         {
             //filter frequency in Cams
@@ -121,6 +142,8 @@ namespace loudness{
             thirdGainTerm_[i] = maxGdB_[i] / (1 + exp (0.05 * (100 - maxGdB_[i])));
 
             //compute the fixed filters
+            passive.clear();
+            active.clear();
             int j = 0;
             while (j < input.getNChannels())
             {
@@ -144,15 +167,29 @@ namespace loudness{
                     }
 
                     //Eq. 4 and Eq. 7
-                    wPassive_[i].push_back ((1 + pgPassive) * exp (-pgPassive)); 
-                    wActive_[i].push_back ((1 + pgActive) * exp (-pgActive)); 
+                    passive.push_back ((1 + pgPassive) * exp (-pgPassive)); 
+                    active.push_back ((1 + pgActive) * exp (-pgActive)); 
                 }
                 else
                     break;
                 j++;
             }
+
+            //keep the non-negligible weights only
+            wPassive_.setRow (passive, 0, weightTolerance_);
+            wActive_.setRow (active, 0, weightTolerance_);
         }
-        LOUDNESS_DEBUG(name_ << ": Passive and active filters configured.");
+        //precompute the interpolation of the excitation pattern
+        if (isExcitationPatternInterpolated_)
+        {
+            RealVec camsInterp (388);
+            for (int i = 0; i < 388; ++i)
+                camsInterp[i] = camLo_ + i * 0.1;
+            interpolator_.initialize (cams_, camsInterp, isInterpolationCubic_);
+        }
+
+        LOUDNESS_DEBUG(name_ << ": Filter weights used: "
+                << wPassive_.getNNonZero() + wActive_.getNNonZero());
         LOUDNESS_DEBUG(name_ << ": Excitation pattern will be scaled by: " 
                 << scalingFactor_);
         
@@ -162,40 +199,33 @@ namespace loudness{
 
     void MultiSourceDoubleRoexBank::processInternal(const SignalBank &input)
     {
+        int nSources = input.getNSources();
         for (int ear = 0; ear < input.getNEars(); ++ear)
         {
-            // First to passive filtering
-            RealVec gainOut (nFilters_, 0.0);
-            for (int src = 0; src < input.getNSources(); ++src)
+            // Passive and active filtering of all sources
+            for (int src = 0; src < nSources; ++src)
             {
-                const Real* inputSpectrum = input
-                                            .getSingleSampleReadPointer
-                                            (src, ear, 0);
-
-                Real* outputExcitation = output_
-                                         .getSingleSampleWritePointer
-                                         (src, ear, 0);
-
-                for (int i = 0; i < nFilters_; ++i)
-                {
-                    Real excitationLinP = 0.0;
-
-                    //passive filter output
-                    for (uint j = 0; j < wPassive_[i].size(); ++j)
-                        excitationLinP += wPassive_[i][j] * inputSpectrum[j];
-
-                    outputExcitation[i] = excitationLinP;
-
-                    // Accumulate power in each channel from all sources
-                    gainOut[i] += excitationLinP;
-                }
+                inputSpectra_[src] = input
+                                     .getSingleSampleReadPointer
+                                     (src, ear, 0);
             }
+            wPassive_.multiply (inputSpectra_.data(),
+                                excitationLinPPtrs_.data(),
+                                nSources);
+            wActive_.multiply (inputSpectra_.data(),
+                               excitationLinAPtrs_.data(),
+                               nSources);
 
             // Now gain calculation using total power from all inputs
             for (int i = 0; i < nFilters_; ++i)
             {
+                // Accumulate power in each channel from all sources
+                Real totalExcitationLinP = 0.0;
+                for (int src = 0; src < nSources; ++src)
+                    totalExcitationLinP += excitationLinP_[src][i];
+
                 //convert to dB
-                Real excitationLog = powerToDecibels (gainOut[i]);
+                Real excitationLog = powerToDecibels (totalExcitationLinP);
 
                 //compute gain (Complete Eq. 6 for <= 30)
                 Real gain = maxGdB_[i] - (maxGdB_[i] / 
@@ -211,36 +241,24 @@ namespace loudness{
                 }
 
                 //convert to linear gain
-                gainOut[i] = decibelsToPower(gain);
+                gain_[i] = decibelsToPower(gain);
             }
             
-            // Now the active filter for each source
-            for (int src = 0; src < input.getNSources(); ++src)
+            // Now the excitation pattern of each source
+            for (int src = 0; src < nSources; ++src)
             {
-                const Real* inputSpectrum = input
-                                            .getSingleSampleReadPointer
-                                            (src, ear, 0);
-
                 Real* outputExcitation = output_.
                                          getSingleSampleWritePointer
                                          (src, ear, 0);
 
                 for (int i = 0; i < nFilters_; ++i)
                 {
-                    // from above
-                    Real excitationLinP = outputExcitation[i];
-                    Real excitationLinA = 0.0;
-
-                    //active filter output
-                    for (uint j = 0; j < wActive_[i].size(); ++j)
-                        excitationLinA += wActive_[i][j] * inputSpectrum[j];
-
                     // Use the gain derived from all inputs
-                    excitationLinA *= gainOut[i];
+                    Real excitationLinA = excitationLinA_[src][i] * gain_[i];
 
                     //excitation pattern
                     Real excitation = scalingFactor_ * 
-                                      (excitationLinP + excitationLinA);
+                                      (excitationLinP_[src][i] + excitationLinA);
 
                     if (isExcitationPatternInterpolated_)
                         logExcitation_[i] = log(excitation + 1e-10);
@@ -251,12 +269,11 @@ namespace loudness{
                 //Interpolate to estimate 0.1~Cam res excitation pattern
                 if (isExcitationPatternInterpolated_)
                 {
-                    spline_.set_points (cams_,
-                                        logExcitation_,
-                                        isInterpolationCubic_);
+                    interpolator_.process (logExcitation_.data(),
+                                           outputExcitation);
 
                     for (int i = 0; i < 388; ++i)
-                        outputExcitation[i] = exp (spline_ (camLo_ + i * 0.1));
+                        outputExcitation[i] = exp (outputExcitation[i]);
                 }
             }
         }
@@ -98,6 +98,10 @@ namespace loudness{
         //p lower is level dependent
         pl_.assign (nFilters_, 0.0);
 
+        //level per ERB and filter shape, given all sources in an ear
+        compLevel_.assign (input.getNChannels(), 0.0);
+        roex_.assign (input.getNChannels(), 0.0);
+
         output_.initialize (input.getNSources(),
                             input.getNEars(),
                             nFilters_,
@@ -136,7 +140,7 @@ namespace loudness{
             /*
              * Level per ERB given all sources in this ear
              */
-            RealVec compLevel (input.getNChannels(), 0.0);
+            std::fill (compLevel_.begin(), compLevel_.end(), 0.0);
             for (int src = 0; src < input.getNSources(); ++src)
             {
                 const Real* inputPowerSpectrum = input
@@ -154,13 +158,13 @@ namespace loudness{
                     //subtract components outside the window
                     while (k < rectBinIndices_[i][0])
                         runningSum -= inputPowerSpectrum[k++];
-                    compLevel[i] += runningSum;
+                    compLevel_[i] += runningSum;
                 }
             }
 
             //convert to dB, subtract 51 here to save operations later
             for (int i = 0; i < input.getNChannels(); ++i)
-                compLevel[i] = powerToDecibels (compLevel[i], 1e-10, -100.0) - 51;
+                compLevel_[i] = powerToDecibels (compLevel_[i], (Real)1e-10, (Real)-100.0) - 51;
 
             // Calculate a filter based on all inputs, then excitation per
             // per band per source
@@ -168,7 +172,6 @@ namespace loudness{
             {
                 // shape
                 int j = 0;
-                RealVec roex (input.getNChannels(), 0.0);
                 while (j < input.getNChannels())
                 {
                     //normalised deviation
@@ -181,8 +184,8 @@ namespace loudness{
                     if (g < 0) //lower skirt - level dependent
                     {
                         //Complete Eq (3)
-                        p = pu_[i] - (pl_[i] * compLevel[j]); //51dB subtracted above
-                        p = max(p, 0.1); //p can go negative for very high levels
+                        p = pu_[i] - (pl_[i] * compLevel_[j]); //51dB subtracted above
+                        p = max(p, (Real)0.1); //p can go negative for very high levels
                         pg = -p * g; //p * abs (g)
                     }
                     else //upper skirt
@@ -193,7 +196,7 @@ namespace loudness{
                     //excitation
                     int idx = (int)(pg / step_ + 0.5);
                     idx = min (idx, roexIdxLimit_);
-                    roex[j++] = roexTable_[idx];
+                    roex_[j++] = roexTable_[idx];
                 }
 
                 // filter excitation for each source
@@ -207,7 +210,7 @@ namespace loudness{
                                                     (src, ear, 0);
                     outputExcitationPattern[i] = 0.0;
                     for (int k = 0; k < j; ++k)
-                        outputExcitationPattern[i] += roex[k] * inputPowerSpectrum[k];
+                        outputExcitationPattern[i] += roex_[k] * inputPowerSpectrum[k];
                 }
             }
         }
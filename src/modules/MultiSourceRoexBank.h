@@ -70,6 +70,7 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
 
         void generateRoexTable(int size = 1024);
 
@@ -77,7 +78,7 @@ namespace loudness{
         int nFilters_, roexIdxLimit_;
         Real step_;
         vector<vector<int> > rectBinIndices_;
-        RealVec pu_, pl_, roexTable_;
+        RealVec pu_, pl_, roexTable_, compLevel_, roex_;
     };
 }
 
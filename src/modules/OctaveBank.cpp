@@ -26,7 +26,8 @@ namespace loudness{
         order_ (order),
         nBandsToRemoveFromEnd_ (nBandsToRemoveFromEnd),
         isThirdOctave_ (isThirdOctave),
-        isOutputInDecibels_ (isOutputInDecibels)
+        isOutputInDecibels_ (isOutputInDecibels),
+        weightTolerance_ (1e-12)
     {
         centreFreqs_ = {25, 31.5, 40, 50, 63, 80, 100, 125, 160, 200, 250, 315,
             400, 500, 630, 800, 1000, 1250, 1600, 2000, 2500, 3150, 4000, 5000,
@@ -47,6 +48,11 @@ namespace loudness{
         centreFreqs_ = centreFreqs;
     }
 
+    void OctaveBank::setWeightTolerance (Real weightTolerance)
+    {
+        weightTolerance_ = weightTolerance;
+    }
+
     bool OctaveBank::initializeInternal(const SignalBank &input)
     {
         if (centreFreqs_.size() < 1)
@@ -68,14 +74,42 @@ namespace loudness{
         // Calculation of design bandwidth for Butterworth filter
         Real c = PI / (2.0 * order_);
         Real qDes = qRef * c / std::sin (c);
-        exponent_ = 2.0 * order_;
-        qDesExponentiated_ = pow (qDes, exponent_);
+        Real exponent = 2.0 * order_;
+        Real qDesExponentiated = pow (qDes, exponent);
 
         LOUDNESS_DEBUG(name_ << 
                 ": Design Q for Butterworth filter of order " 
                 << order_ <<
                 ": " << qDes);
 
+        // Filter responses at the input channel frequencies
+        int nChannels = input.getNChannels();
+        weights_.initialize (centreFreqs_.size(), nChannels);
+        RealVec response (nChannels, 0.0);
+        for (uint i = 0; i < centreFreqs_.size(); ++i)
+        {
+            Real fm = centreFreqs_[i];
+            for (int j = 0; j < nChannels; ++j)
+            {
+                Real f = input.getCentreFreq (j);
+                if (f > 0.0)
+                {
+                    Real g = f / fm - fm / f;
+                    response[j] = 1.0 / (1 + qDesExponentiated * pow (g, exponent));
+                }
+                else
+                {
+                    response[j] = 0.0;
+                }
+            }
+            weights_.setRow (response, 0, weightTolerance_);
+        }
+
+        LOUDNESS_DEBUG(name_ << ": Number of filter weights: "
+                << weights_.getNNonZero());
+
+        inputSpectrum_.assign (nChannels, 0.0);
+
         // Output SignalBank
         output_.initialize (input.getNSources(),
                             input.getNEars(),
@@ -90,32 +124,27 @@ namespace loudness{
 
     void OctaveBank::processInternal(const SignalBank &input)
     {
+        int nChannels = input.getNChannels();
+        Real* inputSpectrum = inputSpectrum_.data();
+
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for (int ear = 0; ear < input.getNEars(); ++ear)
             {
-                const Real* inputSpectrum = input
-                                            .getSingleSampleReadPointer
-                                            (src, ear, 0);
+                const Real* spectrum = input
+                                       .getSingleSampleReadPointer
+                                       (src, ear, 0);
                 Real* output = output_
                                .getSingleSampleWritePointer
                                (src, ear, 0);
 
+                //components with negligible power are ignored
+                for (int j = 0; j < nChannels; ++j)
+                    inputSpectrum[j] = spectrum[j] > 1e-15 ? spectrum[j] : 0.0;
+
                 for (uint i = 0; i < centreFreqs_.size(); ++i)
                 {
-                    Real filterOutput = 0.0;
-                    Real fm = centreFreqs_[i];
-
-                    for (int j = 0; j < input.getNChannels(); ++j)
-                    {
-                        if (inputSpectrum[j] > 1e-15)
-                        {
-                            Real f = input.getCentreFreq (j);
-                            Real g = f / fm - fm / f;
-                            Real aDes = 1 + qDesExponentiated_ * pow (g, exponent_);
-                            filterOutput += inputSpectrum[j] / aDes;
-                        }
-                    }
+                    Real filterOutput = weights_.dot (i, inputSpectrum);
 
                     if (isOutputInDecibels_)
                          filterOutput = powerToDecibels (filterOutput);
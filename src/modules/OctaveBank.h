@@ -21,6 +21,7 @@
 #define OctaveBank_H
 
 #include "../support/Module.h"
+#include "../support/SparseMatrix.h"
 
 namespace loudness{
 
@@ -45,6 +46,10 @@ namespace loudness{
      * To change the number of filters and/or the centre frequencies, pass a
      * RealVec to setCentreFreqs() after instantiation.
      *
+     * The filter responses are sampled at the centre frequencies of the input
+     * channels on initialisation and stored as a sparse weight matrix, so
+     * each frame costs one sparse matrix-vector product per ear.
+     *
      * REFERENCES:
      *
      * ANSI. (1986). ANSI S1.11-1986: Specification for Octave-Band and
@@ -67,6 +72,12 @@ namespace loudness{
          * have at least 1 element. */
         void setCentreFreqs (RealVec centreFreqs);
 
+        /**
+         * @brief Sets the magnitude below which filter weights are treated
+         * as zero (default is 1e-12). Takes effect on initialisation.
+         */
+        void setWeightTolerance (Real weightTolerance);
+
     private:
 
         virtual bool initializeInternal(const SignalBank &input);
@@ -77,8 +88,9 @@ namespace loudness{
 
         int order_, nBandsToRemoveFromEnd_;
         bool isThirdOctave_, isOutputInDecibels_;
-        Real exponent_, qDesExponentiated_;
-        RealVec centreFreqs_;
+        Real weightTolerance_;
+        RealVec centreFreqs_, inputSpectrum_;
+        SparseMatrix weights_;
     };
 }
 
@@ -30,6 +30,9 @@ namespace loudness{
             bandFreqsHz_(bandFreqsHz),
             windowSizes_(windowSizes),
             sampleSpectrumUniformly_(sampleSpectrumUniformly),
+            isWindowApplied_ (false),
+            isWindowPeriodic_ (true),
+            windowType_ (Window::HANN),
             normalisation_ (normalisation),
             referenceValue_ (referenceValue)
     {}
@@ -44,7 +47,7 @@ namespace loudness{
 
         //number of windows
         int nWindows = (int)windowSizes_.size();
-        LOUDNESS_ASSERT(input.getNChannels() == nWindows,
+        LOUDNESS_ASSERT(input.getNChannels() == (isWindowApplied_ ? 1 : nWindows),
                 name_ << ": Number of channels do not match number of windows");
         LOUDNESS_ASSERT((int)bandFreqsHz_.size() == (nWindows + 1),
                 name_ << ": Number of frequency bands should equal number of input channels + 1.");
@@ -53,10 +56,30 @@ namespace loudness{
 
         //work out FFT configuration (constrain to power of 2)
         int largestWindowSize = input.getNSamples();
+
+        //windows aligned at their centres, as with Window
+        windowOffsets_.assign(nWindows, 0);
+        windows_.clear();
+        if (isWindowApplied_)
+        {
+            Window window(windowType_, largestWindowSize, isWindowPeriodic_);
+            windows_.resize(nWindows);
+            for (int w = 0; w < nWindows; w++)
+            {
+                windowOffsets_[w] = largestWindowSize / 2 - windowSizes_[w] / 2;
+                windows_[w].assign(windowSizes_[w], 0.0);
+                window.generateWindow(windows_[w], windowType_, isWindowPeriodic_);
+                window.normaliseWindow(windows_[w], Window::ENERGY);
+            }
+        }
         vector<int> fftSize(nWindows, nextPowerOfTwo(largestWindowSize));
+        //all sources, ears and frames of a block (and all windows when
+        //sampling uniformly) are transformed together
+        int nSignals = input.getNSources() * input.getNEars() * blockSize_;
         if(sampleSpectrumUniformly_)
         {
-            ffts_.push_back(unique_ptr<FFT> (new FFT(fftSize[0]))); 
+            ffts_.push_back(unique_ptr<FFT> (new FFT(fftSize[0],
+                                                     nWindows * nSignals)));
             ffts_[0] -> initialize();
         }
         else
@@ -64,7 +87,7 @@ namespace loudness{
             for(int w=0; w<nWindows; w++)
             {
                 fftSize[w] = nextPowerOfTwo(windowSizes_[w]);
-                ffts_.push_back(unique_ptr<FFT> (new FFT(fftSize[w]))); 
+                ffts_.push_back(unique_ptr<FFT> (new FFT(fftSize[w], nSignals)));
                 ffts_[w] -> initialize();
             }
         }
@@ -153,36 +176,110 @@ namespace loudness{
 
     void PowerSpectrum::processInternal(const SignalBank &input)
     {
-        int fftIdx = 0;
+        processFrames(&input, &output_, 1);
+    }
+
+    void PowerSpectrum::processBlockInternal(const SignalBank* inputs,
+                                             int nInputs)
+    {
+        if (!isBlockTriggered(inputs, nInputs))
+        {
+            Module::processBlockInternal(inputs, nInputs);
+            return;
+        }
+
+        processFrames(inputs, outputBlock_.data(), nInputs);
+        for (int i = 0; i < nInputs; ++i)
+            outputBlock_[i].setTrig(true);
+    }
+
+    void PowerSpectrum::processFrames(const SignalBank* inputs,
+                                      SignalBank* outputs,
+                                      int nFrames)
+    {
         int nWindows = windowSizes_.size();
-        for (int src = 0; src < input.getNSources(); ++src)
+        int nWindowsPerFFT = nWindows / (int)ffts_.size();
+        int nSources = inputs[0].getNSources();
+        int nEars = inputs[0].getNEars();
+        int nInputSamples = inputs[0].getNSamples();
+
+        //index of the first bin of each band in the output
+        int outputIdx = 0;
+        for (uint fftIdx = 0; fftIdx < ffts_.size(); ++fftIdx)
         {
-            for (int ear = 0; ear < input.getNEars(); ++ear)
+            FFT& fft = *ffts_[fftIdx];
+            int firstChn = fftIdx * nWindowsPerFFT;
+            int lastChn = firstChn + nWindowsPerFFT;
+
+            //load all frames, reading both segments of circular inputs
+            int transform = 0;
+            for (int chn = firstChn; chn < lastChn; ++chn)
             {
-                //get a single sample pointer for moving through channels
-                Real* outputSignal = output_.getSingleSampleWritePointer
-                                     (src, ear, 0);
+                int inputChn = isWindowApplied_ ? 0 : chn;
+                for (int src = 0; src < nSources; ++src)
+                {
+                    for (int ear = 0; ear < nEars; ++ear)
+                    {
+                        for (int frame = 0; frame < nFrames; ++frame)
+                        {
+                            const Real* inputSignal = inputs[frame]
+                                                      .getSignalReadPointer
+                                                      (src, ear, inputChn);
+                            int readIdx = (inputs[frame].getRingOffset() +
+                                           windowOffsets_[chn]) % nInputSamples;
+                            int nSamplesToEnd = min(windowSizes_[chn],
+                                                    nInputSamples - readIdx);
+                            if (isWindowApplied_)
+                            {
+                                fft.setWindowedInput(transform++,
+                                                     windows_[chn].data(),
+                                                     inputSignal + readIdx,
+                                                     nSamplesToEnd,
+                                                     inputSignal,
+                                                     windowSizes_[chn] - nSamplesToEnd);
+                            }
+                            else
+                            {
+                                fft.setInput(transform++,
+                                             inputSignal + readIdx,
+                                             nSamplesToEnd,
+                                             inputSignal,
+                                             windowSizes_[chn] - nSamplesToEnd);
+                            }
+                        }
+                    }
+                }
+            }
+
+            //Do the FFTs
+            fft.processBatch(transform);
 
-                for (int chn = 0; chn < nWindows; ++chn)
+            //Extract components from band and compute powers
+            transform = 0;
+            for (int chn = firstChn; chn < lastChn; ++chn)
+            {
+                int binLo = bandBinIndices_[chn][0];
+                int binHi = bandBinIndices_[chn][1];
+                for (int src = 0; src < nSources; ++src)
                 {
-                    if(!sampleSpectrumUniformly_)
-                        fftIdx = chn;
-
-                    //Do the FFT
-                    ffts_[fftIdx] -> process(input.getSignalReadPointer
-                                             (src, ear, chn),
-                                             windowSizes_[chn]);
-
-                    //Extract components from band and compute powers
-                    Real re, im;
-                    int bin = bandBinIndices_[chn][0];
-                    while(bin < bandBinIndices_[chn][1])
+                    for (int ear = 0; ear < nEars; ++ear)
                     {
-                        re = ffts_[fftIdx] -> getReal(bin);
-                        im = ffts_[fftIdx] -> getImag(bin++);
-                        *outputSignal++ = normFactor_[chn] * (re*re + im*im);
+                        for (int frame = 0; frame < nFrames; ++frame)
+                        {
+                            Real* outputSignal = outputs[frame]
+                                                 .getSingleSampleWritePointer
+                                                 (src, ear, 0) + outputIdx;
+                            for (int bin = binLo; bin < binHi; ++bin)
+                            {
+                                Real re = fft.getReal(transform, bin);
+                                Real im = fft.getImag(transform, bin);
+                                *outputSignal++ = normFactor_[chn] * (re*re + im*im);
+                            }
+                            transform++;
+                        }
                     }
                 }
+                outputIdx += binHi - binLo;
             }
         }
     }
@@ -199,4 +296,12 @@ namespace loudness{
     {
         referenceValue_ = referenceValue;
     }
+
+    void PowerSpectrum::setWindow(const Window::WindowType& windowType,
+                                  bool periodic)
+    {
+        isWindowApplied_ = true;
+        windowType_ = windowType;
+        isWindowPeriodic_ = periodic;
+    }
 }
@@ -22,6 +22,7 @@
 
 #include "../support/Module.h"
 #include "../support/FFT.h"
+#include "Window.h"
 
 namespace loudness{
 
@@ -53,6 +54,12 @@ namespace loudness{
      * that this module can be used in conjunction with \ref Window which can
      * output multiple windowed data frames. 
      *
+     * Alternatively, use setWindow() to apply the windows here, in which case
+     * the input SignalBank should hold a single channel of 2048 samples (e.g.
+     * the output of FrameGenerator). The windows are aligned at their centres
+     * as with \ref Window, and multiplied into the FFT input buffers
+     * directly, so no windowed copy of the frame is made.
+     *
      * The boolean argument @a sampleSpectrumUniformly determines whether all DFT bands
      * are sampled uniformly.  If @a sampleSpectrumUniformly is false, the per band
      * spectrum is sampled non-uniformly at intervals corresponding
@@ -101,16 +108,33 @@ namespace loudness{
 
         void setReferenceValue(Real referenceValue);
 
+        /**
+         * @brief Applies a window, normalised for energy, to the input
+         * frame of each band before the FFT.
+         *
+         * @param windowType The type of window to apply.
+         * @param periodic Periodic if true, symmetric otherwise.
+         */
+        void setWindow(const Window::WindowType& windowType, bool periodic);
+
     private:
         virtual bool initializeInternal(const SignalBank &input);
         virtual bool initializeInternal(){return 0;};
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
+        virtual bool readsRingBuffers() const {return true;};
+        virtual void processBlockInternal(const SignalBank* inputs, int nInputs);
+
+        void processFrames(const SignalBank* inputs, SignalBank* outputs,
+                int nFrames);
 
         RealVec bandFreqsHz_, normFactor_;
-        vector<int> windowSizes_;
-        bool sampleSpectrumUniformly_;
+        vector<int> windowSizes_, windowOffsets_;
+        bool sampleSpectrumUniformly_, isWindowApplied_, isWindowPeriodic_;
+        Window::WindowType windowType_;
+        vector<RealVec> windows_;
         Normalisation normalisation_;
         Real referenceValue_;
         vector<vector<int> > bandBinIndices_; 
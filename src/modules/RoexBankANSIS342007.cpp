@@ -19,6 +19,7 @@
 
 #include "RoexBankANSIS342007.h"
 #include "../support/AuditoryTools.h"
+#include "../support/FastMath.h"
 
 namespace loudness{
 
@@ -26,13 +27,19 @@ namespace loudness{
         Module("RoexBankANSIS342007"),
         camLo_(camLo), 
         camHi_(camHi),
-        camStep_(camStep)
+        camStep_(camStep),
+        weightTolerance_(1e-12)
     {}
 
     RoexBankANSIS342007::~RoexBankANSIS342007()
     {
     }
 
+    void RoexBankANSIS342007::setWeightTolerance(Real weightTolerance)
+    {
+        weightTolerance_ = weightTolerance;
+    }
+
     bool RoexBankANSIS342007::initializeInternal(const SignalBank &input)
     {
         //number of input components
@@ -57,52 +64,117 @@ namespace loudness{
         //see ANSI S3.4 2007 p.11
         const Real p51_1k = 4000.0 / centreFreqToCambridgeERB (1000.0);
 
-        //pcomp is slope per component
-        pcomp_.assign (nChannels, 0.0);
-
-        //comp_level holds level per ERB on each component
-        compLevel_.assign (nChannels, 0.0);
-
-        //p upper is level invariant
-        pu_.assign (nFilters_, 0.0);
-        
-        //p lower is level dependent
-        pl_.assign (nFilters_, 0.0);
-
-        //fill the above arrays
-        Real cam = 0.0, erb = 0.0, fc = 0.0;
+        /* p lower is level dependent:
+         * pu - pl * (L - 51) = pu * (1 - levelSlope * (L - 51))
+         * The right hand factor is computed once per component and p >= 0.1
+         * gives a minimum per filter.
+         */
+        levelSlope_ = 0.35 / p51_1k;
+        levelFactor_.assign (nChannels, 0.0);
+
+        //work space for the lower skirts
+        isFastMathUsed_ = isFastMathEnabled();
+        pg_.assign (nChannels, 0.0);
+        weights_.assign (nChannels, 0.0);
+
+        //largest p * abs(g) giving a weight above tolerance
+        Real pgLo = 0.0, pgHi = 708.0;
+        if (weightTolerance_ > 0)
+        {
+            for (int iter = 0; iter < 100; ++iter)
+            {
+                Real pg = 0.5 * (pgLo + pgHi);
+                if ((1 + pg) * exp (-pg) > weightTolerance_)
+                    pgLo = pg;
+                else
+                    pgHi = pg;
+            }
+        }
+        maxPg_ = pgHi;
+
+        /*
+         * Level independent roex filters centred on every component, used to
+         * compute the level per ERB (ANSI 2007 style)
+         */
+        compWeights_.initialize (nChannels, nChannels);
+        RealVec weights;
         for (int i = 0; i < nChannels; ++i)
         {
-            fc = input.getCentreFreq(i);
-            erb = centreFreqToCambridgeERB (fc);
-            pcomp_[i] = 4.0 * fc / erb;
+            Real fc = input.getCentreFreq(i);
+            Real erb = centreFreqToCambridgeERB (fc);
+            Real pcomp = 4.0 * fc / erb;
+
+            weights.clear();
+            for (int j = 0; j < nChannels; ++j)
+            {
+                //normalised deviation
+                Real g = (input.getCentreFreq(j) - fc) / fc;
+                if (g > 2)
+                    break;
+                Real pg = pcomp * abs (g); //p*abs(g)
+                weights.push_back ((1 + pg) * exp (-pg));
+            }
+            compWeights_.setRow (weights, 0, weightTolerance_);
         }
+
+        /*
+         * Output filters
+         */
+        pu_.assign (nFilters_, 0.0);
+        minLevelFactor_.assign (nFilters_, 0.0);
+        centreBinIdx_.assign (nFilters_, 0);
+        lowerSkirtPg_.resize (nFilters_);
+        upperSkirtWeights_.initialize (nFilters_, nChannels);
         for (int i = 0; i < nFilters_; ++i)
         {
             //filter frequency in Cams
-            cam = camLo_ + (i * camStep_);
+            Real cam = camLo_ + (i * camStep_);
             //filter frequency in Hz
-            fc = camToHertz (cam);
+            Real fc = camToHertz (cam);
             //get the ERB of the filter
-            erb = centreFreqToCambridgeERB (fc);
+            Real erb = centreFreqToCambridgeERB (fc);
             //ANSI S3.4 sec 3.5 p.11
             pu_[i] = 4.0 * fc / erb;
-            pl_[i] = 0.35 * (pu_[i] / p51_1k);
+            //p = max(pu * levelFactor, 0.1), p can go negative for very high
+            //levels
+            minLevelFactor_[i] = 0.1 / pu_[i];
             output_.setCentreFreq (i, fc);
+
+            //lower skirt: p * abs(g) without the level factor
+            int j = 0;
+            lowerSkirtPg_[i].clear();
+            while ((j < nChannels) && (input.getCentreFreq(j) < fc))
+            {
+                Real g = (input.getCentreFreq(j) - fc) / fc;
+                lowerSkirtPg_[i].push_back (-pu_[i] * g);
+                j++;
+            }
+            centreBinIdx_[i] = j;
+
+            //upper skirt: level invariant
+            weights.clear();
+            while (j < nChannels)
+            {
+                Real g = (input.getCentreFreq(j) - fc) / fc;
+                if (g > 2)
+                    break;
+                Real pg = pu_[i] * g;
+                weights.push_back ((1 + pg) * exp (-pg));
+                j++;
+            }
+            upperSkirtWeights_.setRow (weights, centreBinIdx_[i], weightTolerance_);
         }
 
         return 1;
     }
 
-
     void RoexBankANSIS342007::processInternal(const SignalBank &input)
     {
+        int nChannels = input.getNChannels();
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for (int ear = 0; ear < input.getNEars(); ++ear)
             {
-                Real excitationLin = 0.0, fc = 0.0, g = 0.0, p = 0.0, pg = 0.0;
-                int nChannels = input.getNChannels();
                 const Real* inputPowerSpectrum = input
                                                  .getSingleSampleReadPointer
                                                  (src, ear, 0);
@@ -112,60 +184,59 @@ namespace loudness{
 
                 //ANSI 2007 style: calculate level per ERB
                 //using level independent roex filters centred on every component
-                int j = 0;
+                //levels (minus 51 dB) are floored at -151 dB
+                Real minLevelFactor = 1.0 + levelSlope_ * 151.0;
                 for (int i = 0; i < nChannels; ++i)
                 {
-                    excitationLin = 0.0;
-                    j = 0;
-                    fc = input.getCentreFreq(i);
-
-                    while (j < nChannels)
-                    {
-                        //normalised deviation
-                        g = (input.getCentreFreq(j) - fc) / fc;
-
-                        if (g > 2)
-                            break;
-                        if (g < 0) //lower value 
-                            pg = -pcomp_[i] * g; //p*abs(g)
-                        else //upper value
-                            pg = pcomp_[i] * g;
-                        //excitation per erb
-                        excitationLin += (1 + pg) * exp (-pg) * inputPowerSpectrum[j++];
-                    }
+                    Real excitationLin = compWeights_.dot (i, inputPowerSpectrum);
 
                     //convert to dB, subtract 51 here to save operations later
-                    compLevel_[i] = powerToDecibels (excitationLin, 1e-10, -100.0) - 51;
+                    Real compLevel = powerToDecibels (excitationLin, (Real)1e-10, (Real)-100.0) - 51;
+
+                    //level dependent part of Eq (3)
+                    levelFactor_[i] = 1.0 - levelSlope_ * compLevel;
+                    minLevelFactor = min (minLevelFactor, levelFactor_[i]);
                 }
                 
                 //now the excitation pattern
                 for (int i = 0; i < nFilters_; ++i)
                 {
-                    excitationLin = 0.0;
-                    j = 0;
-                    fc = output_.getCentreFreq(i);
+                    const Real* lowerSkirtPg = lowerSkirtPg_[i].data();
+                    Real minFilterLevelFactor = minLevelFactor_[i];
+
+                    /* Lower skirt: p * abs(g) decreases towards the centre
+                     * frequency, so components giving weights below tolerance
+                     * at the highest level of the frame are skipped. 
+                     */
+                    Real levelFactor = max (minLevelFactor, minFilterLevelFactor);
+                    int start = 0, end = centreBinIdx_[i];
+                    while (start < end)
+                    {
+                        int mid = (start + end) / 2;
+                        if (levelFactor * lowerSkirtPg[mid] >= maxPg_)
+                            start = mid + 1;
+                        else
+                            end = mid;
+                    }
 
-                    while (j < nChannels)
+                    int nLower = centreBinIdx_[i] - start;
+                    for (int j = 0; j < nLower; ++j)
                     {
-                        //normalised deviation
-                        g = (input.getCentreFreq(j) - fc) / fc;
-
-                        if (g > 2)
-                            break;
-                        if (g < 0) //lower value 
-                        {
-                            //checked out 2.4.14
-                            p = pu_[i] - (pl_[i] * compLevel_[j]); //51dB subtracted above
-                            p = max(0.1, p); //p can go negative for very high levels
-                            pg = -p * g; //p*abs(g)
-                        }
-                        else //upper value
-                        {
-                            pg = pu_[i] * g;
-                        }
-
-                        excitationLin += (1 + pg) * exp(-pg) * inputPowerSpectrum[j++];
+                        //checked out 2.4.14
+                        pg_[j] = max (levelFactor_[start + j], minFilterLevelFactor) *
+                                 lowerSkirtPg[start + j];
+                        weights_[j] = -pg_[j];
                     }
+                    vectorExp (weights_.data(), weights_.data(), nLower,
+                               isFastMathUsed_);
+
+                    Real excitationLin = 0.0;
+                    const Real* lowerInput = inputPowerSpectrum + start;
+                    for (int j = 0; j < nLower; ++j)
+                        excitationLin += (1 + pg_[j]) * weights_[j] * lowerInput[j];
+
+                    //upper skirt
+                    excitationLin += upperSkirtWeights_.dot (i, inputPowerSpectrum);
 
                     outputExcitationPattern[i] = excitationLin;
                 }
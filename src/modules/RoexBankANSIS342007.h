@@ -21,6 +21,7 @@
 #define ROEXBANKANSIS342007_H
 
 #include "../support/Module.h"
+#include "../support/SparseMatrix.h"
 
 namespace loudness{
 
@@ -30,6 +31,16 @@ namespace loudness{
      * @brief Applies a set of level dependent rounded exponential (roex)
      * filters to an input power spectrum. 
      *
+     * The level independent filters used to compute the level per ERB about
+     * each component, and the upper skirts of the output filters, are
+     * computed on initialisation and stored as sparse matrices. Weights below
+     * the tolerance given by setWeightTolerance() are dropped. The lower
+     * skirts depend on the input level and are computed on every frame,
+     * using fastExp() if enabled by setFastMathEnabled(), over the
+     * components giving weights above the tolerance. Dropping weights changes
+     * the excitation by at most the tolerance times the total input power;
+     * fastExp() changes it by less than 1e-15 of its value.
+     *
      * This implementation follows:
      *
      * ANSI. (2007). ANSI S3.4-2007. Procedure for the Computation of Loudness
@@ -51,16 +62,26 @@ namespace loudness{
 
         virtual ~RoexBankANSIS342007();
 
+        /** Sets the tolerance below which filter weights are dropped
+         * (default is 1e-12). */
+        void setWeightTolerance(Real weightTolerance);
+
     private:
         virtual bool initializeInternal(const SignalBank &input);
         virtual bool initializeInternal(){return 0;};
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
 
         int nFilters_;
-        Real camLo_, camHi_, camStep_;
-        RealVec pu_, pl_, pcomp_, compLevel_;
+        bool isFastMathUsed_;
+        Real camLo_, camHi_, camStep_, weightTolerance_;
+        Real levelSlope_, maxPg_;
+        vector<int> centreBinIdx_;
+        RealVec pu_, minLevelFactor_, levelFactor_, pg_, weights_;
+        RealVecVec lowerSkirtPg_;
+        SparseMatrix compWeights_, upperSkirtWeights_;
     };
 }
 
@@ -18,6 +18,7 @@
  */
 
 #include "SpecificLoudnessANSIS342007.h"
+#include "../support/FastMath.h"
 
 namespace loudness{
 
@@ -103,26 +104,51 @@ namespace loudness{
                     << parameterC_);
         }
 
+        //high level
+        if (useANSISpecificLoudness_)
+        {
+            highLevelDivisor_ = 1.0707;
+            highLevelExponent_ = 0.2;
+        }
+        else
+        {
+            highLevelDivisor_ = 1.04e6;
+            highLevelExponent_ = 0.5;
+        }
+
         //Number of filters below 500Hz
         nFiltersLT500_ = 0;
 
+        //fill loudness parameter vectors, variables are constant >= 500 Hz
+        int nChannels = input.getNChannels();
+        eThrqParam_.assign (nChannels, 2.3604782331805771);
+        parameterG_.assign (nChannels, 1.0);
+        parameterA_.assign (nChannels, 4.72096);
+        parameterAlpha_.assign (nChannels, 0.2);
+        parameterAPowAlpha_.assign (nChannels, 1.3639739128330546);
+
         Real eThrqdB500Hz = internalExcitation(500);
-        //fill loudness parameter vectors
-        for (int i = 0; i < input.getNChannels(); i++)
+        for (int i = 0; i < nChannels; i++)
         {
             Real fc = input.getCentreFreq(i);
             if (fc < 500)
             {
                 Real eThrqdB = internalExcitation(fc);
-                eThrqParam_.push_back(pow(10, eThrqdB/10.0));
+                eThrqParam_[i] = pow(10, eThrqdB/10.0);
                 Real gdB = eThrqdB500Hz - eThrqdB;
-                parameterG_.push_back(pow(10, gdB/10.0));
-                parameterA_.push_back(gdBToA(gdB));
-                parameterAlpha_.push_back(gdBToAlpha(gdB));
+                parameterG_[i] = pow(10, gdB/10.0);
+                parameterA_[i] = gdBToA(gdB);
+                parameterAlpha_[i] = gdBToAlpha(gdB);
+                parameterAPowAlpha_[i] = pow(parameterA_[i], parameterAlpha_[i]);
                 nFiltersLT500_++;
             }
         }
 
+        isFastMathUsed_ = isFastMathEnabled();
+        mediumLevelTerm_.assign (nChannels, 0.0);
+        lowLevelTerm_.assign (nChannels, 0.0);
+        highLevelTerm_.assign (nChannels, 0.0);
+
         LOUDNESS_DEBUG(name_ << ": number of filters <500 Hz: " << nFiltersLT500_);
 
         //output SignalBank
@@ -133,11 +159,11 @@ namespace loudness{
 
     void SpecificLoudnessANSIS342007::processInternal(const SignalBank &input)
     {
+        int nChannels = input.getNChannels();
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for (int ear = 0; ear < input.getNEars(); ++ear)
             {
-                Real excLin, sl = 0.0;
                 const Real* inputExcitationPattern = input
                                                      .getSingleSampleReadPointer
                                                      (src, ear, 0);
@@ -145,47 +171,51 @@ namespace loudness{
                                                .getSingleSampleWritePointer
                                                (src, ear, 0);
 
-                for (int i = 0; i < input.getNChannels(); ++i)
+                //checked out 2.4.14
+                //terms of all cases for every channel
+                Real maxExcitation = 0.0;
+                for (int i = 0; i < nChannels; ++i)
                 {
-                    excLin = inputExcitationPattern[i];
+                    Real excLin = inputExcitationPattern[i];
+                    maxExcitation = excLin > maxExcitation ? excLin : maxExcitation;
+
+                    //medium level
+                    mediumLevelTerm_[i] = parameterG_[i] * excLin + parameterA_[i];
+
+                    //low level, no change above threshold
+                    Real ratio = (2 * excLin) / (excLin + eThrqParam_[i]);
+                    lowLevelTerm_[i] = excLin > eThrqParam_[i] ? 1.0 : ratio;
 
-                    //checked out 2.4.14
                     //high level
-                    if (excLin > 1e10)
+                    highLevelTerm_[i] = excLin / highLevelDivisor_;
+                }
+
+                vectorPow (mediumLevelTerm_.data(), parameterAlpha_.data(),
+                           mediumLevelTerm_.data(), nChannels, isFastMathUsed_);
+                vectorPow (lowLevelTerm_.data(), 1.5, lowLevelTerm_.data(),
+                           nChannels, isFastMathUsed_);
+
+                if (maxExcitation > 1e10)
+                {
+                    vectorPow (highLevelTerm_.data(), highLevelExponent_,
+                               highLevelTerm_.data(), nChannels, isFastMathUsed_);
+
+                    for (int i = 0; i < nChannels; ++i)
                     {
-                        if (useANSISpecificLoudness_)
-                            sl = pow((excLin/1.0707), 0.2);
-                        else
-                            sl = pow((excLin/1.04e6), 0.5);
+                        Real sl = lowLevelTerm_[i] *
+                                  (mediumLevelTerm_[i] - parameterAPowAlpha_[i]);
+                        sl = inputExcitationPattern[i] > 1e10 ? highLevelTerm_[i] : sl;
+                        outputSpecificLoudness[i] = parameterC_ * sl;
                     }
-                    else if (i < nFiltersLT500_) //low freqs
-                    { 
-                        if (excLin > eThrqParam_[i]) //medium level
-                        {
-                            sl = (pow(parameterG_[i]*excLin+parameterA_[i], parameterAlpha_[i]) -
-                                    pow(parameterA_[i], parameterAlpha_[i]));
-                        }
-                        else //low level
-                        {
-                            sl = pow((2*excLin)/(excLin+eThrqParam_[i]), 1.5) *
-                                (pow(parameterG_[i]*excLin+parameterA_[i], parameterAlpha_[i])
-                                    - pow(parameterA_[i], parameterAlpha_[i]));
-                        }
-                    }
-                    else //high freqs (variables are constant >= 500 Hz)
-                    { 
-                        if (excLin > 2.3604782331805771) //medium level
-                        {
-                            sl = pow(excLin+4.72096, 0.2)-1.3639739128330546;
-                        } 
-                        else //low level
-                        {
-                            sl = pow((2*excLin)/(excLin+2.3604782331805771), 1.5) *
-                                (pow(excLin+4.72096, 0.2)-1.3639739128330546);
-                        }
+                }
+                else
+                {
+                    for (int i = 0; i < nChannels; ++i)
+                    {
+                        Real sl = lowLevelTerm_[i] *
+                                  (mediumLevelTerm_[i] - parameterAPowAlpha_[i]);
+                        outputSpecificLoudness[i] = parameterC_ * sl;
                     }
-                    
-                    outputSpecificLoudness[i] = parameterC_ * sl;
                 }
             }
         }
@@ -44,6 +44,10 @@ namespace loudness{
      * Note that the specific loudness parameters are approximated using
      * polynomials rather than interpolted values as used by the ANSI S3.4 2007
      * standard.
+     *
+     * The equations are evaluated for all channels before selecting the
+     * relevant case for each, using the fast elementary functions if
+     * enabled by setFastMathEnabled().
      */
     class SpecificLoudnessANSIS342007 : public Module
     {
@@ -89,11 +93,14 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
 
         bool useANSISpecificLoudness_, updateParameterCForBinauralInhibition_;
+        bool isFastMathUsed_;
         int nFiltersLT500_;
-        Real parameterC_;
+        Real parameterC_, highLevelDivisor_, highLevelExponent_;
         RealVec eThrqParam_, parameterG_, parameterA_, parameterAlpha_;
+        RealVec parameterAPowAlpha_, mediumLevelTerm_, lowLevelTerm_, highLevelTerm_;
     };
 }
 
@@ -18,6 +18,7 @@
  */
 
 #include "SpecificLoudnessModANSIS342007.h"
+#include "../support/FastMath.h"
 
 namespace loudness{
 
@@ -103,25 +104,41 @@ namespace loudness{
                     << parameterC_);
         }
 
+        int nChannels = input.getNChannels();
+        LOUDNESS_ASSERT((int)parameterAlpha_.size() >= nChannels,
+                name_ << ": Insufficient number of alpha values.");
+
         //Number of filters below 500Hz
         nFiltersLT500_ = 0;
 
+        //fill loudness parameter vectors, G and A are constant >= 500 Hz
+        eThrqParam_.assign (nChannels, 2.3604782331805771);
+        parameterG_.assign (nChannels, 1.0);
+        parameterA_.assign (nChannels, 4.72096);
+
         Real eThrqdB500Hz = internalExcitation(500);
-        //fill loudness parameter vectors
-        for (int i = 0; i < input.getNChannels(); i++)
+        for (int i = 0; i < nChannels; i++)
         {
             Real fc = input.getCentreFreq(i);
             if (fc < 500)
             {
                 Real eThrqdB = internalExcitation(fc);
-                eThrqParam_.push_back(pow(10, eThrqdB/10.0));
+                eThrqParam_[i] = pow(10, eThrqdB/10.0);
                 Real gdB = eThrqdB500Hz - eThrqdB;
-                parameterG_.push_back(pow(10, gdB/10.0));
-                parameterA_.push_back(gdBToA(gdB));
+                parameterG_[i] = pow(10, gdB/10.0);
+                parameterA_[i] = gdBToA(gdB);
                 nFiltersLT500_++;
             }
         }
 
+        parameterAPowAlpha_.assign (nChannels, 0.0);
+        for (int i = 0; i < nChannels; i++)
+            parameterAPowAlpha_[i] = std::pow (parameterA_[i], parameterAlpha_[i]);
+
+        isFastMathUsed_ = isFastMathEnabled();
+        mediumLevelTerm_.assign (nChannels, 0.0);
+        lowLevelTerm_.assign (nChannels, 0.0);
+
         LOUDNESS_DEBUG(name_ << ": number of filters <500 Hz: " << nFiltersLT500_);
 
         //output SignalBank
@@ -132,11 +149,11 @@ namespace loudness{
 
     void SpecificLoudnessModANSIS342007::processInternal(const SignalBank &input)
     {
+        int nChannels = input.getNChannels();
         for (int src = 0; src < input.getNSources(); ++src)
         {
             for (int ear = 0; ear < input.getNEars(); ++ear)
             {
-                Real excLin, sl = 0.0;
                 const Real* inputExcitationPattern = input
                                                      .getSingleSampleReadPointer
                                                      (src, ear, 0);
@@ -144,44 +161,29 @@ namespace loudness{
                                                .getSingleSampleWritePointer
                                                (src, ear, 0);
 
-                for (int i = 0; i < input.getNChannels(); ++i)
+                //checked out 2.4.14
+                //terms of both cases for every channel
+                for (int i = 0; i < nChannels; ++i)
+                {
+                    Real excLin = inputExcitationPattern[i];
+
+                    //medium level
+                    mediumLevelTerm_[i] = parameterG_[i] * excLin + parameterA_[i];
+
+                    //low level, no change above threshold
+                    Real ratio = (2 * excLin) / (excLin + eThrqParam_[i]);
+                    lowLevelTerm_[i] = excLin > eThrqParam_[i] ? 1.0 : ratio;
+                }
+
+                vectorPow (mediumLevelTerm_.data(), parameterAlpha_.data(),
+                           mediumLevelTerm_.data(), nChannels, isFastMathUsed_);
+                vectorPow (lowLevelTerm_.data(), 1.5, lowLevelTerm_.data(),
+                           nChannels, isFastMathUsed_);
+
+                for (int i = 0; i < nChannels; ++i)
                 {
-                    excLin = inputExcitationPattern[i];
-
-                    //checked out 2.4.14
-                    //high level
-                    if (i < nFiltersLT500_) //low freqs
-                    { 
-                        if (excLin > eThrqParam_[i]) //medium level
-                        {
-                            sl = (std::pow (parameterG_[i]*excLin+parameterA_[i],
-                                        parameterAlpha_[i]) -
-                                    std::pow (parameterA_[i], parameterAlpha_[i]));
-                        }
-                        else //low level
-                        {
-                            sl = std::pow ((2*excLin)/
-                                    (excLin+eThrqParam_[i]), 1.5) *
-                                (std::pow (parameterG_[i] * excLin+parameterA_[i],
-                                     parameterAlpha_[i]) -
-                                 std::pow (parameterA_[i], parameterAlpha_[i]));
-                        }
-                    }
-                    else //high freqs
-                    { 
-                        if (excLin > 2.3604782331805771) //medium level
-                        {
-                            sl = (std::pow (excLin + 4.72096, parameterAlpha_[i]) -
-                                    std::pow (4.72096, parameterAlpha_[i]));
-                        } 
-                        else //low level
-                        {
-                            sl = std::pow ((2*excLin)/(excLin+2.3604782331805771), 1.5) *
-                                (std::pow (excLin+4.72096, parameterAlpha_[i]) - 
-                                 std::pow (4.72096, parameterAlpha_[i]));
-                        }
-                    }
-                    
+                    Real sl = lowLevelTerm_[i] *
+                              (mediumLevelTerm_[i] - parameterAPowAlpha_[i]);
                     outputSpecificLoudness[i] = parameterC_ * sl;
                 }
             }
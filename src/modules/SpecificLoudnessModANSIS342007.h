@@ -44,6 +44,9 @@ namespace loudness{
      * Note that the specific loudness parameters are approximated using
      * polynomials rather than interpolted values as used by the ANSI S3.4 2007
      * standard.
+     *
+     * As for SpecificLoudnessANSIS342007, the equations are evaluated for all
+     * channels before selecting the relevant case for each.
      */
     class SpecificLoudnessModANSIS342007 : public Module
     {
@@ -93,9 +96,11 @@ namespace loudness{
 
         RealVec parameterAlpha_;
         bool useANSISpecificLoudness_, updateParameterCForBinauralInhibition_;
+        bool isFastMathUsed_;
         int nFiltersLT500_;
         Real parameterC_;
-        RealVec eThrqParam_, parameterG_, parameterA_;
+        RealVec eThrqParam_, parameterG_, parameterA_, parameterAPowAlpha_;
+        RealVec mediumLevelTerm_, lowLevelTerm_;
     };
 }
 
@@ -45,6 +45,9 @@ namespace loudness{
 
         output_.initialize (input);
 
+        //total excitation of all sources
+        eTot_.assign (input.getNChannels(), 0.0);
+
         return 1;
     }
 
@@ -57,7 +60,7 @@ namespace loudness{
              * from all sources? They don't specify this in the paper...
              * Just go simple linear approach for now.
              */
-            RealVec eTot (input.getNChannels(), 0.0);
+            std::fill (eTot_.begin(), eTot_.end(), 0.0);
             for (int src = 0; src < input.getNSources(); ++src)
             {
                 const Real* inputExcitation = input
@@ -65,7 +68,7 @@ namespace loudness{
                                               (src, ear, 0);
 
                 for (int chn = 0; chn < input.getNChannels(); ++chn)
-                    eTot[chn] += inputExcitation[chn];
+                    eTot_[chn] += inputExcitation[chn];
             }
 
             // Now do partial loudness calculation
@@ -79,14 +82,14 @@ namespace loudness{
                                          .getSingleSampleWritePointer
                                          (src, ear, 0);
 
+                //branch-free: the difference is positive if and only if the
+                //excitation exceeds the threshold
                 for (int chn = 0; chn < input.getNChannels(); ++chn)
                 {
-                    Real eNoise = eTot[chn] - inputExcitation[chn];
+                    Real eNoise = eTot_[chn] - inputExcitation[chn];
                     Real threshold = k_[chn] * eNoise;
-                    if (inputExcitation[chn] > threshold)
-                        outputExcitation[chn] = inputExcitation[chn] - threshold;
-                    else
-                        outputExcitation[chn] = 0.0;
+                    Real excess = inputExcitation[chn] - threshold;
+                    outputExcitation[chn] = excess > 0 ? excess : 0.0;
                 }
             }
         }
@@ -38,8 +38,9 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
 
-        RealVec k_;
+        RealVec k_, eTot_;
     };
 }
 #endif
@@ -18,6 +18,7 @@
  */
 
 #include "SpecificPartialLoudnessMGB1997.h"
+#include "../support/FastMath.h"
 
 namespace loudness{
 
@@ -134,6 +135,13 @@ namespace loudness{
 
         Real eThrqdB500Hz = internalExcitation(500);
         //fill loudness parameter vectors
+        eThrqParam_.clear();
+        gParam_.clear();
+        aParam_.clear();
+        alphaParam_.clear();
+        kParam_.clear();
+        aPowAlpha_.clear();
+        eThrqPowAlpha_.clear();
         for (int i = 0; i < input.getNChannels(); i++)
         {
             Real fc = input.getCentreFreq (i);
@@ -144,31 +152,59 @@ namespace loudness{
             aParam_.push_back (gdBToA (gdB));
             alphaParam_.push_back (gdBToAlpha (gdB));
             kParam_.push_back (std::pow (10, kdB (fc) / 10.0));
+
+            //terms at threshold in quiet
+            aPowAlpha_.push_back (std::pow (aParam_[i], alphaParam_[i]));
+            eThrqPowAlpha_.push_back (std::pow (eThrqParam_[i] * gParam_[i] +
+                        aParam_[i], alphaParam_[i]));
         }
 
         //output SignalBank
         output_.initialize (input);
 
+        //total excitation of all sources
+        int nChannels = input.getNChannels();
+        eTot_.assign (nChannels, 0.0);
+
+        //terms of Equations 17 to 20
+        isFastMathUsed_ = isFastMathEnabled();
+        eNoise_.assign (nChannels, 0.0);
+        eThrn_.assign (nChannels, 0.0);
+        totalTerm_.assign (nChannels, 0.0);
+        noiseThresholdTerm_.assign (nChannels, 0.0);
+        noiseTerm_.assign (nChannels, 0.0);
+        thresholdRatio_.assign (nChannels, 0.0);
+        signalRatio_.assign (nChannels, 0.0);
+        totalHighTerm_.assign (nChannels, 0.0);
+        noiseThresholdHighTerm_.assign (nChannels, 0.0);
+        noiseHighTerm_.assign (nChannels, 0.0);
+
         return 1;
     }
 
     void SpecificPartialLoudnessMGB1997::processInternal(const SignalBank &input)
     {
+        int nChannels = input.getNChannels();
         for (int ear = 0; ear < input.getNEars(); ++ear)
         {
             // excitations were calculated using same roex shapes
             // so linear superposition of excitations applies
-            RealVec eTot (input.getNChannels(), 0.0);
+            std::fill (eTot_.begin(), eTot_.end(), 0.0);
             for (int src = 0; src < input.getNSources(); ++src)
             {
                 const Real* currentSignal = input
                                             .getSingleSampleReadPointer
                                             (src, ear, 0);
 
-                for (int chn = 0; chn < input.getNChannels(); ++chn)
-                    eTot[chn] += currentSignal[chn];
+                for (int chn = 0; chn < nChannels; ++chn)
+                    eTot_[chn] += currentSignal[chn];
             }
 
+            Real maxETot = 0.0;
+            for (int chn = 0; chn < nChannels; ++chn)
+                maxETot = eTot_[chn] > maxETot ? eTot_[chn] : maxETot;
+            bool isHighLevel = maxETot > 1e10;
+
             // Loudness for each source in the presence of all other sources
             for (int src = 0; src < input.getNSources(); ++src)
             {
@@ -180,86 +216,83 @@ namespace loudness{
                                  .getSingleSampleWritePointer
                                  (src, ear, 0);
 
-                for (int chn = 0; chn < input.getNChannels(); ++chn)
+                // Bases of the powers in Equations 17 to 20
+                for (int chn = 0; chn < nChannels; ++chn)
                 {
-                    Real eNoise = eTot[chn] - eSig[chn];
+                    Real eNoise = eTot_[chn] - eSig[chn];
                     Real eThrn = kParam_[chn] * eNoise + eThrqParam_[chn];
-                    Real nSig = 0.0;
+                    eNoise_[chn] = eNoise;
+                    eThrn_[chn] = eThrn;
+
+                    totalTerm_[chn] = eTot_[chn] * gParam_[chn] + aParam_[chn];
+                    noiseThresholdTerm_[chn] = gParam_[chn] * (eNoise + eThrn) +
+                                               aParam_[chn];
+                    noiseTerm_[chn] = eNoise * gParam_[chn] + aParam_[chn];
+                    thresholdRatio_[chn] = eThrn / eSig[chn];
+                    signalRatio_[chn] = 2.0 * eSig[chn] / (eSig[chn] + eThrn);
+                    noiseThresholdHighTerm_[chn] = eNoise + eThrn;
+                }
+
+                vectorPow (totalTerm_.data(), alphaParam_.data(),
+                           totalTerm_.data(), nChannels, isFastMathUsed_);
+                vectorPow (noiseThresholdTerm_.data(), alphaParam_.data(),
+                           noiseThresholdTerm_.data(), nChannels, isFastMathUsed_);
+                vectorPow (noiseTerm_.data(), alphaParam_.data(),
+                           noiseTerm_.data(), nChannels, isFastMathUsed_);
+                vectorPow (thresholdRatio_.data(), 0.3,
+                           thresholdRatio_.data(), nChannels, isFastMathUsed_);
+                vectorPow (signalRatio_.data(), 1.5,
+                           signalRatio_.data(), nChannels, isFastMathUsed_);
+
+                if (isHighLevel)
+                {
+                    vectorPow (eTot_.data(), yearExp_, totalHighTerm_.data(),
+                               nChannels, isFastMathUsed_);
+                    vectorPow (noiseThresholdHighTerm_.data(), yearExp_,
+                               noiseThresholdHighTerm_.data(), nChannels,
+                               isFastMathUsed_);
+                    vectorPow (eNoise_.data(), yearExp_, noiseHighTerm_.data(),
+                               nChannels, isFastMathUsed_);
+                }
 
-                    if (eSig[chn] > 1e-10)
+                for (int chn = 0; chn < nChannels; ++chn)
+                {
+                    // Equation 17
+                    Real nSig17 = parameterC_ * (totalTerm_[chn] -
+                                  aPowAlpha_[chn]);
+                    nSig17 -= parameterC_ * (noiseThresholdTerm_[chn] -
+                              eThrqPowAlpha_[chn]) * thresholdRatio_[chn];
+
+                    // Equation 18
+                    Real nSig18 = parameterC_ * signalRatio_[chn];
+                    nSig18 *= (eThrqPowAlpha_[chn] - aPowAlpha_[chn]) /
+                              (noiseThresholdTerm_[chn] - noiseTerm_[chn]);
+                    nSig18 *= totalTerm_[chn] - noiseTerm_[chn];
+
+                    Real nSig = eSig[chn] >= eThrn_[chn] ? nSig17 : nSig18;
+                    specLoud[chn] = eSig[chn] > 1e-10 ? nSig : 0.0;
+                }
+
+                if (isHighLevel)
+                {
+                    for (int chn = 0; chn < nChannels; ++chn)
                     {
-                        if (eTot[chn] > 1e10)
-                        {
-                            if (eSig[chn] >= eThrn) // Equation 19
-                            {
-                                nSig = parameterC2_ *
-                                       std::pow (eTot[chn], yearExp_);
-
-                                nSig -= parameterC2_ * 
-                                        (std::pow (eNoise + eThrn, yearExp_) -
-                                        std::pow (eThrqParam_[chn] *
-                                        gParam_[chn] + aParam_[chn],
-                                        alphaParam_[chn]) +
-                                        std::pow (aParam_[chn],
-                                        alphaParam_[chn])) *
-                                        std::pow (eThrn / eSig[chn], 0.3);
-                            }
-                            else // Equation 20
-                            {
-                                nSig = parameterC_ * std::pow (2.0 * eSig[chn]
-                                       / (eSig[chn] + eThrn), 1.5);
-
-                                nSig *= (std::pow (eThrqParam_[chn] *
-                                        gParam_[chn] + aParam_[chn],
-                                        alphaParam_[chn]) - 
-                                        std::pow (aParam_[chn],
-                                        alphaParam_[chn])) /
-                                        (std::pow (eNoise + eThrn, yearExp_) -
-                                        std::pow(eNoise, yearExp_));
-                                nSig *= std::pow (eTot[chn], yearExp_)
-                                        - std::pow (eNoise, yearExp_);
-                            }
-                        }
-                        else // eTot <= 100 dB
-                        {
-                            if (eSig[chn] >= eThrn) // Equation 17
-                            {
-                                nSig = parameterC_ * (std::pow (eTot[chn]
-                                       * gParam_[chn] + aParam_[chn],
-                                       alphaParam_[chn]) - std::pow (
-                                       aParam_[chn], alphaParam_[chn]));
-
-                                nSig -= parameterC_ * (std::pow (
-                                       gParam_[chn] * (eNoise + eThrn) +
-                                       aParam_[chn], alphaParam_[chn]) -
-                                       std::pow (eThrqParam_[chn] * gParam_[chn]
-                                       + aParam_[chn], alphaParam_[chn]))
-                                       * std::pow (eThrn / eSig[chn], 0.3);
-                            }
-                            else // Equation 18
-                            {
-                                nSig = parameterC_ * std::pow (2.0 * eSig[chn]
-                                       / (eSig[chn] + eThrn), 1.5);
-                                
-                                nSig *= (std::pow (eThrqParam_[chn] *
-                                        gParam_[chn] + aParam_[chn],
-                                        alphaParam_[chn]) - std::pow (
-                                        aParam_[chn], alphaParam_[chn])) /
-                                        (std::pow ((eNoise + eThrn) *
-                                        gParam_[chn] + aParam_[chn],
-                                        alphaParam_[chn]) - std::pow (
-                                        eNoise * gParam_[chn] + aParam_[chn],
-                                        alphaParam_[chn]));
-
-                                nSig *= std::pow (eTot[chn] * gParam_[chn] +
-                                        aParam_[chn], alphaParam_[chn]) -
-                                        std::pow (eNoise * gParam_[chn] +
-                                        aParam_[chn], alphaParam_[chn]);
-                            }
-                        }
-                    }
+                        // Equation 19
+                        Real nSig19 = parameterC2_ * totalHighTerm_[chn];
+                        nSig19 -= parameterC2_ * (noiseThresholdHighTerm_[chn] -
+                                  eThrqPowAlpha_[chn] + aPowAlpha_[chn]) *
+                                  thresholdRatio_[chn];
 
-                    specLoud[chn] = nSig;
+                        // Equation 20
+                        Real nSig20 = parameterC_ * signalRatio_[chn];
+                        nSig20 *= (eThrqPowAlpha_[chn] - aPowAlpha_[chn]) /
+                                  (noiseThresholdHighTerm_[chn] - noiseHighTerm_[chn]);
+                        nSig20 *= totalHighTerm_[chn] - noiseHighTerm_[chn];
+
+                        Real nSig = eSig[chn] >= eThrn_[chn] ? nSig19 : nSig20;
+                        nSig = eSig[chn] > 1e-10 ? nSig : 0.0;
+                        specLoud[chn] = eTot_[chn] > 1e10 ? nSig : specLoud[chn];
+                    }
                 }
             }
         }
@@ -44,6 +44,12 @@ namespace loudness{
      * Note that the specific loudness parameters are approximated using
      * polynomials rather than interpolted values as used by the ANSI S3.4 2007
      * standard.
+     *
+     * The terms of Equations 17 to 20 are evaluated for all channels before
+     * selecting the relevant case for each, using the fast elementary
+     * functions if enabled by setFastMathEnabled(). The high level cases
+     * (Equations 19 and 20) are only evaluated when the total excitation
+     * exceeds 100 dB in some channel.
      */
     class SpecificPartialLoudnessMGB1997 : public Module
     {
@@ -98,10 +104,16 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
 
         bool useANSISpecificLoudness_, updateParameterCForBinauralInhibition_;
+        bool isFastMathUsed_;
         Real parameterC_, parameterC2_, yearExp_;
-        RealVec eThrqParam_, gParam_, aParam_, alphaParam_, kParam_;
+        RealVec eThrqParam_, gParam_, aParam_, alphaParam_, kParam_, eTot_;
+        RealVec aPowAlpha_, eThrqPowAlpha_;
+        RealVec eNoise_, eThrn_, totalTerm_, noiseThresholdTerm_, noiseTerm_;
+        RealVec thresholdRatio_, signalRatio_;
+        RealVec totalHighTerm_, noiseThresholdHighTerm_, noiseHighTerm_;
     };
 }
 
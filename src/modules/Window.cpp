@@ -64,7 +64,7 @@ namespace loudness{
         LOUDNESS_DEBUG(name_ << ": Largest window size = " << largestWindowSize_);
 
         //first window (largest) does not require a shift
-        windowOffset_.push_back(0);
+        windowOffset_.assign(1, 0);
 
         //check if we are using multi windows on one input channel
         int nOutputChannels = input.getNChannels();
@@ -85,7 +85,7 @@ namespace loudness{
                 LOUDNESS_DEBUG(name_ << ": Offset for window " << w << " = " << thisWindowOffset);
             }
         }
-        else if ((input.getNChannels() > 1) & (nWindows_ == 1))
+        else if (nWindows_ == 1)
         {
             method_ = MULTI_CHANNEL_ONE_WINDOW;
         }
@@ -115,6 +115,23 @@ namespace loudness{
         return 1;
     }
 
+    void Window::applyWindow(const RealVec& window,
+                             const Real* inputSignal,
+                             int nInputSamples,
+                             int readIdx,
+                             Real* outputSignal)
+    {
+        //the input may be a circular buffer, so read up to two segments
+        int length = window.size();
+        readIdx %= nInputSamples;
+        int nSamplesToEnd = min(length, nInputSamples - readIdx);
+        const Real* inputSegment = inputSignal + readIdx;
+        for (int smp = 0; smp < nSamplesToEnd; ++smp)
+            outputSignal[smp] = window[smp] * inputSegment[smp];
+        for (int smp = nSamplesToEnd; smp < length; ++smp)
+            outputSignal[smp] = window[smp] * inputSignal[smp - nSamplesToEnd];
+    }
+
     void Window::processInternal(const SignalBank &input)
     {
         switch (method_)
@@ -131,8 +148,7 @@ namespace loudness{
                                                       .getSignalReadPointer(
                                                           src,
                                                           ear,
-                                                          0,
-                                                          windowOffset_[w]);
+                                                          0);
                             Real* outputSignal = output_
                                                  .getSignalWritePointer(
                                                      src,
@@ -140,14 +156,15 @@ namespace loudness{
                                                      w,
                                                      0);
 
-                            for(int smp = 0; smp < length_[w]; ++smp)
-                            {
-                                outputSignal[smp] = window_[w][smp]
-                                                    * inputSignal[smp];
-                            }
+                            applyWindow(window_[w], inputSignal,
+                                        input.getNSamples(),
+                                        input.getRingOffset() +
+                                        windowOffset_[w],
+                                        outputSignal);
                         }
                     }
                 }
+                break;
             }
             case MULTI_CHANNEL_ONE_WINDOW:
             {
@@ -170,14 +187,14 @@ namespace loudness{
                                                      chn,
                                                      0);
 
-                            for (int smp = 0; smp < length_[0]; ++smp)
-                            {
-                                outputSignal[smp] = window_[0][smp]
-                                                    * inputSignal[smp];
-                            }
+                            applyWindow(window_[0], inputSignal,
+                                        input.getNSamples(),
+                                        input.getRingOffset(),
+                                        outputSignal);
                         }
                     }
                 }
+                break;
             }
         }
     }
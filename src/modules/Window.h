@@ -107,6 +107,11 @@ namespace loudness{
         virtual void processInternal(const SignalBank &input);
         virtual void processInternal(){};
         virtual void resetInternal();
+        virtual bool isStateless() const {return true;};
+        virtual bool readsRingBuffers() const {return true;};
+
+        void applyWindow(const RealVec& window, const Real* inputSignal,
+                int nInputSamples, int readIdx, Real* outputSignal);
 
         //window functions
         void hann(RealVec &window, bool periodic);
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AllocationCounter.h"
+#include <atomic>
+
+namespace loudness{
+
+#if defined(COUNT_ALLOCATIONS)
+    static thread_local long nAllocations = 0;
+#endif
+    static std::atomic<long> nProcessAllocations(0);
+
+    bool AllocationCounter::isEnabled()
+    {
+#if defined(COUNT_ALLOCATIONS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void AllocationCounter::countAllocation()
+    {
+#if defined(COUNT_ALLOCATIONS)
+        nAllocations++;
+#endif
+    }
+
+    long AllocationCounter::getNAllocations()
+    {
+#if defined(COUNT_ALLOCATIONS)
+        return nAllocations;
+#else
+        return 0;
+#endif
+    }
+
+    long AllocationCounter::getNProcessAllocations()
+    {
+        return nProcessAllocations;
+    }
+
+    void AllocationCounter::reportProcessAllocations(long nAllocations)
+    {
+        nProcessAllocations += nAllocations;
+    }
+
+    void AllocationCounter::resetNProcessAllocations()
+    {
+        nProcessAllocations = 0;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+namespace loudness{
+
+    /**
+     * @class AllocationCounter
+     *
+     * @brief Counts heap allocations made while modules process signals.
+     *
+     * Modules allocate all memory they need when initialised, so that
+     * processing does not contend for the heap when models are run on
+     * several threads. When the library is built with COUNT_ALLOCATIONS
+     * defined, Module::process() reports every allocation made by a module
+     * while processing. getNProcessAllocations() returns the total, which
+     * tests use to check that processing is allocation free.
+     *
+     * The library does not replace any allocation function itself: the
+     * program must call countAllocation() from its own. See
+     * build/checkAllocations.cpp, which replaces malloc and the other C
+     * allocation functions, and so also counts operator new and
+     * fftw_malloc.
+     *
+     * In other builds nothing is counted and all counts are zero.
+     */
+    class AllocationCounter
+    {
+    public:
+
+        /** Returns true if allocations are counted (COUNT_ALLOCATIONS). */
+        static bool isEnabled();
+
+        /** Counts an allocation made by the calling thread. Must not
+         * allocate, since it is called from allocation functions. */
+        static void countAllocation();
+
+        /** Returns the number of allocations made by the calling thread. */
+        static long getNAllocations();
+
+        /** Returns the number of allocations reported by modules while
+         * processing, over all threads. */
+        static long getNProcessAllocations();
+
+        /** Adds nAllocations to the number of allocations made while
+         * processing. */
+        static void reportProcessAllocations(long nAllocations);
+
+        /** Sets the number of allocations made while processing to zero. */
+        static void resetNProcessAllocations();
+    };
+}
+
+#endif
@@ -22,8 +22,12 @@
 namespace loudness{
 
     AudioFileProcessor::AudioFileProcessor(const string& fileName) :
+        fileName_(fileName),
+        nThreads_(1),
+        nChunks_(1),
         cutter_(fileName),
-        gainInDecibels_(0)
+        gainInDecibels_(0),
+        chunkPreRoll_(20.0)
     {
         LOUDNESS_DEBUG("AudioFileProcessor: Constructed");
     }
@@ -61,19 +65,169 @@ namespace loudness{
     {
         cutter_.reset();
         model.reset();
-        int frame = nFrames_;
-        while(frame-- > 0)
+        if ((nChunks_ > 1) && processInChunks(model, nFrames_, nChunks_))
+        {
+            //chunks have been processed
+        }
+        else if (nThreads_ > 1)
+        {
+            model.processInParallel(cutter_, nFrames_, nThreads_);
+        }
+        else if (model.getBlockSize() > 1)
+        {
+            //consecutive frames are processed together by the model
+            int blockSize = model.getBlockSize();
+            vector<SignalBank> inputs(blockSize);
+            for (int i = 0; i < blockSize; ++i)
+                inputs[i].initialize(cutter_.getOutput());
+
+            int frame = 0;
+            while (frame < nFrames_)
+            {
+                int nInputs = min(blockSize, nFrames_ - frame);
+                for (int i = 0; i < nInputs; ++i)
+                {
+                    cutter_.process();
+                    inputs[i].copySamples(cutter_.getOutput());
+                    inputs[i].setTrig(cutter_.getOutput().getTrig());
+                }
+                model.processBlock(inputs.data(), nInputs);
+                frame += nInputs;
+            }
+        }
+        else
+        {
+            int frame = nFrames_;
+            while(frame-- > 0)
+            {
+                cutter_.process();
+                model.process(cutter_.getOutput());
+            }
+        }
+        cutter_.reset();
+    }
+
+    bool AudioFileProcessor::processInChunks(Model& model, int nFrames,
+            int nChunks)
+    {
+        int preRollFrames = max(0, (int)round(chunkPreRoll_ / timeStep_));
+
+        //the first chunk is read by cutter_, the others by their own cutters
+        vector<unique_ptr<AudioFileCutter> > cutters;
+        vector<Module*> sources(1, &cutter_);
+        IntVec nPreRollInputs(nChunks, 0), nInputs(nChunks, 0);
+        for (int k = 0; k < nChunks; ++k)
+        {
+            int start = (int)((long long)k * nFrames / nChunks);
+            int end = (int)((long long)(k + 1) * nFrames / nChunks);
+            nInputs[k] = end - start;
+            if (k == 0)
+                continue;
+
+            int preRollStart = max(0, start - preRollFrames);
+            nPreRollInputs[k] = start - preRollStart;
+
+            unique_ptr<AudioFileCutter> cutter(
+                    new AudioFileCutter(fileName_, cutter_.getFrameSize()));
+            cutter -> setGainInDecibels(gainInDecibels_);
+            cutter -> setReadAheadUsed(cutter_.isReadAhead());
+            if (!cutter -> initialize())
+            {
+                LOUDNESS_ERROR("AudioFileProcessor: Cannot open chunk "
+                        << k << " of " << fileName_);
+                return 0;
+            }
+            cutter -> seek(preRollStart);
+            sources.push_back(cutter.get());
+            cutters.push_back(std::move(cutter));
+        }
+
+        LOUDNESS_DEBUG("AudioFileProcessor: Processing " << nChunks
+                << " chunks with a pre-roll of " << preRollFrames << " frames.");
+        model.processInChunks(sources, nPreRollInputs, nInputs);
+        return 1;
+    }
+
+    Real AudioFileProcessor::measureStitchingDiscrepancy(Model& model,
+            Real calibrationDuration)
+    {
+        if (!model.isInitialized())
+        {
+            LOUDNESS_WARNING("AudioFileProcessor: Please initialise the model first.");
+            return 0.0;
+        }
+
+        int nFrames = min(nFrames_, (int)round(calibrationDuration / timeStep_));
+        if (nFrames / 2 <= (int)round(chunkPreRoll_ / timeStep_))
+        {
+            LOUDNESS_WARNING("AudioFileProcessor: The calibration segment is "
+                    << "not longer than twice the pre-roll, "
+                    << "the chunk boundary is not tested.");
+        }
+
+        vector<string> outputs;
+        for (const auto& outputName : model.getOutputsToAggregate())
+        {
+            if (model.hasOutput(outputName))
+                outputs.push_back(outputName);
+        }
+
+        //sequential reference
+        cutter_.reset();
+        model.reset();
+        for (int i = 0; i < nFrames; ++i)
         {
             cutter_.process();
             model.process(cutter_.getOutput());
         }
+        vector<RealVec> reference;
+        for (const auto& outputName : outputs)
+            reference.push_back(model.getOutput(outputName).getAggregatedSignals());
+
+        //the same segment in two chunks
+        cutter_.reset();
+        model.reset();
+        Real discrepancy = 0.0;
+        if (processInChunks(model, nFrames, 2))
+        {
+            for (uint i = 0; i < outputs.size(); ++i)
+            {
+                const RealVec& chunked = model.getOutput(outputs[i])
+                                         .getAggregatedSignals();
+                LOUDNESS_ASSERT(chunked.size() == reference[i].size());
+                Real maxDifference = 0.0, maxValue = 0.0;
+                for (uint j = 0; j < chunked.size(); ++j)
+                {
+                    maxDifference = max(maxDifference, 
+                            (Real)std::fabs(chunked[j] - reference[i][j]));
+                    maxValue = max(maxValue, (Real)std::fabs(reference[i][j]));
+                }
+                if (maxValue > 0.0)
+                    maxDifference /= maxValue;
+                discrepancy = max(discrepancy, maxDifference);
+            }
+        }
+
         cutter_.reset();
+        model.reset();
+        return discrepancy;
+    }
+
+    void AudioFileProcessor::setNThreads(int nThreads)
+    {
+        nThreads_ = nThreads;
+    }
+
+    int AudioFileProcessor::getNThreads() const
+    {
+        return nThreads_;
     }
 
     void AudioFileProcessor::loadNewAudioFile(const string& fileName)
     {
         if (cutter_.isInitialized())
         {
+            fileName_ = fileName;
             cutter_.setFileName(fileName);
             cutter_.setGainInDecibels(gainInDecibels_);
             cutter_.initialize();
@@ -85,6 +239,31 @@ namespace loudness{
         }
     }
 
+    void AudioFileProcessor::setNChunks(int nChunks)
+    {
+        nChunks_ = max(nChunks, 1);
+    }
+
+    int AudioFileProcessor::getNChunks() const
+    {
+        return nChunks_;
+    }
+
+    void AudioFileProcessor::setChunkPreRoll(Real chunkPreRoll)
+    {
+        chunkPreRoll_ = max(chunkPreRoll, (Real)0.0);
+    }
+
+    Real AudioFileProcessor::getChunkPreRoll() const
+    {
+        return chunkPreRoll_;
+    }
+
+    void AudioFileProcessor::setReadAheadUsed(bool isReadAheadUsed)
+    {
+        cutter_.setReadAheadUsed(isReadAheadUsed);
+    }
+
     void AudioFileProcessor::setGainInDecibels(Real gainInDecibels)
     {
         gainInDecibels_ = gainInDecibels;
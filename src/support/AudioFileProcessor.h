@@ -72,9 +72,73 @@ namespace loudness{
 
         /** Processes all frames of the audio file.
          * This function will call model.reset() before
-         * processing the audio file, but not after. */
+         * processing the audio file, but not after. If more than one chunk
+         * has been requested, the file is split into chunks which are
+         * processed on separate threads (see setNChunks()). Otherwise, if
+         * more than one thread has been requested, the stateless stages of
+         * the model are evaluated in parallel (see
+         * Model::processInParallel()). Otherwise, if the
+         * block size of the model is greater than one, frames are processed
+         * in blocks (see Model::processBlock()). */
         void processAllFrames(Model& model);
 
+        /** Sets the number of threads used by processAllFrames(). The default
+         * is 1 (sequential processing). */
+        void setNThreads(int nThreads);
+
+        /** Returns the number of threads used by processAllFrames(). */
+        int getNThreads() const;
+
+        /**
+         * @brief Sets the number of chunks processed in parallel by
+         * processAllFrames(). The default is 1 (no chunking).
+         *
+         * The file is split into nChunks consecutive chunks of frames, each
+         * of which is processed by a copy of the model on its own thread (see
+         * Model::processInChunks()). Every chunk but the first starts early
+         * by the pre-roll (see setChunkPreRoll()) to warm up the model, and
+         * the output of the pre-roll is discarded. The aggregated outputs of
+         * the chunks are joined in order.
+         *
+         * This is an approximation: unlike setNThreads(), slowly decaying
+         * state such as long-term loudness may differ from sequential
+         * processing just after each chunk boundary. Use
+         * measureStitchingDiscrepancy() to check a given pre-roll. Chunking
+         * takes precedence over setNThreads().
+         */
+        void setNChunks(int nChunks);
+
+        /** Returns the number of chunks processed by processAllFrames(). */
+        int getNChunks() const;
+
+        /** Sets the pre-roll in seconds processed before every chunk but the
+         * first. The default is 20 seconds, about ten times the release time
+         * of the long-term loudness of DynamicLoudnessGM2002. */
+        void setChunkPreRoll(Real chunkPreRoll);
+
+        /** Returns the pre-roll in seconds. */
+        Real getChunkPreRoll() const;
+
+        /**
+         * @brief Measures the error introduced by chunked processing.
+         *
+         * The first calibrationDuration seconds of the file are processed
+         * once sequentially and once as two chunks with the current pre-roll.
+         * The model must have been initialised by initialize().
+         *
+         * @return The largest absolute difference between the aggregated
+         * outputs of the two runs, relative to the largest absolute value of
+         * the same output in the sequential run, over all aggregated outputs.
+         * The model is reset afterwards.
+         */
+        Real measureStitchingDiscrepancy(Model& model,
+                Real calibrationDuration);
+
+        /** Decode compressed audio files on a background thread, one
+         * buffer ahead of the model (see AudioFileCutter::setReadAheadUsed()).
+         * Takes effect on initialisation. */
+        void setReadAheadUsed(bool isReadAheadUsed);
+
         /** Set the gain in decibels to be applied to the audio file. */
         void setGainInDecibels(Real gainInDecibels);
 
@@ -91,10 +155,14 @@ namespace loudness{
 
     private:
 
+        /** Processes the first nFrames frames of the file in nChunks chunks.
+         * Returns false if a chunk cannot be opened. */
+        bool processInChunks(Model& model, int nFrames, int nChunks);
+
         string fileName_;
-        int nFrames_, hopSize_;
+        int nFrames_, hopSize_, nThreads_, nChunks_;
         AudioFileCutter cutter_;
-        Real timeStep_, gainInDecibels_;
+        Real timeStep_, gainInDecibels_, chunkPreRoll_;
         vector<string> modelOutputsToSave_;
     };
 }
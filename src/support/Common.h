@@ -40,7 +40,11 @@ namespace loudness{
 /*
  * Types
  */
+#ifdef SINGLE_PRECISION
+typedef float Real;
+#else
 typedef double Real;
+#endif
 typedef unsigned int uint;
 typedef std::vector<Real> RealVec;
 typedef std::vector<std::vector<Real> > RealVecVec;
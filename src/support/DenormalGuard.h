@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DENORMALGUARD_H
+#define DENORMALGUARD_H
+
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
+namespace loudness{
+
+    /**
+     * @class DenormalGuard
+     *
+     * @brief Flushes denormal numbers to zero for the lifetime of the object.
+     *
+     * Recursive filters decaying towards zero produce denormals, which are
+     * very slow on most processors. Construct a DenormalGuard on the stack
+     * before running a recursion; the previous floating point mode is
+     * restored when it goes out of scope. This replaces adding and
+     * subtracting a small offset to every state variable.
+     *
+     * Supported on x86 (SSE) and AArch64, and a no-op elsewhere.
+     */
+    class DenormalGuard
+    {
+    public:
+#if defined(__SSE__) || defined(__x86_64__)
+        DenormalGuard() : mode_(_mm_getcsr())
+        {
+            //flush to zero (bit 15) and denormals are zero (bit 6)
+            _mm_setcsr(mode_ | 0x8040);
+        }
+
+        ~DenormalGuard()
+        {
+            _mm_setcsr(mode_);
+        }
+
+    private:
+        unsigned int mode_;
+#elif defined(__aarch64__)
+        DenormalGuard()
+        {
+            unsigned long mode;
+            __asm__ __volatile__("mrs %0, fpcr" : "=r"(mode));
+            mode_ = mode;
+            //flush to zero (bit 24)
+            mode |= (1UL << 24);
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+        }
+
+        ~DenormalGuard()
+        {
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(mode_));
+        }
+
+    private:
+        unsigned long mode_;
+#else
+        DenormalGuard() {}
+        ~DenormalGuard() {}
+#endif
+
+        DenormalGuard(const DenormalGuard&);
+        DenormalGuard& operator=(const DenormalGuard&);
+    };
+}
+
+#endif
@@ -17,12 +17,178 @@
  * along with Loudness.  If not, see <http://www.gnu.org/licenses/>. 
  */
 
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <tuple>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "FFT.h"
 
 namespace loudness{
 
-    FFT::FFT(int fftSize) :
+    /*
+     * Process-wide plan registry keyed by (size, number of transforms,
+     * precision, direction). FFTW's planner is not thread-safe, so all access goes
+     * through planMutex.
+     */
+    typedef std::tuple<int, int, int, bool> PlanKey;
+    static std::mutex planMutex;
+    static map<PlanKey, FFTW(plan)> planCache;
+    static FFT::PlanningEffort planningEffort = FFT::MEASURE;
+    static string wisdomFile;
+
+    /*
+     * Writes the wisdom to a temporary file unique to this call, in the same
+     * directory as fileName, and renames it into place. Processes sharing
+     * the file therefore never see, or produce, a partly written file.
+     * Called with planMutex held.
+     */
+    static bool exportWisdomAtomically(const string& fileName)
+    {
+        string tmpFile = fileName + ".XXXXXX";
+        vector<char> tmpName(tmpFile.begin(), tmpFile.end());
+        tmpName.push_back('\0');
+        int fd = mkstemp(tmpName.data());
+        if (fd < 0)
+            return 0;
+
+        fchmod(fd, 0644);
+        FILE* file = fdopen(fd, "w");
+        if (!file)
+        {
+            close(fd);
+            std::remove(tmpName.data());
+            return 0;
+        }
+        FFTW(export_wisdom_to_file)(file);
+        bool isWritten = !std::ferror(file);
+        if ((std::fclose(file) != 0) || !isWritten
+                || (std::rename(tmpName.data(), fileName.c_str()) != 0))
+        {
+            std::remove(tmpName.data());
+            return 0;
+        }
+        return 1;
+    }
+
+    FFTW(plan) FFT::getPlan(int fftSize, int nTransforms, bool isInverse)
+    {
+        LOUDNESS_ASSERT(!isInverse || (nTransforms == 1),
+                "FFT: Only single inverse transforms are supported");
+
+        std::lock_guard<std::mutex> lock(planMutex);
+
+        PlanKey key(fftSize, nTransforms, sizeof(Real), isInverse);
+        auto search = planCache.find(key);
+        if (search != planCache.end())
+            return search -> second;
+
+        unsigned flags = FFTW_PATIENT;
+        if (planningEffort == ESTIMATE)
+            flags = FFTW_ESTIMATE;
+        else if (planningEffort == MEASURE)
+            flags = FFTW_MEASURE;
+
+        //planning may overwrite the arrays, so use scratch buffers
+        int inputStride = getBatchStride(fftSize);
+        int outputStride = getBatchStride(fftSize + 2);
+        Real *in = (Real*) FFTW(malloc)(sizeof(Real) * inputStride * nTransforms);
+        FFTW(complex) *out = (FFTW(complex)*) FFTW(malloc)(sizeof(Real) *
+                outputStride * nTransforms);
+        FFTW(plan) plan;
+        if (isInverse)
+        {
+            plan = FFTW(plan_dft_c2r_1d)(fftSize, out, in, flags);
+        }
+        else if (nTransforms == 1)
+        {
+            plan = FFTW(plan_dft_r2c_1d)(fftSize, in, out, flags);
+        }
+        else
+        {
+            plan = FFTW(plan_many_dft_r2c)(1, &fftSize, nTransforms,
+                                           in, 0, 1, inputStride,
+                                           out, 0, 1, outputStride / 2,
+                                           flags);
+        }
+        FFTW(free)(in);
+        FFTW(free)(out);
+        planCache[key] = plan;
+        LOUDNESS_DEBUG("FFT: Created " << (isInverse ? "inverse " : "")
+                << "plan for " << nTransforms
+                << " transform(s) of size " << fftSize);
+
+        if (!wisdomFile.empty())
+        {
+            if (!exportWisdomAtomically(wisdomFile))
+                LOUDNESS_WARNING("FFT: Could not export wisdom to " << wisdomFile);
+        }
+
+        return plan;
+    }
+
+    void FFT::setPlanningEffort(const PlanningEffort& effort)
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        planningEffort = effort;
+    }
+
+    FFT::PlanningEffort FFT::getPlanningEffort()
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        return planningEffort;
+    }
+
+    void FFT::clearPlans()
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        for (auto& entry : planCache)
+            FFTW(destroy_plan)(entry.second);
+        planCache.clear();
+        LOUDNESS_DEBUG("FFT: Plans destroyed");
+    }
+
+    int FFT::getNPlans()
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        return planCache.size();
+    }
+
+    bool FFT::setWisdomFile(const string& fileName)
+    {
+        bool imported = fileName.empty() ? false : importWisdom(fileName);
+        std::lock_guard<std::mutex> lock(planMutex);
+        wisdomFile = fileName;
+        return imported;
+    }
+
+    bool FFT::importWisdom(const string& fileName)
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        if (FFTW(import_wisdom_from_filename)(fileName.c_str()))
+        {
+            LOUDNESS_DEBUG("FFT: Imported wisdom from " << fileName);
+            return 1;
+        }
+        return 0;
+    }
+
+    bool FFT::exportWisdom(const string& fileName)
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        return FFTW(export_wisdom_to_filename)(fileName.c_str()) != 0;
+    }
+
+    int FFT::getBatchStride(int fftSize)
+    {
+        //keep every transform of a batch as aligned as the first
+        return (fftSize + 15) & ~15;
+    }
+
+    FFT::FFT(int fftSize, int batchSize) :
         fftSize_(fftSize),
+        batchSize_(max(batchSize, 1)),
         nReals_(0),
         nImags_(0),
         initialized_(false)
@@ -39,12 +205,10 @@ namespace loudness{
 
         if (initialized_)
         {
-            fftw_free(fftInputBuf_);
-            fftw_free(fftOutputBuf_);
+            FFTW(free)(fftInputBuf_);
+            FFTW(free)(fftOutputBuf_);
+            initialized_ = false;
             LOUDNESS_DEBUG("FFT: Buffers destroyed.");
-
-            fftw_destroy_plan(fftPlan_);
-            LOUDNESS_DEBUG("FFT: Plan destroyed.");
         }
     }
 
@@ -55,17 +219,22 @@ namespace loudness{
         //don't worry, we are protected from reinitialisation
         //allocate memory for FFT input buffers...all FFT inputs can make use of a single buffer
         //since we are not doing zero phase insersion
-        fftInputBuf_ = (Real*) fftw_malloc(sizeof(Real) * fftSize_);
-        fftOutputBuf_ = (Real*) fftw_malloc(sizeof(Real) * fftSize_);
-        LOUDNESS_DEBUG("FFT: Allocated input and output buffers for an FFT size of " << fftSize_);
+        batchStride_ = getBatchStride(fftSize_);
+        outputStride_ = getBatchStride(fftSize_ + 2);
+        fftInputBuf_ = (Real*) FFTW(malloc)(sizeof(Real) * batchStride_ * batchSize_);
+        fftOutputBuf_ = (Real*) FFTW(malloc)(sizeof(Real) * outputStride_ * batchSize_);
+        LOUDNESS_DEBUG("FFT: Allocated input and output buffers for "
+                << batchSize_ << " transform(s) of size " << fftSize_);
         
-        fftPlan_ = fftw_plan_r2r_1d(fftSize_, fftInputBuf_,
-                fftOutputBuf_, FFTW_R2HC, FFTW_PATIENT);
+        //shared plans, executed on this object's buffers
+        fftPlan_ = getPlan(fftSize_, 1);
+        if (batchSize_ > 1)
+            batchPlan_ = getPlan(fftSize_, batchSize_);
 
         LOUDNESS_DEBUG("FFT: Plan set up");
 
-        //number of positive output components
-        //see: http://www.fftw.org/fftw2_doc/fftw_3.html 
+        //number of positive output components, DC and Nyquist (if present)
+        //have no imaginary part
         nPositiveComponents_ = fftSize_/2 + 1;
         nReals_ = nPositiveComponents_;
         nImags_ = nReals_ - 2 + (fftSize_ % 2);
@@ -81,15 +250,79 @@ namespace loudness{
     {
         if(fftSize_ > 0)
         {
-            //fill the buffer
-            int i = fftSize_;
-            while(i > length)
-                fftInputBuf_[--i] = 0.0;
-            while(--i >= 0)
-                fftInputBuf_[i] = input[i];
+            setInput(0, input, length);
+
+            //compute fft
+            FFTW(execute_dft_r2c)(fftPlan_, fftInputBuf_,
+                                  (FFTW(complex)*)fftOutputBuf_);
+        }
+    }
+
+    void FFT::process(const Real* input1, int length1,
+            const Real* input2, int length2)
+    {
+        if(fftSize_ > 0)
+        {
+            setInput(0, input1, length1, input2, length2);
 
             //compute fft
-            fftw_execute(fftPlan_);
+            FFTW(execute_dft_r2c)(fftPlan_, fftInputBuf_,
+                                  (FFTW(complex)*)fftOutputBuf_);
+        }
+    }
+
+    void FFT::setInput(int frame, const Real* input1, int length1,
+            const Real* input2, int length2)
+    {
+        LOUDNESS_ASSERT(isPositiveAndLessThanUpper(frame, batchSize_));
+
+        //fill the buffer
+        Real* buffer = fftInputBuf_ + frame * batchStride_;
+        int i = fftSize_;
+        while(i > length1 + length2)
+            buffer[--i] = 0.0;
+        while(--i >= length1)
+            buffer[i] = input2[i - length1];
+        for(; i >= 0; --i)
+            buffer[i] = input1[i];
+    }
+
+    void FFT::setWindowedInput(int frame, const Real* window,
+            const Real* input1, int length1,
+            const Real* input2, int length2)
+    {
+        LOUDNESS_ASSERT(isPositiveAndLessThanUpper(frame, batchSize_));
+
+        //fill the buffer
+        Real* buffer = fftInputBuf_ + frame * batchStride_;
+        int i = fftSize_;
+        while(i > length1 + length2)
+            buffer[--i] = 0.0;
+        while(--i >= length1)
+            buffer[i] = window[i] * input2[i - length1];
+        for(; i >= 0; --i)
+            buffer[i] = window[i] * input1[i];
+    }
+
+    void FFT::processBatch(int nFrames)
+    {
+        if(fftSize_ > 0)
+        {
+            if ((nFrames == batchSize_) && (batchSize_ > 1))
+            {
+                FFTW(execute_dft_r2c)(batchPlan_, fftInputBuf_,
+                                      (FFTW(complex)*)fftOutputBuf_);
+            }
+            else
+            {
+                for (int frame = 0; frame < nFrames; ++frame)
+                {
+                    FFTW(execute_dft_r2c)(fftPlan_,
+                            fftInputBuf_ + frame * batchStride_,
+                            (FFTW(complex)*)(fftOutputBuf_ +
+                                             frame * outputStride_));
+                }
+            }
         }
     }
 
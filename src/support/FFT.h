@@ -23,6 +23,15 @@
 #include <fftw3.h>
 #include "../support/Module.h"
 
+/*
+ * FFTW routines matching the precision of Real (fftwf for SINGLE_PRECISION).
+ */
+#ifdef SINGLE_PRECISION
+#define FFTW(name) fftwf_##name
+#else
+#define FFTW(name) fftw_##name
+#endif
+
 namespace loudness{
 
     /**
@@ -66,6 +75,13 @@ namespace loudness{
     {
     public:
 
+        /** Planning rigour used when FFTW creates a new plan. */
+        enum PlanningEffort{
+            ESTIMATE,
+            MEASURE,
+            PATIENT
+        };
+
         /**
          * @brief Constructs a FFT object.
          *
@@ -73,21 +89,106 @@ namespace loudness{
          * @param windowSizeSecs A vector of window lengths for each band in ms.
          * @param uniform true for uniform spectral sampling, false otherwise.
          */
-        FFT(int fftSize);
+        FFT(int fftSize, int batchSize = 1);
 
         ~FFT();
 
         bool initialize();
         void process(const Real* input, int length);
+
+        /** Processes a signal held in two segments, e.g. a frame stored in a
+         * circular buffer. The segments are concatenated and zero padded. */
+        void process(const Real* input1, int length1,
+                const Real* input2, int length2);
+
+        /**
+         * @brief Sets the input of a transform in the batch.
+         *
+         * The signal is held in up to two segments which are concatenated and
+         * zero padded to the FFT size. The batch is transformed by
+         * processBatch().
+         *
+         * @param frame Index of the transform, less than the batch size.
+         */
+        void setInput(int frame, const Real* input1, int length1,
+                const Real* input2 = 0, int length2 = 0);
+
+        /**
+         * @brief Sets the input of a transform in the batch, multiplied by a
+         * window of length length1 + length2.
+         *
+         * Same as setInput() but the window is applied while copying, so no
+         * windowed copy of the signal is needed.
+         */
+        void setWindowedInput(int frame, const Real* window,
+                const Real* input1, int length1,
+                const Real* input2 = 0, int length2 = 0);
+
+        /**
+         * @brief Computes the first nFrames transforms of the batch.
+         *
+         * A full batch is computed by a single FFTW plan spanning all
+         * transforms; smaller ones execute the single-transform plan for each
+         * frame. The two plans may round differently, so a full batch equals
+         * the transforms of its frames computed one at a time only to
+         * rounding.
+         */
+        void processBatch(int nFrames);
         void freeFFTW();
 
         int getFftSize() const;
         int getNPositiveComponents() const;
 
+        /**
+         * @brief Sets the planning effort used when a plan is not already in
+         * the process-wide plan cache. The default is MEASURE.
+         *
+         * Plans are shared by all FFT objects of the same size, so the cost
+         * of planning is paid once per process. Plans already in the cache
+         * are not replanned when the effort changes (see clearPlans()).
+         * PATIENT plans may execute faster but can take seconds to create
+         * for each new size, unless the wisdom is kept in a file (see
+         * setWisdomFile()).
+         */
+        static void setPlanningEffort(const PlanningEffort& planningEffort);
+        static PlanningEffort getPlanningEffort();
+
+        /**
+         * @brief Destroys all plans in the process-wide plan cache.
+         *
+         * The accumulated wisdom is kept, so plans created afterwards are
+         * cheap to recreate. FFT objects and modules using plans, such as
+         * PowerSpectrum, must be initialised again before processing.
+         */
+        static void clearPlans();
+
+        /** Returns the number of plans in the process-wide plan cache. */
+        static int getNPlans();
+
+        /**
+         * @brief Loads FFTW wisdom from a file and stores the accumulated
+         * wisdom back to it every time a new plan is created.
+         *
+         * Each export is written to a temporary file of its own and then
+         * renamed over the file, so several processes can share it: readers
+         * always see a complete file, from the most recent export.
+         * An empty string stops the export.
+         *
+         * @return true if wisdom was imported from the file.
+         */
+        static bool setWisdomFile(const string& fileName);
+
+        /** Imports FFTW wisdom from a file. Returns true on success. */
+        static bool importWisdom(const string& fileName);
+
+        /** Exports the accumulated FFTW wisdom to a file. Returns true on
+         * success. */
+        static bool exportWisdom(const string& fileName);
+
         inline Real getReal(int i)
         {
             if (i < nReals_)
-                return fftOutputBuf_[i];
+                return fftOutputBuf_[2 * i];
             else
                 return 0.0;
         }
@@ -95,18 +196,56 @@ namespace loudness{
         inline Real getImag(int i)
         {
             if ( (i > 0) && (i <= nImags_) )
-                return fftOutputBuf_[fftSize_ - i];
+                return fftOutputBuf_[2 * i + 1];
+            else
+                return 0.0;
+        }
+
+        /** Returns the real part of component i of transform frame in the
+         * batch. */
+        inline Real getReal(int frame, int i)
+        {
+            if (i < nReals_)
+                return fftOutputBuf_[frame * outputStride_ + 2 * i];
+            else
+                return 0.0;
+        }
+
+        /** Returns the imaginary part of component i of transform frame in
+         * the batch. */
+        inline Real getImag(int frame, int i)
+        {
+            if ( (i > 0) && (i <= nImags_) )
+                return fftOutputBuf_[frame * outputStride_ + 2 * i + 1];
             else
                 return 0.0;
         }
 
+        /**
+         * @brief Returns the cached plan for nTransforms real to complex
+         * transforms of size fftSize, creating it if necessary.
+         *
+         * If isInverse is true, the plan is for a single complex to real
+         * transform instead, which overwrites its input. Plans are owned by
+         * the cache and are executed on arrays allocated with FFTW's malloc
+         * using the new-array execute functions.
+         */
+        static FFTW(plan) getPlan(int fftSize, int nTransforms,
+                                  bool isInverse = false);
+
     private:
 
-        int fftSize_, nReals_, nImags_, nPositiveComponents_;
+        /** Returns the distance in samples between consecutive transforms of
+         * a batch. */
+        static int getBatchStride(int fftSize);
+
+        int fftSize_, batchSize_, batchStride_, outputStride_;
+        int nReals_, nImags_, nPositiveComponents_;
         bool initialized_;
         Real *fftInputBuf_;
+        //positive frequency components, real and imaginary parts interleaved
         Real *fftOutputBuf_;
-        fftw_plan fftPlan_;
+        FFTW(plan) fftPlan_, batchPlan_;
     };
 }
 
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FastMath.h"
+#include <atomic>
+
+namespace loudness{
+
+    static std::atomic<bool> fastMathEnabled(false);
+
+    void setFastMathEnabled(bool isFastMathEnabled)
+    {
+        fastMathEnabled = isFastMathEnabled;
+    }
+
+    bool isFastMathEnabled()
+    {
+        return fastMathEnabled;
+    }
+}
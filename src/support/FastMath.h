@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include "Common.h"
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Branch-free elementary functions written so that loops over arrays are
+ * vectorised by the compiler (this requires -fno-trapping-math, see
+ * build/Makefile). All arithmetic is carried out in double precision.
+ *
+ * Error bounds are in ulp of the double nearest to the exact result. They
+ * were measured against the long double functions of the standard library
+ * over the ranges used by the models, see build/checkFastMath.cpp (make
+ * check-fast-math).
+ */
+namespace loudness{
+
+    /**
+     * @brief Enables or disables the fast elementary functions in modules.
+     *
+     * Modules read this switch when they are initialised. If disabled, they
+     * use the standard library functions, giving the same results as before
+     * the fast functions were introduced. The default is disabled.
+     */
+    void setFastMathEnabled(bool isFastMathEnabled);
+    bool isFastMathEnabled();
+
+    /**
+     * @brief Returns e^x.
+     *
+     * The argument is reduced to x = k ln(2) + r with |r| <= ln(2) / 2 and
+     * e^r is evaluated by its Taylor series to degree 13 (truncation error
+     * below 5e-18). The result is within 1.2 ulp of e^x. Arguments are clamped
+     * to [-708, 709], so the function neither overflows nor returns
+     * subnormals.
+     */
+    inline double fastExp (double x)
+    {
+        x = x > -708.0 ? x : -708.0;
+        x = x < 709.0 ? x : 709.0;
+
+        //adding 1.5 * 2^52 rounds to the nearest integer k, held in the low
+        //bits of the mantissa
+        const double shifter = 6755399441055744.0;
+        double t = x * 1.4426950408889634 + shifter;
+        double k = t - shifter;
+
+        //Cody-Waite reduction, ln(2) split into high and low parts
+        double r = x - k * 6.93147180369123816490e-01;
+        r -= k * 1.90821492927058770002e-10;
+
+        double p = 1.0 / 6227020800.0;
+        p = p * r + 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        //2^k from the exponent bits
+        uint64_t bits;
+        std::memcpy (&bits, &t, sizeof(bits));
+        bits = (bits + 1023) << 52;
+        double scale;
+        std::memcpy (&scale, &bits, sizeof(scale));
+
+        return p * scale;
+    }
+
+    /**
+     * @brief Returns the natural logarithm of x.
+     *
+     * x is split into 2^k m with m in [sqrt(1/2), sqrt(2)) using integer
+     * operations only, and log(m) is evaluated as in fdlibm from
+     * s = (m - 1) / (m + 1) with a polynomial approximation of atanh(s).
+     * The result is within 1 ulp of log(x). @a x must be
+     * a positive normal number; the result is undefined otherwise.
+     */
+    inline double fastLog (double x)
+    {
+        uint64_t bits;
+        std::memcpy (&bits, &x, sizeof(bits));
+
+        //biased exponent k + 1023 for which m lies in [sqrt(1/2), sqrt(2))
+        const uint64_t sqrtHalfBits = 0x3fe6a09e667f3bcdULL;
+        const uint64_t bias = 1023ULL << 52;
+        uint64_t biasedK = (bits - sqrtHalfBits + bias) >> 52;
+
+        //the exponent as a double, via the mantissa of 2^52
+        uint64_t kBits = 0x4330000000000000ULL | biasedK;
+        double k;
+        std::memcpy (&k, &kBits, sizeof(k));
+        k -= 4503599627371519.0; //2^52 + 1023
+
+        uint64_t mBits = bits - (biasedK << 52) + bias;
+        double m;
+        std::memcpy (&m, &mBits, sizeof(m));
+
+        double f = m - 1.0;
+        double s = f / (2.0 + f);
+        double z = s * s;
+        //fdlibm minimax coefficients, error below 2^-58.45
+        double r = 1.479819860511658591e-01;
+        r = r * z + 1.531383769920937332e-01;
+        r = r * z + 1.818357216161805012e-01;
+        r = r * z + 2.222219843214978396e-01;
+        r = r * z + 2.857142874366239149e-01;
+        r = r * z + 3.999999999940941908e-01;
+        r = r * z + 6.666666666666735130e-01;
+        r *= z;
+        double hfsq = 0.5 * f * f;
+
+        return k * 6.93147180369123816490e-01 -
+               ((hfsq - (s * (hfsq + r) + k * 1.90821492927058770002e-10)) - f);
+    }
+
+    /**
+     * @brief Returns the base 10 logarithm of x.
+     *
+     * Within 2 ulp of log10(x). @a x must be a positive normal number.
+     */
+    inline double fastLog10 (double x)
+    {
+        return fastLog (x) * 0.43429448190325182765;
+    }
+
+    /**
+     * @brief Returns x^y for x >= 0 and y > 0.
+     *
+     * Computed as e^(y log(x)), so the relative error grows with the
+     * magnitude of y log(x): it is within (2 + 2 |y log(x)|) ulp, e.g. 4 ulp
+     * for x^0.2 with x = 1e2, and 25 ulp for x = 1e25, wherever x^y is a
+     * normal number (|y log(x)| <= 708). Values of x below the smallest
+     * normal number (about 2.2e-308) give zero.
+     */
+    inline double fastPow (double x, double y)
+    {
+        //a positive argument for the logarithm
+        double xn = x > 2.2250738585072014e-308 ? x : 1.0;
+        double result = fastExp (y * fastLog (xn));
+        return x > 2.2250738585072014e-308 ? result : 0.0;
+    }
+
+    /**
+     * @brief Returns the hyperbolic cosine of x.
+     *
+     * Within 2 ulp of cosh(x). As for fastExp(), the magnitude of x is
+     * clamped to 708.
+     */
+    inline double fastCosh (double x)
+    {
+        return 0.5 * (fastExp (x) + fastExp (-x));
+    }
+
+    /*
+     * Array versions: y[i] = f(x[i]) for n values, using the fast functions
+     * above if isFast is true and the standard library otherwise. x and y
+     * may alias.
+     */
+
+    inline void vectorExp (const Real* x, Real* y, int n, bool isFast)
+    {
+        if (isFast)
+            for (int i = 0; i < n; ++i)
+                y[i] = fastExp (x[i]);
+        else
+            for (int i = 0; i < n; ++i)
+                y[i] = std::exp (x[i]);
+    }
+
+    inline void vectorLog (const Real* x, Real* y, int n, bool isFast)
+    {
+        if (isFast)
+            for (int i = 0; i < n; ++i)
+                y[i] = fastLog (x[i]);
+        else
+            for (int i = 0; i < n; ++i)
+                y[i] = std::log (x[i]);
+    }
+
+    inline void vectorLog10 (const Real* x, Real* y, int n, bool isFast)
+    {
+        if (isFast)
+            for (int i = 0; i < n; ++i)
+                y[i] = fastLog10 (x[i]);
+        else
+            for (int i = 0; i < n; ++i)
+                y[i] = std::log10 (x[i]);
+    }
+
+    inline void vectorCosh (const Real* x, Real* y, int n, bool isFast)
+    {
+        if (isFast)
+            for (int i = 0; i < n; ++i)
+                y[i] = fastCosh (x[i]);
+        else
+            for (int i = 0; i < n; ++i)
+                y[i] = std::cosh (x[i]);
+    }
+
+    /** y[i] = x[i]^exponent. */
+    inline void vectorPow (const Real* x, Real exponent, Real* y, int n,
+            bool isFast)
+    {
+        if (isFast)
+            for (int i = 0; i < n; ++i)
+                y[i] = fastPow (x[i], exponent);
+        else
+            for (int i = 0; i < n; ++i)
+                y[i] = std::pow (x[i], exponent);
+    }
+
+    /** y[i] = x[i]^exponents[i]. */
+    inline void vectorPow (const Real* x, const Real* exponents, Real* y,
+            int n, bool isFast)
+    {
+        if (isFast)
+            for (int i = 0; i < n; ++i)
+                y[i] = fastPow (x[i], exponents[i]);
+        else
+            for (int i = 0; i < n; ++i)
+                y[i] = std::pow (x[i], exponents[i]);
+    }
+}
+
+#endif
@@ -32,43 +32,70 @@ namespace loudness{
     Filter::~Filter() {}
 
     bool Filter::loadCoefsFromNumpyArray(string pathToFilterCoefs)
+    {
+        RealVec bCoefs, aCoefs;
+        if (!readCoefsFromNumpyArray(pathToFilterCoefs, bCoefs, aCoefs))
+            return 0;
+
+        bCoefs_.insert(bCoefs_.end(), bCoefs.begin(), bCoefs.end());
+        aCoefs_.insert(aCoefs_.end(), aCoefs.begin(), aCoefs.end());
+
+        return 1;
+    }
+
+    bool Filter::readCoefsFromNumpyArray(const string& pathToFilterCoefs,
+                                         RealVec& bCoefs,
+                                         RealVec& aCoefs)
     {
         if(pathToFilterCoefs.empty())
         {
            LOUDNESS_ERROR("Filter: No path to filter coefficients"); 
            return 0;
         }
-        else
+
+        //load numpy array holding the filter coefficients
+        //npy_load will abort if fopen fails
+        cnpy::NpyArray arr = cnpy::npy_load(pathToFilterCoefs);
+
+        //check if filter is IIR or FIR
+        bool iir = false;
+        bool isValid = (arr.shape.size() == 2)
+                       && ((arr.word_size == sizeof(double))
+                       || (arr.word_size == sizeof(float)));
+        if(isValid && (arr.shape[0]==2))
         {
-            //load numpy array holding the filter coefficients
-            //npy_load will abort if fopen fails
-            cnpy::NpyArray arr = cnpy::npy_load(pathToFilterCoefs);
-            Real *data = reinterpret_cast<Real*> (arr.data);
-
-            //check if filter is IIR or FIR
-            bool iir = false;
-            if(arr.shape[0]==2)
-            {
-                iir = true;
-            }
-            else if(arr.shape[0]!=1)
-            {
-                LOUDNESS_ERROR("Filter: Numpy array shape should be 1xN (FIR) or 2xN (IIR).");
-                return 0;
-            }
-            LOUDNESS_DEBUG("Filter: Shape is: (" << arr.shape[0] << " x " << arr.shape[1] << ")");
+            iir = true;
+        }
+        else if(!isValid || (arr.shape[0]!=1))
+        {
+            LOUDNESS_ERROR("Filter: Numpy array shape should be 1xN (FIR) or 2xN (IIR)"
+                    << " of single or double precision values.");
+            arr.destruct();
+            return 0;
+        }
+        LOUDNESS_DEBUG("Filter: Shape is: (" << arr.shape[0] << " x " << arr.shape[1] << ")");
 
-            //transfer data
-            for(unsigned int i=0; i<arr.shape[1]; i++)
-            {
-                bCoefs_.push_back(data[i]);
-                if(iir)
-                    aCoefs_.push_back(data[i+arr.shape[1]]);
-            }
-            
-            //clean up
-            delete [] data;
+        //transfer data, converting to the precision of Real
+        int nCoefs = arr.shape[1];
+        bCoefs.resize(nCoefs);
+        aCoefs.resize(iir ? nCoefs : 0);
+        if (arr.word_size == sizeof(double))
+        {
+            const double *data = reinterpret_cast<const double*> (arr.data);
+            std::copy(data, data + nCoefs, bCoefs.begin());
+            if(iir)
+                std::copy(data + nCoefs, data + 2 * nCoefs, aCoefs.begin());
         }
+        else
+        {
+            const float *data = reinterpret_cast<const float*> (arr.data);
+            std::copy(data, data + nCoefs, bCoefs.begin());
+            if(iir)
+                std::copy(data + nCoefs, data + 2 * nCoefs, aCoefs.begin());
+        }
+
+        //clean up
+        arr.destruct();
 
         return 1;
     }
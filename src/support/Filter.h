@@ -60,6 +60,20 @@ namespace loudness{
          */
         bool loadCoefsFromNumpyArray(string pathToFilterCoefs="");
 
+        /**
+         * @brief Reads filter coefficients from a Numpy array binary file
+         * into @a bCoefs and @a aCoefs.
+         *
+         * Arrays stored in single or double precision are converted to Real,
+         * so the same coefficient files can be used whatever the precision of
+         * the build. @a aCoefs is left empty for FIR (1xN) arrays.
+         *
+         * @return true if successfully read, false otherwise.
+         */
+        static bool readCoefsFromNumpyArray(const string& pathToFilterCoefs,
+                                            RealVec& bCoefs,
+                                            RealVec& aCoefs);
+
         /**
          * @brief Sets the feedforward coefficients.
          */
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedAudioFile.h"
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace loudness{
+
+    /*
+     * Little endian fields, assembled byte by byte so that neither the
+     * alignment of the data nor the byte order of the host matters.
+     */
+    static inline uint32_t readUInt16(const unsigned char* p)
+    {
+        return p[0] | (p[1] << 8);
+    }
+
+    static inline uint32_t readUInt32(const unsigned char* p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    MappedAudioFile::MappedAudioFile() :
+        mapping_(0),
+        mappingSize_(0),
+        data_(0),
+        nChannels_(0),
+        fs_(0),
+        bytesPerSample_(0),
+        bytesPerFrame_(0),
+        nFrames_(0),
+        sampleFormat_(PCM_16)
+    {}
+
+    MappedAudioFile::~MappedAudioFile()
+    {
+        close();
+    }
+
+    bool MappedAudioFile::open(const string& fileName)
+    {
+        close();
+
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return 0;
+
+        struct stat fileStatus;
+        if ((fstat(fd, &fileStatus) != 0) || (fileStatus.st_size < 44))
+        {
+            ::close(fd);
+            return 0;
+        }
+
+        size_t fileSize = fileStatus.st_size;
+        void* mapping = mmap(0, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        //the mapping holds its own reference to the file
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            return 0;
+
+        if (!parseHeader((const unsigned char*)mapping, fileSize))
+        {
+            munmap(mapping, fileSize);
+            return 0;
+        }
+
+        //frames are usually read in order
+        madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+        mapping_ = mapping;
+        mappingSize_ = fileSize;
+
+        LOUDNESS_DEBUG("MappedAudioFile: Mapped " << fileName
+                << ", channels: " << nChannels_
+                << ", bytes per sample: " << bytesPerSample_
+                << ", frames: " << nFrames_);
+
+        return 1;
+    }
+
+    bool MappedAudioFile::parseHeader(const unsigned char* file,
+            size_t fileSize)
+    {
+        if (std::memcmp(file, "RIFF", 4) || std::memcmp(file + 8, "WAVE", 4))
+            return 0;
+
+        int formatTag = 0, bitsPerSample = 0;
+        bool hasFormat = false;
+        size_t pos = 12;
+        while (pos + 8 <= fileSize)
+        {
+            const unsigned char* chunk = file + pos;
+            size_t chunkSize = readUInt32(chunk + 4);
+
+            if (!std::memcmp(chunk, "fmt ", 4) && (chunkSize >= 16) &&
+                (pos + 8 + chunkSize <= fileSize))
+            {
+                formatTag = readUInt16(chunk + 8);
+                nChannels_ = readUInt16(chunk + 10);
+                fs_ = readUInt32(chunk + 12);
+                bytesPerFrame_ = readUInt16(chunk + 20);
+                bitsPerSample = readUInt16(chunk + 22);
+
+                //WAVE_FORMAT_EXTENSIBLE: the format is in the sub-format GUID
+                if ((formatTag == 0xFFFE) && (chunkSize >= 40))
+                    formatTag = readUInt16(chunk + 32);
+
+                hasFormat = true;
+            }
+            else if (!std::memcmp(chunk, "data", 4))
+            {
+                if (!hasFormat)
+                    return 0;
+
+                //PCM or IEEE float
+                if (formatTag == 1 && bitsPerSample == 16)
+                    sampleFormat_ = PCM_16;
+                else if (formatTag == 1 && bitsPerSample == 24)
+                    sampleFormat_ = PCM_24;
+                else if (formatTag == 1 && bitsPerSample == 32)
+                    sampleFormat_ = PCM_32;
+                else if (formatTag == 3 && bitsPerSample == 32)
+                    sampleFormat_ = FLOAT;
+                else
+                    return 0;
+
+                bytesPerSample_ = bitsPerSample / 8;
+                if ((nChannels_ < 1) ||
+                    (bytesPerFrame_ != nChannels_ * bytesPerSample_))
+                    return 0;
+
+                //the size may be a placeholder, or the file truncated
+                size_t dataSize = min(chunkSize, fileSize - pos - 8);
+                data_ = chunk + 8;
+                nFrames_ = dataSize / bytesPerFrame_;
+                return 1;
+            }
+
+            //chunks are padded to an even length
+            pos += 8 + chunkSize + (chunkSize & 1);
+        }
+
+        return 0;
+    }
+
+    void MappedAudioFile::close()
+    {
+        if (mapping_)
+        {
+            munmap(mapping_, mappingSize_);
+            mapping_ = 0;
+            mappingSize_ = 0;
+            data_ = 0;
+            nFrames_ = 0;
+        }
+    }
+
+    bool MappedAudioFile::isOpen() const
+    {
+        return mapping_ != 0;
+    }
+
+    long long MappedAudioFile::read(long long startFrame, int channel,
+            int nFrames, Real gain, Real* output) const
+    {
+        LOUDNESS_ASSERT(isPositiveAndLessThanUpper(channel, nChannels_));
+
+        long long nRead = 0;
+        if (startFrame < nFrames_)
+            nRead = min((long long)nFrames, nFrames_ - startFrame);
+
+        const unsigned char* p = data_ + channel * bytesPerSample_;
+        if (nRead > 0)
+            p += startFrame * bytesPerFrame_;
+        int stride = bytesPerFrame_;
+        switch (sampleFormat_)
+        {
+            case PCM_16:
+            {
+                Real scale = gain / 32768.0;
+                for (int i = 0; i < nRead; ++i, p += stride)
+                    output[i] = scale * (int16_t)readUInt16(p);
+                break;
+            }
+            case PCM_24:
+            {
+                Real scale = gain / 8388608.0;
+                for (int i = 0; i < nRead; ++i, p += stride)
+                {
+                    //shift the sign bit into place
+                    int32_t sample = (int32_t)((p[0] << 8) | (p[1] << 16) |
+                                               ((uint32_t)p[2] << 24)) >> 8;
+                    output[i] = scale * sample;
+                }
+                break;
+            }
+            case PCM_32:
+            {
+                //rounded to float first, as libsndfile does, so that both
+                //readers give the same samples
+                for (int i = 0; i < nRead; ++i, p += stride)
+                {
+                    float sample = (float)(int32_t)readUInt32(p)
+                                   * (1.0f / 2147483648.0f);
+                    output[i] = gain * sample;
+                }
+                break;
+            }
+            case FLOAT:
+            {
+                for (int i = 0; i < nRead; ++i, p += stride)
+                {
+                    uint32_t bits = readUInt32(p);
+                    float sample;
+                    std::memcpy(&sample, &bits, sizeof(float));
+                    output[i] = gain * sample;
+                }
+                break;
+            }
+        }
+
+        for (int i = (int)nRead; i < nFrames; ++i)
+            output[i] = 0.0;
+
+        return nRead;
+    }
+
+    int MappedAudioFile::getNChannels() const
+    {
+        return nChannels_;
+    }
+
+    int MappedAudioFile::getFs() const
+    {
+        return fs_;
+    }
+
+    long long MappedAudioFile::getNFrames() const
+    {
+        return nFrames_;
+    }
+
+    MappedAudioFile::SampleFormat MappedAudioFile::getSampleFormat() const
+    {
+        return sampleFormat_;
+    }
+}
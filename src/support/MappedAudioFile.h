@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPEDAUDIOFILE_H
+#define MAPPEDAUDIOFILE_H
+
+#include "UsefulFunctions.h"
+
+namespace loudness{
+
+    /**
+     * @class MappedAudioFile
+     *
+     * @brief Reads the samples of an uncompressed WAV file directly from a
+     * memory mapping of the file.
+     *
+     * Supported are 16, 24 and 32 bit integer PCM and 32 bit float samples,
+     * including WAVE_FORMAT_EXTENSIBLE files. Samples are converted exactly
+     * as by libsndfile's float reads: integers are scaled so that full scale
+     * is 1, and 32 bit integers are rounded to float. Reading a file through
+     * the mapping or through libsndfile therefore gives the same samples.
+     *
+     * No audio buffer is involved: read() converts, scales and deinterleaves
+     * the samples of one channel straight into the destination, and the
+     * operating system pages the file in as it is read. Reads at any
+     * position are equally cheap.
+     *
+     * @sa AudioFileCutter
+     */
+    class MappedAudioFile
+    {
+    public:
+        /** Sample formats that can be read. */
+        enum SampleFormat{
+            PCM_16,
+            PCM_24,
+            PCM_32,
+            FLOAT
+        };
+
+        MappedAudioFile();
+        ~MappedAudioFile();
+
+        /**
+         * @brief Maps the file @a fileName.
+         *
+         * @return true if the file is a WAV file in a supported sample
+         * format and could be mapped, false otherwise (no error is
+         * reported, so that the caller can fall back to another reader).
+         */
+        bool open(const string& fileName);
+
+        /** Unmaps the file. */
+        void close();
+
+        bool isOpen() const;
+
+        /**
+         * @brief Reads @a nFrames samples of channel @a channel from frame
+         * @a startFrame into @a output, multiplied by @a gain.
+         *
+         * Samples beyond the end of the file are set to zero.
+         *
+         * @return The number of samples read from the file.
+         */
+        long long read(long long startFrame, int channel, int nFrames,
+                Real gain, Real* output) const;
+
+        int getNChannels() const;
+        int getFs() const;
+        long long getNFrames() const;
+        SampleFormat getSampleFormat() const;
+
+    private:
+        bool parseHeader(const unsigned char* file, size_t fileSize);
+
+        void* mapping_;
+        size_t mappingSize_;
+        const unsigned char* data_;
+        int nChannels_, fs_, bytesPerSample_, bytesPerFrame_;
+        long long nFrames_;
+        SampleFormat sampleFormat_;
+
+        MappedAudioFile(const MappedAudioFile&);
+        MappedAudioFile& operator=(const MappedAudioFile&);
+    };
+}
+
+#endif
@@ -17,6 +17,8 @@
  * along with Loudness.  If not, see <http://www.gnu.org/licenses/>. 
  */
 
+#include <functional>
+#include <thread>
 #include "Model.h"
 
 namespace loudness{
@@ -24,11 +26,30 @@ namespace loudness{
     Model::Model(string name, bool isDynamic) :
         name_(name),
         isDynamic_(isDynamic),
+        initialized_(false),
+        isProfilingEnabled_(false),
+        nModules_(0),
+        blockSize_(1),
+        maxNTimelineEvents_(0),
         rate_(0.0)
     {
         LOUDNESS_DEBUG(name_ << ": Constructed.");
     }
 
+    Model::Model(const Model& model) :
+        name_(model.name_),
+        isDynamic_(model.isDynamic_),
+        initialized_(false),
+        isProfilingEnabled_(model.isProfilingEnabled_),
+        nModules_(0),
+        blockSize_(model.blockSize_),
+        maxNTimelineEvents_(model.maxNTimelineEvents_),
+        rate_(model.rate_),
+        outputsToAggregate_(model.outputsToAggregate_)
+    {
+        LOUDNESS_DEBUG(name_ << ": Copied.");
+    }
+
     Model::~Model() {}
 
     bool Model::initialize(const SignalBank &input)
@@ -52,11 +73,16 @@ namespace loudness{
 
             nModules_ = (int)modules_.size();
 
+            for (int i = 0; i < nModules_; ++i)
+                modules_[i] -> setBlockSize(blockSize_);
+
             //initialise all from root module
             modules_[0] -> initialize(input);
 
             configureSignalBankAggregation();
 
+            configureProfiling();
+
             LOUDNESS_DEBUG(name_ 
                     << ": Module targets set and initialised.");
 
@@ -68,9 +94,428 @@ namespace loudness{
     void Model::process(const SignalBank &input)
     {
         if (initialized_)
-            modules_[0] -> process(input);
+        {
+            if (isProfilingEnabled_)
+            {
+                Profile::Stamp start = Profile::getStamp();
+                modules_[0] -> process(input);
+                profile_.record(-1, start, 1);
+            }
+            else
+            {
+                modules_[0] -> process(input);
+            }
+        }
         else
+        {
             LOUDNESS_WARNING(name_ << ": Not initialised!");
+        }
+    }
+
+    void Model::processBlock(const SignalBank* inputs, int nInputs)
+    {
+        if (initialized_)
+        {
+            for (int i = 0; i < nInputs; i += blockSize_)
+            {
+                int nBlockInputs = min(blockSize_, nInputs - i);
+                Profile::Stamp start = {0.0, 0.0};
+                if (isProfilingEnabled_)
+                    start = Profile::getStamp();
+                modules_[0] -> processBlock(inputs + i, nBlockInputs);
+                if (isProfilingEnabled_)
+                    profile_.record(-1, start, nBlockInputs);
+            }
+        }
+        else
+        {
+            LOUDNESS_WARNING(name_ << ": Not initialised!");
+        }
+    }
+
+    void Model::processInParallel(Module& source, int nInputs, int nThreads)
+    {
+        if (!initialized_)
+        {
+            LOUDNESS_WARNING(name_ << ": Not initialised!");
+            return;
+        }
+
+        /*
+         * Partition the module graph. Front-end modules run before the first
+         * stateless module, the stateless region follows and everything
+         * downstream of the region (the back end) is stateful again.
+         */
+        enum Stage {FRONT, REGION, BACK};
+        map<const Module*, int> moduleIdx;
+        for (int i = 0; i < nModules_; ++i)
+            moduleIdx[modules_[i].get()] = i;
+
+        vector<int> stage(nModules_, -1);
+        vector<std::pair<int, int> > splitEdges, sinkEdges;
+        std::function<void(int, int)> visit = [&](int idx, int parentStage)
+        {
+            if (stage[idx] >= 0)
+                return;
+            bool stateless = modules_[idx] -> isStateless();
+            if (parentStage == FRONT)
+                stage[idx] = stateless ? REGION : FRONT;
+            else if (parentStage == REGION)
+                stage[idx] = stateless ? REGION : BACK;
+            else
+                stage[idx] = BACK;
+
+            for (Module* target : modules_[idx] -> targetModules_)
+            {
+                int targetIdx = moduleIdx[target];
+                visit(targetIdx, stage[idx]);
+                if ((stage[idx] == FRONT) && (stage[targetIdx] == REGION))
+                    splitEdges.push_back(std::make_pair(idx, targetIdx));
+                else if ((stage[idx] == REGION) && (stage[targetIdx] != REGION))
+                    sinkEdges.push_back(std::make_pair(idx, targetIdx));
+            }
+        };
+        visit(0, FRONT);
+
+        vector<int> splits, region;
+        for (int i = 0; i < nModules_; ++i)
+        {
+            if (stage[i] == REGION)
+                region.push_back(i);
+        }
+        for (const auto& edge : splitEdges)
+        {
+            if (std::find(splits.begin(), splits.end(), edge.first) == splits.end())
+                splits.push_back(edge.first);
+        }
+
+        //copies of the model that evaluate the stateless region
+        vector<unique_ptr<Model> > workers;
+        if ((nThreads > 1) && !region.empty() && (stage[0] == FRONT))
+        {
+            for (int t = 0; t < nThreads; ++t)
+            {
+                unique_ptr<Model> worker = clone();
+                if (!worker)
+                    break;
+                worker -> setOutputsToAggregate(vector<string>());
+                worker -> setBlockSize(1);
+                worker -> setProfilingEnabled(false);
+                if (!worker -> initialize(source.getOutput())
+                        || (worker -> nModules_ != nModules_))
+                    break;
+                workers.push_back(std::move(worker));
+            }
+        }
+
+        if ((int)workers.size() < nThreads || workers.empty())
+        {
+            if (nThreads > 1)
+            {
+                LOUDNESS_WARNING(name_ 
+                        << ": Cannot process in parallel, processing sequentially.");
+            }
+            while (nInputs-- > 0)
+            {
+                source.process();
+                process(source.getOutput());
+            }
+            return;
+        }
+
+        /*
+         * Region modules whose output is aggregated or feeds the back end are
+         * stored for every frame. The remaining region modules only need the
+         * output of their most recently triggered frame.
+         */
+        vector<bool> isStored(region.size(), false);
+        vector<int> regionPos(nModules_, -1);
+        for (uint r = 0; r < region.size(); ++r)
+        {
+            regionPos[region[r]] = r;
+            isStored[r] = modules_[region[r]] -> isOutputAggregated_;
+        }
+        for (const auto& edge : sinkEdges)
+            isStored[regionPos[edge.first]] = true;
+
+        //workers evaluate the region only
+        for (auto& worker : workers)
+        {
+            for (const auto& edge : sinkEdges)
+            {
+                vector<Module*>& targets = worker -> modules_[edge.first]
+                                                 -> targetModules_;
+                targets.erase(std::remove(targets.begin(), targets.end(),
+                              worker -> modules_[edge.second].get()),
+                              targets.end());
+            }
+        }
+
+        //the front end of this model stops at the region
+        vector<vector<Module*> > splitTargets(splits.size());
+        for (uint k = 0; k < splits.size(); ++k)
+        {
+            vector<Module*>& targets = modules_[splits[k]] -> targetModules_;
+            splitTargets[k] = targets;
+            targets.erase(std::remove_if(targets.begin(), targets.end(),
+                          [&](Module* target)
+                          {
+                              return stage[moduleIdx[target]] == REGION;
+                          }),
+                          targets.end());
+        }
+
+        int nThreadsUsed = (int)workers.size();
+        int blockSize = 64 * nThreadsUsed;
+
+        //double-buffered front-end output and per-frame region output
+        vector<vector<SignalBank> > frames[2];
+        vector<vector<SignalBank> > regionOutputs(blockSize);
+        vector<vector<char> > regionTrigs(blockSize,
+                                          vector<char>(region.size(), 0));
+        vector<vector<char> > isTriggered(nThreadsUsed);
+        for (int buf = 0; buf < 2; ++buf)
+        {
+            frames[buf].resize(blockSize, vector<SignalBank>(splits.size()));
+            for (int i = 0; i < blockSize; ++i)
+            {
+                for (uint k = 0; k < splits.size(); ++k)
+                    frames[buf][i][k].initialize(modules_[splits[k]] -> output_);
+            }
+        }
+        for (int i = 0; i < blockSize; ++i)
+        {
+            regionOutputs[i].resize(region.size());
+            for (uint r = 0; r < region.size(); ++r)
+            {
+                if (isStored[r])
+                    regionOutputs[i][r].initialize(modules_[region[r]] -> output_);
+            }
+        }
+
+        auto processFrontEnd = [&](int buf, int nFrames)
+        {
+            for (int i = 0; i < nFrames; ++i)
+            {
+                source.process();
+                process(source.getOutput());
+                for (uint k = 0; k < splits.size(); ++k)
+                {
+                    const SignalBank& output = modules_[splits[k]] -> output_;
+                    frames[buf][i][k].setTrig(output.getTrig());
+                    if (output.getTrig())
+                        frames[buf][i][k].copySamples(output);
+                }
+            }
+        };
+
+        auto processRegion = [&](int t, int buf, int start, int end)
+        {
+            Model& worker = *workers[t];
+            isTriggered[t].assign(region.size(), 0);
+            for (int i = start; i < end; ++i)
+            {
+                for (const auto& edge : splitEdges)
+                {
+                    int k = std::find(splits.begin(), splits.end(), edge.first)
+                            - splits.begin();
+                    worker.modules_[edge.second] -> process(frames[buf][i][k]);
+                }
+                for (uint r = 0; r < region.size(); ++r)
+                {
+                    const SignalBank& output = worker.modules_[region[r]] -> output_;
+                    regionTrigs[i][r] = output.getTrig();
+                    if (output.getTrig())
+                    {
+                        isTriggered[t][r] = 1;
+                        if (isStored[r])
+                            regionOutputs[i][r].copySamples(output);
+                    }
+                }
+            }
+        };
+
+        auto commit = [&](int nFrames, int framesPerThread)
+        {
+            for (int i = 0; i < nFrames; ++i)
+            {
+                for (uint r = 0; r < region.size(); ++r)
+                {
+                    Module* module = modules_[region[r]].get();
+                    module -> output_.setTrig(regionTrigs[i][r]);
+                    if (isStored[r])
+                    {
+                        if (regionTrigs[i][r])
+                            module -> output_.copySamples(regionOutputs[i][r]);
+                        if (module -> isOutputAggregated_)
+                            module -> output_.aggregate();
+                    }
+                }
+                for (const auto& edge : sinkEdges)
+                    modules_[edge.second] -> process(modules_[edge.first] -> output_);
+            }
+
+            //remaining region outputs hold their last triggered frame
+            for (uint r = 0; r < region.size(); ++r)
+            {
+                if (isStored[r])
+                    continue;
+                for (int t = (nFrames - 1) / framesPerThread; t >= 0; --t)
+                {
+                    if (isTriggered[t][r])
+                    {
+                        modules_[region[r]] -> output_.copySamples(
+                                workers[t] -> modules_[region[r]] -> output_);
+                        break;
+                    }
+                }
+            }
+        };
+
+        int buf = 0;
+        int nFrames = std::min(blockSize, nInputs);
+        processFrontEnd(buf, nFrames);
+        nInputs -= nFrames;
+        while (nFrames > 0)
+        {
+            int framesPerThread = (nFrames + nThreadsUsed - 1) / nThreadsUsed;
+            vector<std::thread> threads;
+            for (int t = 0; t < nThreadsUsed; ++t)
+            {
+                int start = t * framesPerThread;
+                int end = std::min(nFrames, start + framesPerThread);
+                if (start < end)
+                    threads.push_back(std::thread(processRegion, t, buf, start, end));
+            }
+
+            int nNextFrames = std::min(blockSize, nInputs);
+            processFrontEnd(1 - buf, nNextFrames);
+            nInputs -= nNextFrames;
+
+            for (auto& thread : threads)
+                thread.join();
+
+            commit(nFrames, framesPerThread);
+            buf = 1 - buf;
+            nFrames = nNextFrames;
+        }
+
+        for (uint k = 0; k < splits.size(); ++k)
+            modules_[splits[k]] -> targetModules_ = splitTargets[k];
+    }
+
+    void Model::processInChunks(const vector<Module*>& sources,
+            const IntVec& nPreRollInputs, const IntVec& nInputs)
+    {
+        if (!initialized_)
+        {
+            LOUDNESS_WARNING(name_ << ": Not initialised!");
+            return;
+        }
+
+        int nChunks = (int)sources.size();
+        if (((int)nPreRollInputs.size() != nChunks)
+                || ((int)nInputs.size() != nChunks))
+        {
+            LOUDNESS_ERROR(name_ 
+                    << ": Expected a pre-roll and number of inputs per chunk.");
+            return;
+        }
+
+        //copies of the model that process all but the last chunk
+        vector<unique_ptr<Model> > workers;
+        for (int k = 0; k < nChunks - 1; ++k)
+        {
+            unique_ptr<Model> worker = clone();
+            if (!worker)
+                break;
+            worker -> setProfilingEnabled(false);
+            if (!worker -> initialize(sources[k] -> getOutput())
+                    || (worker -> nModules_ != nModules_))
+                break;
+            workers.push_back(std::move(worker));
+        }
+
+        if ((int)workers.size() < nChunks - 1)
+        {
+            LOUDNESS_WARNING(name_ 
+                    << ": Cannot process in chunks, processing sequentially.");
+            for (int k = 0; k < nChunks; ++k)
+            {
+                for (int i = 0; i < nPreRollInputs[k]; ++i)
+                    sources[k] -> process();
+                for (int i = 0; i < nInputs[k]; ++i)
+                {
+                    sources[k] -> process();
+                    process(sources[k] -> getOutput());
+                }
+            }
+            return;
+        }
+
+        auto processChunk = [](Model& model, Module& source,
+                               int nPreRoll, int n)
+        {
+            //the pre-roll only warms up the state, nothing is aggregated
+            vector<Module*> aggregated;
+            for (int i = 0; i < model.nModules_; ++i)
+            {
+                Module* module = model.modules_[i].get();
+                if (module -> isOutputAggregated_)
+                {
+                    aggregated.push_back(module);
+                    module -> isOutputAggregated_ = false;
+                }
+            }
+            while (nPreRoll-- > 0)
+            {
+                source.process();
+                model.process(source.getOutput());
+            }
+            for (Module* module : aggregated)
+                module -> isOutputAggregated_ = true;
+
+            while (n-- > 0)
+            {
+                source.process();
+                model.process(source.getOutput());
+            }
+        };
+
+        //outputs of the earlier chunks go before those of the last one
+        vector<long long> insertPositions(nModules_, 0);
+        for (int i = 0; i < nModules_; ++i)
+        {
+            insertPositions[i] = modules_[i] -> output_
+                                 .getAggregatedSignals().size();
+        }
+
+        vector<std::thread> threads;
+        for (int k = 0; k < nChunks - 1; ++k)
+        {
+            threads.push_back(std::thread(processChunk, std::ref(*workers[k]),
+                              std::ref(*sources[k]), nPreRollInputs[k],
+                              nInputs[k]));
+        }
+        processChunk(*this, *sources[nChunks - 1], nPreRollInputs[nChunks - 1],
+                     nInputs[nChunks - 1]);
+        for (auto& thread : threads)
+            thread.join();
+
+        for (int k = 0; k < nChunks - 1; ++k)
+        {
+            for (int i = 0; i < nModules_; ++i)
+            {
+                SignalBank& output = modules_[i] -> output_;
+                if (!modules_[i] -> isOutputAggregated_)
+                    continue;
+                const SignalBank& chunkOutput = workers[k] -> modules_[i]
+                                                -> output_;
+                output.insertAggregatedSignals(insertPositions[i], chunkOutput);
+                insertPositions[i] += chunkOutput.getAggregatedSignals().size();
+            }
+            workers[k].reset();
+        }
     }
 
     void Model::reset()
@@ -79,6 +524,11 @@ namespace loudness{
             modules_[0] -> reset();
     }
 
+    unique_ptr<Model> Model::clone() const
+    {
+        return unique_ptr<Model>();
+    }
+
     void Model::configureLinearTargetModuleChain(int moduleIdx)
     {
         int nModulesMinus1 = int (modules_.size()) - 1;
@@ -108,6 +558,16 @@ namespace loudness{
                     outputsToAggregate_.end(), outputToAggregate));
     }
 
+    const vector<string>& Model::getOutputsToAggregate() const
+    {
+        return outputsToAggregate_;
+    }
+
+    bool Model::hasOutput(const string& outputName) const
+    {
+        return outputModules_.find(outputName) != outputModules_.end();
+    }
+
     const SignalBank& Model::getOutput(const string& outputName) const
     {
         auto search = outputModules_.find(outputName);
@@ -115,6 +575,30 @@ namespace loudness{
         return search -> second -> getOutput();
     }
 
+    void Model::configureProfiling()
+    {
+        if (isProfilingEnabled_)
+            profile_.initialize(nModules_, maxNTimelineEvents_);
+        else
+            profile_.initialize(0, 0);
+
+        for (int i = 0; i < nModules_; ++i)
+        {
+            Module* module = modules_[i].get();
+            module -> profile_ = isProfilingEnabled_ ? &profile_ : nullptr;
+            module -> profileIndex_ = i;
+            if (isProfilingEnabled_)
+            {
+                const SignalBank& output = module -> output_;
+                int outputSize = output.isInitialized() ?
+                                 output.getNSources() * output.getNEars()
+                                 * output.getNChannels() * output.getNSamples()
+                                 : 0;
+                profile_.setModule(i, module -> getName(), outputSize);
+            }
+        }
+    }
+
     void Model::configureSignalBankAggregation()
     {
         for (const auto &outputName : outputsToAggregate_)
@@ -158,4 +642,35 @@ namespace loudness{
         return rate_;
     }
 
+    void Model::setBlockSize(int blockSize)
+    {
+        blockSize_ = max(blockSize, 1);
+    }
+
+    int Model::getBlockSize() const
+    {
+        return blockSize_;
+    }
+
+    void Model::setProfilingEnabled(bool isProfilingEnabled,
+            int maxNTimelineEvents)
+    {
+        isProfilingEnabled_ = isProfilingEnabled;
+        maxNTimelineEvents_ = max(maxNTimelineEvents, 0);
+    }
+
+    bool Model::isProfilingEnabled() const
+    {
+        return isProfilingEnabled_;
+    }
+
+    const Profile& Model::getProfile() const
+    {
+        return profile_;
+    }
+
+    void Model::resetProfile()
+    {
+        profile_.reset();
+    }
 }
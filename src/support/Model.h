@@ -21,6 +21,7 @@
 #define MODEL_H
 
 #include "Module.h"
+#include "Profile.h"
 
 namespace loudness{
 
@@ -70,6 +71,14 @@ namespace loudness{
         * @param isDynamic true if dynamic, false otherwise.
         */
         Model(string name = "Model", bool isDynamic = true);
+
+        /**
+        * @brief Copies the configuration of a loudness model.
+        *
+        * Modules are not copied, so the new model must be initialised before
+        * use.
+        */
+        Model(const Model& model);
         virtual ~Model();
 
         /**
@@ -93,6 +102,79 @@ namespace loudness{
         */
         void process(const SignalBank &input);
 
+        /**
+        * @brief Processes nInputs consecutive input SignalBanks in blocks of
+        * up to the block size (see setBlockSize()).
+        *
+        * Each module processes a whole block before its targets do (see
+        * Module::processBlock()), so coefficient tables stay in cache and
+        * modules such as PowerSpectrum and the roex filter banks batch their
+        * work across the frames of a block. Outputs and aggregated outputs
+        * are those obtained by calling process() for each input, except for
+        * rounding differences introduced by batched FFTs.
+        *
+        * @param inputs Array of input SignalBanks, each with the structure of
+        * the one used to initialise the model.
+        * @param nInputs Number of inputs.
+        */
+        void processBlock(const SignalBank* inputs, int nInputs);
+
+        /**
+        * @brief Processes nInputs SignalBanks generated by a source module,
+        * evaluating the stateless stages of the model on multiple threads.
+        *
+        * The result is bit-identical to calling source.process() followed by
+        * process(source.getOutput()) nInputs times. The front end of the model
+        * (e.g. the pre-cochlear filter and FrameGenerator) is run on the
+        * calling thread. The connected region of stateless modules that
+        * follows (see Module::isStateless()) is evaluated for blocks of frames
+        * by nThreads copies of the model, while the calling thread prepares
+        * the next block. The outputs of the stateless region are then
+        * committed in frame order, aggregating where required, and passed to
+        * the remaining stateful modules (e.g. ARAverager).
+        *
+        * The inputs are processed sequentially if nThreads is less than two,
+        * the model cannot be cloned or it has no stateless region.
+        *
+        * @param source A module generating its own input, such as
+        * AudioFileCutter. Its output must have the same structure as the
+        * SignalBank used to initialise the model.
+        * @param nInputs Number of times the source is processed.
+        * @param nThreads Number of worker threads.
+        */
+        void processInParallel(Module& source, int nInputs, int nThreads);
+
+        /**
+        * @brief Processes consecutive chunks of a signal on multiple threads,
+        * each chunk by its own copy of the model.
+        *
+        * Chunk k is generated by sources[k], which is processed
+        * nPreRollInputs[k] times to warm up the state of the model (e.g. the
+        * long-term loudness of ARAverager) and then nInputs[k] times. Output
+        * is only aggregated for the latter inputs, and the aggregated outputs
+        * of all chunks are joined in chunk order. The last chunk is processed
+        * by this model on the calling thread, so that its outputs and state
+        * are those at the end of the last chunk.
+        *
+        * Unlike processInParallel(), the result is approximate: the state of
+        * a model at the start of a chunk depends only on the pre-roll, not on
+        * the whole of the preceding signal. The pre-roll should therefore be
+        * several times longer than the longest time constant of the model.
+        *
+        * If the model cannot be cloned, the chunks are processed sequentially
+        * by this model, skipping the pre-rolls, which is exact if the
+        * chunks are contiguous.
+        *
+        * @param sources One module per chunk generating its own input, such
+        * as AudioFileCutter, positioned at the start of the pre-roll. Outputs
+        * must have the same structure as the SignalBank used to initialise
+        * the model.
+        * @param nPreRollInputs Number of pre-roll inputs of each chunk.
+        * @param nInputs Number of inputs of each chunk.
+        */
+        void processInChunks(const vector<Module*>& sources,
+                const IntVec& nPreRollInputs, const IntVec& nInputs);
+
         /**
         * @brief Resets all modules. The output SignalBanks are also cleared.
         */
@@ -112,6 +194,9 @@ namespace loudness{
          * with the module mapped to the name outputToAggregate. */
         void removeOutputToAggregate(string& outputToAggregate);
 
+        /** Returns the names of the outputs to aggregate. */
+        const vector<string>& getOutputsToAggregate() const;
+
         /** Sets the processing rate in Hz for a dynamic loudness
          * model. Note that after initialisation, the true processing rate will
          * be dependent on the sampling frequency and the input buffer size.
@@ -124,6 +209,41 @@ namespace loudness{
          */
         Real getRate() const;
 
+        /** Sets the number of inputs processed together by processBlock().
+         * Takes effect on the next call to initialize(). The default is 1.
+         */
+        void setBlockSize(int blockSize);
+
+        /** Returns the number of inputs processed together by
+         * processBlock(). */
+        int getBlockSize() const;
+
+        /**
+         * @brief Enables or disables profiling of the modules.
+         *
+         * When enabled, the processing calls of every module are counted and
+         * timed (see Profile). Up to maxNTimelineEvents calls are also logged
+         * for export as a timeline. Takes effect on the next call to
+         * initialize(), which clears the profile. Profiling is disabled by
+         * default, in which case the overhead is a pointer test per module
+         * call.
+         *
+         * processInParallel() only profiles the modules run on the calling
+         * thread.
+         */
+        void setProfilingEnabled(bool isProfilingEnabled,
+                int maxNTimelineEvents = 0);
+
+        /** Returns true if profiling is enabled. */
+        bool isProfilingEnabled() const;
+
+        /** Returns the profile of the modules since initialisation or the
+         * last call to resetProfile(). */
+        const Profile& getProfile() const;
+
+        /** Clears the profile. */
+        void resetProfile();
+
         /**
          * @brief Returns the initialisation state.
          *
@@ -142,6 +262,9 @@ namespace loudness{
          */
         const SignalBank& getOutput(const string& outputName) const;
 
+        /** Returns true if outputName is the name of an output module. */
+        bool hasOutput(const string& outputName) const;
+
         /**
          * @brief Returns the number of initialised modules comprising the
          * model.
@@ -156,6 +279,10 @@ namespace loudness{
     protected:
         virtual bool initializeInternal(const SignalBank &input) = 0;
 
+        /** Returns a new, uninitialised model with the same configuration, or
+         * an empty pointer if the model cannot be copied (the default). */
+        virtual unique_ptr<Model> clone() const;
+
         /** Sets each modules in the chain to be the target of it's
          * predecessor. */
         void configureLinearTargetModuleChain(int = 0);
@@ -163,13 +290,17 @@ namespace loudness{
         /** Informs modules to aggregate the output SignalBank. */
         void configureSignalBankAggregation();
 
+        /** Points the modules at the profile if profiling is enabled. */
+        void configureProfiling();
+
         string name_;
-        bool isDynamic_, initialized_;
-        int nModules_;
+        bool isDynamic_, initialized_, isProfilingEnabled_;
+        int nModules_, blockSize_, maxNTimelineEvents_;
         Real rate_;
         vector<unique_ptr<Module>> modules_;
         map<string, Module*> outputModules_;
         vector<string> outputsToAggregate_;
+        Profile profile_;
     };
 }
 
@@ -18,13 +18,56 @@
  */
 
 #include "Module.h"
+#include "AllocationCounter.h"
+#include "Profile.h"
+
+/*
+ * Reports heap allocations made by a module while processing (builds with
+ * COUNT_ALLOCATIONS only, see AllocationCounter).
+ */
+#if defined(COUNT_ALLOCATIONS)
+#define LOUDNESS_CHECK_ALLOCATIONS(call) \
+    do { \
+        long nAllocations = AllocationCounter::getNAllocations(); \
+        call; \
+        nAllocations = AllocationCounter::getNAllocations() - nAllocations; \
+        if (nAllocations > 0) \
+        { \
+            AllocationCounter::reportProcessAllocations(nAllocations); \
+            LOUDNESS_WARNING(name_ << ": " << nAllocations \
+                    << " allocation(s) while processing."); \
+        } \
+    } while (false)
+#else
+#define LOUDNESS_CHECK_ALLOCATIONS(call) call
+#endif
+
+/*
+ * Times a processing call when the module is profiled (see Profile).
+ */
+#define LOUDNESS_PROFILE(call, nFrames) \
+    do { \
+        if (profile_) \
+        { \
+            Profile::Stamp start = Profile::getStamp(); \
+            call; \
+            profile_ -> record(profileIndex_, start, nFrames); \
+        } \
+        else \
+        { \
+            call; \
+        } \
+    } while (false)
 
 namespace loudness{
     
     Module::Module(const string& name) :
         name_(name),
         initialized_(false),
-        isOutputAggregated_(false)
+        isOutputAggregated_(false),
+        blockSize_(1),
+        profile_(nullptr),
+        profileIndex_(0)
     {
         LOUDNESS_DEBUG(name_ << ": Constructed.");
     };
@@ -75,6 +118,15 @@ namespace loudness{
             LOUDNESS_DEBUG(name_ << ": Initialised.");
             if(output_.isInitialized())
             {
+                //one output per input of a block
+                outputBlock_.clear();
+                if (blockSize_ > 1)
+                {
+                    outputBlock_.resize(blockSize_);
+                    for (int i = 0; i < blockSize_; ++i)
+                        outputBlock_[i].initialize(output_);
+                }
+
                 for (uint i = 0; i < targetModules_.size(); i++)
                     targetModules_[i] -> initialize(output_);
             }
@@ -90,7 +142,7 @@ namespace loudness{
         {
             LOUDNESS_PROCESS_DEBUG(name_ << ": processing ...");
             output_.setTrig(true);
-            processInternal();
+            LOUDNESS_PROFILE(LOUDNESS_CHECK_ALLOCATIONS(processInternal()), 1);
             if (isOutputAggregated_)
                 output_.aggregate();
 
@@ -109,7 +161,8 @@ namespace loudness{
             {
                 LOUDNESS_PROCESS_DEBUG(name_ << ": processing SignalBank ...");
                 output_.setTrig(true);
-                processInternal(input);
+                LOUDNESS_PROFILE(LOUDNESS_CHECK_ALLOCATIONS(
+                            processInternal(input)), 1);
             }
             else
             {
@@ -127,6 +180,87 @@ namespace loudness{
         }
     }
 
+    void Module::processBlock(const SignalBank* inputs, int nInputs)
+    {
+        if (initialized_ && (nInputs > 0))
+        {
+            //no block storage, process one input at a time
+            if (outputBlock_.empty())
+            {
+                for (int i = 0; i < nInputs; ++i)
+                    process(inputs[i]);
+                return;
+            }
+
+            LOUDNESS_ASSERT(nInputs <= (int)outputBlock_.size(),
+                    name_ << ": Number of inputs exceeds the block size.");
+            LOUDNESS_PROCESS_DEBUG(name_ << ": processing block of "
+                    << nInputs << " SignalBanks ...");
+
+            LOUDNESS_PROFILE(LOUDNESS_CHECK_ALLOCATIONS(
+                    processBlockInternal(inputs, nInputs)), nInputs);
+
+            if (isStateless())
+            {
+                output_.copySamples(outputBlock_[nInputs - 1]);
+                output_.setTrig(outputBlock_[nInputs - 1].getTrig());
+            }
+
+            if (isOutputAggregated_)
+            {
+                LOUDNESS_PROCESS_DEBUG(name_ << ": Aggregating output SignalBanks.");
+                for (int i = 0; i < nInputs; ++i)
+                    output_.aggregate(outputBlock_[i]);
+            }
+
+            for (uint i = 0; i < targetModules_.size(); i++)
+                targetModules_[i] -> processBlock(outputBlock_.data(), nInputs);
+        }
+    }
+
+    void Module::processBlockInternal(const SignalBank* inputs, int nInputs)
+    {
+        for (int i = 0; i < nInputs; ++i)
+        {
+            SignalBank& output = outputBlock_[i];
+            if (inputs[i].getTrig())
+            {
+                if (isStateless())
+                {
+                    //process straight into the block
+                    output_.swapSignals(output);
+                    output_.setTrig(true);
+                    processInternal(inputs[i]);
+                    output_.swapSignals(output);
+                }
+                else
+                {
+                    output_.setTrig(true);
+                    processInternal(inputs[i]);
+                    output.copySamples(output_);
+                    output.setTrig(output_.getTrig());
+                }
+            }
+            else
+            {
+                //the output is not updated, as in process()
+                output.copySamples(i ? outputBlock_[i - 1] : output_);
+                output.setTrig(false);
+                output_.setTrig(false);
+            }
+        }
+    }
+
+    bool Module::isBlockTriggered(const SignalBank* inputs, int nInputs)
+    {
+        for (int i = 0; i < nInputs; ++i)
+        {
+            if (!inputs[i].getTrig())
+                return false;
+        }
+        return true;
+    }
+
     void Module::reset()
     {
         //clear output signal
@@ -167,6 +301,32 @@ namespace loudness{
         return isOutputAggregated_;
     }
 
+    bool Module::isStateless() const
+    {
+        return false;
+    }
+
+    bool Module::readsRingBuffers() const
+    {
+        return false;
+    }
+
+    void Module::setBlockSize(int blockSize)
+    {
+        blockSize_ = max(blockSize, 1);
+    }
+
+    int Module::getBlockSize() const
+    {
+        return blockSize_;
+    }
+
+    const SignalBank& Module::getBlockOutput(int i) const
+    {
+        LOUDNESS_ASSERT(isPositiveAndLessThanUpper(i, (int)outputBlock_.size()));
+        return outputBlock_[i];
+    }
+
     const SignalBank& Module::getOutput() const
     {
         return output_;
@@ -24,6 +24,8 @@
 
 namespace loudness{
 
+    class Profile;
+
     /**
      * @class Module
      * 
@@ -109,6 +111,35 @@ namespace loudness{
          */
         void process(const SignalBank &input);
 
+        /**
+         * @brief Processes nInputs consecutive input SignalBanks (block mode).
+         *
+         * The result is that of passing each input to process() in turn, to
+         * rounding (batched FFTs, for instance, may round differently), but
+         * the whole block is processed by this module before it is passed to
+         * the targets, so coefficients stay in cache and modules can batch
+         * their work across frames (see processBlockInternal()). The output
+         * for input i is returned by getBlockOutput(i) and getOutput() holds
+         * the output for the last input.
+         *
+         * @param inputs Array of input SignalBanks, each with the structure
+         * of the one used to initialise the module.
+         * @param nInputs Number of inputs, which must not exceed the block
+         * size.
+         */
+        void processBlock(const SignalBank* inputs, int nInputs);
+
+        /**
+         * @brief Sets the maximum number of inputs passed to processBlock().
+         *
+         * Takes effect when the module is next initialised. The default is 1,
+         * in which case processBlock() calls process() for each input.
+         */
+        void setBlockSize(int blockSize);
+
+        /** Returns the maximum number of inputs passed to processBlock(). */
+        int getBlockSize() const;
+
         /**
          * @brief Restores a module to intialisation state and clears the
          * contents of it's output SignalBank.
@@ -148,6 +179,27 @@ namespace loudness{
          **/
         bool isOutputAggregated() const;
 
+        /**
+         * @brief Returns true if the output SignalBank depends only on the
+         * current input SignalBank.
+         *
+         * Stateless modules carry nothing from one call of process() to the
+         * next, so consecutive frames can be processed by separate copies of
+         * the module at the same time (see Model::processInParallel()).
+         * Modules with recursive state (filters, averagers, frame buffers)
+         * must keep the default, which is false.
+         */
+        virtual bool isStateless() const;
+
+        /**
+         * @brief Returns true if the module can process input SignalBanks
+         * stored as circular buffers (see SignalBank::getRingOffset()).
+         *
+         * FrameGenerator avoids moving its frame on every hop when all of its
+         * targets read ring buffers. The default is false.
+         */
+        virtual bool readsRingBuffers() const;
+
         /**
          * @brief Returns a const reference to the output SignalBank used for
          * storing the processing result.
@@ -155,6 +207,12 @@ namespace loudness{
          */
         const SignalBank& getOutput() const;
 
+        /**
+         * @brief Returns the output SignalBank for input number i of the last
+         * call to processBlock().
+         */
+        const SignalBank& getBlockOutput(int i) const;
+
         /**
          * @brief Returns the name of the module.
          *
@@ -163,6 +221,8 @@ namespace loudness{
         const string& getName() const;
 
     protected:
+        friend class Model;
+
         //Pure virtual functions
         virtual bool initializeInternal(const SignalBank &input) = 0;
         virtual bool initializeInternal() = 0;
@@ -170,11 +230,32 @@ namespace loudness{
         virtual void processInternal() = 0;
         virtual void resetInternal() = 0;
 
+        /**
+         * @brief Processes a block of inputs, storing the output for input i
+         * in outputBlock_[i].
+         *
+         * The default calls processInternal() for each input. Stateless
+         * modules write straight into the block, others copy output_ after
+         * each input. Overrides of stateful modules must leave output_ holding
+         * the output for the last input; for stateless modules this is done
+         * by processBlock().
+         */
+        virtual void processBlockInternal(const SignalBank* inputs, int nInputs);
+
+        /** Returns true if every input of a block is triggered. */
+        static bool isBlockTriggered(const SignalBank* inputs, int nInputs);
+
         //members
         string name_;
         bool initialized_, isOutputAggregated_;
+        int blockSize_;
         vector<Module*> targetModules_;
         SignalBank output_;
+        vector<SignalBank> outputBlock_;
+
+        //set by Model when profiling, see Model::setProfilingEnabled()
+        Profile* profile_;
+        int profileIndex_;
     };
 }
 
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PartitionedConvolution.h"
+
+namespace loudness{
+
+    PartitionedConvolution::PartitionedConvolution() :
+        partitionSize_(0),
+        fftSize_(0),
+        nBins_(0),
+        nPartitions_(0),
+        nSignals_(0),
+        position_(0),
+        timeBuf_(0),
+        spectrumBuf_(0)
+    {}
+
+    PartitionedConvolution::~PartitionedConvolution()
+    {
+        freeBuffers();
+    }
+
+    void PartitionedConvolution::freeBuffers()
+    {
+        if (timeBuf_)
+        {
+            FFTW(free)(timeBuf_);
+            FFTW(free)(spectrumBuf_);
+            timeBuf_ = 0;
+            spectrumBuf_ = 0;
+        }
+    }
+
+    void PartitionedConvolution::setImpulseResponse(
+            const RealVec& impulseResponse)
+    {
+        impulseResponse_ = impulseResponse;
+    }
+
+    bool PartitionedConvolution::initialize(const SignalBank& input)
+    {
+        if (impulseResponse_.empty() || (input.getNSamples() < 1))
+            return 0;
+
+        partitionSize_ = input.getNSamples();
+        fftSize_ = 2 * partitionSize_;
+        nBins_ = partitionSize_ + 1;
+        int nTaps = (int)impulseResponse_.size();
+        nPartitions_ = (nTaps + partitionSize_ - 1) / partitionSize_;
+        nSignals_ = input.getNSources() * input.getNEars() *
+                    input.getNChannels();
+
+        freeBuffers();
+        timeBuf_ = (Real*) FFTW(malloc)(sizeof(Real) * fftSize_);
+        spectrumBuf_ = (Real*) FFTW(malloc)(sizeof(Real) * 2 * nBins_);
+        forwardPlan_ = FFT::getPlan(fftSize_, 1);
+        inversePlan_ = FFT::getPlan(fftSize_, 1, true);
+
+        /*
+         * Each partition occupies the first half of a transform, so that the
+         * second half of the circular convolution with the last two input
+         * blocks is free of wrap-around. The inverse transform is unscaled,
+         * so the spectra are normalised here instead.
+         */
+        filterSpectra_.assign(nPartitions_ * 2 * nBins_, 0.0);
+        for (int p = 0; p < nPartitions_; ++p)
+        {
+            int start = p * partitionSize_;
+            int length = min(partitionSize_, nTaps - start);
+            for (int i = 0; i < fftSize_; ++i)
+                timeBuf_[i] = i < length ?
+                              impulseResponse_[start + i] / fftSize_ : 0.0;
+
+            FFTW(execute_dft_r2c)(forwardPlan_, timeBuf_,
+                                  (FFTW(complex)*)spectrumBuf_);
+            std::copy(spectrumBuf_, spectrumBuf_ + 2 * nBins_,
+                      filterSpectra_.begin() + p * 2 * nBins_);
+        }
+
+        inputSpectra_.assign(nSignals_ * nPartitions_ * 2 * nBins_, 0.0);
+        history_.assign(nSignals_ * partitionSize_, 0.0);
+        position_ = 0;
+
+        return 1;
+    }
+
+    void PartitionedConvolution::process(const SignalBank& input,
+                                         SignalBank& output)
+    {
+        const Real* x = input.getSignalReadPointer(0, 0, 0);
+        Real* y = output.getSignalWritePointer(0, 0, 0);
+        int spectrumSize = 2 * nBins_;
+
+        for (int sig = 0; sig < nSignals_; ++sig)
+        {
+            const Real* inputSignal = x + sig * partitionSize_;
+            Real* outputSignal = y + sig * partitionSize_;
+            Real* history = &history_[sig * partitionSize_];
+            Real* spectra = &inputSpectra_[sig * nPartitions_ * spectrumSize];
+
+            //transform of the previous and current blocks
+            std::copy(history, history + partitionSize_, timeBuf_);
+            std::copy(inputSignal, inputSignal + partitionSize_,
+                      timeBuf_ + partitionSize_);
+            std::copy(inputSignal, inputSignal + partitionSize_, history);
+            FFTW(execute_dft_r2c)(forwardPlan_, timeBuf_,
+                                  (FFTW(complex)*)spectrumBuf_);
+            std::copy(spectrumBuf_, spectrumBuf_ + spectrumSize,
+                      spectra + position_ * spectrumSize);
+
+            //sum of the products of the input and partition spectra
+            std::fill(spectrumBuf_, spectrumBuf_ + spectrumSize, 0.0);
+            for (int p = 0; p < nPartitions_; ++p)
+            {
+                int slot = position_ - p;
+                if (slot < 0)
+                    slot += nPartitions_;
+                const Real* in = spectra + slot * spectrumSize;
+                const Real* h = &filterSpectra_[p * spectrumSize];
+                Real* acc = spectrumBuf_;
+                for (int k = 0; k < spectrumSize; k += 2)
+                {
+                    acc[k] += in[k] * h[k] - in[k + 1] * h[k + 1];
+                    acc[k + 1] += in[k] * h[k + 1] + in[k + 1] * h[k];
+                }
+            }
+
+            FFTW(execute_dft_c2r)(inversePlan_,
+                                  (FFTW(complex)*)spectrumBuf_, timeBuf_);
+            std::copy(timeBuf_ + partitionSize_, timeBuf_ + fftSize_,
+                      outputSignal);
+        }
+
+        if (++position_ == nPartitions_)
+            position_ = 0;
+    }
+
+    void PartitionedConvolution::reset()
+    {
+        std::fill(inputSpectra_.begin(), inputSpectra_.end(), 0.0);
+        std::fill(history_.begin(), history_.end(), 0.0);
+        position_ = 0;
+    }
+
+    int PartitionedConvolution::getPartitionSize() const
+    {
+        return partitionSize_;
+    }
+
+    int PartitionedConvolution::getNPartitions() const
+    {
+        return nPartitions_;
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARTITIONEDCONVOLUTION_H
+#define PARTITIONEDCONVOLUTION_H
+
+#include "FFT.h"
+
+namespace loudness{
+
+    /**
+     * @class PartitionedConvolution
+     *
+     * @brief Convolves every signal of a SignalBank with an impulse response
+     * using uniformly partitioned overlap-save FFT convolution.
+     *
+     * The impulse response is split into partitions of the SignalBank's
+     * block size, each of which is transformed once by initialize(). Every
+     * call to process() transforms the current and previous input blocks,
+     * multiplies the spectra of the last few blocks with those of the
+     * partitions and transforms the sum back. The output of a block is
+     * therefore available as soon as the block has been processed, with no
+     * latency beyond that of the impulse response itself.
+     *
+     * The cost per sample is roughly proportional to the number of
+     * partitions rather than the number of taps, so this is much faster than
+     * a direct form filter for long impulse responses and blocks of more
+     * than a few samples.
+     *
+     * @sa FIR
+     */
+    class PartitionedConvolution
+    {
+    public:
+        PartitionedConvolution();
+        ~PartitionedConvolution();
+
+        void setImpulseResponse(const RealVec& impulseResponse);
+
+        /**
+         * @brief Partitions and transforms the impulse response and allocates
+         * the input history of all signals of @a input.
+         *
+         * The partition size is the number of samples of @a input.
+         */
+        bool initialize(const SignalBank& input);
+
+        /**
+         * @brief Filters all signals of @a input into @a output.
+         *
+         * The SignalBanks must have the shape passed to initialize().
+         */
+        void process(const SignalBank& input, SignalBank& output);
+
+        /** Clears the input history. */
+        void reset();
+
+        int getPartitionSize() const;
+        int getNPartitions() const;
+
+    private:
+        void freeBuffers();
+
+        RealVec impulseResponse_;
+        int partitionSize_, fftSize_, nBins_, nPartitions_, nSignals_;
+        int position_;
+        //spectra of the partitions, real and imaginary parts interleaved
+        RealVec filterSpectra_;
+        //spectra of the last nPartitions_ input blocks of every signal
+        RealVec inputSpectra_;
+        //previous input block of every signal
+        RealVec history_;
+        //FFTW buffers, shared by all signals
+        Real *timeBuf_, *spectrumBuf_;
+        FFTW(plan) forwardPlan_, inversePlan_;
+    };
+}
+
+#endif
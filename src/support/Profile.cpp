@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profile.h"
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+
+namespace loudness{
+
+    Profile::Profile() :
+        maxNEvents_(0),
+        nDroppedEvents_(0)
+    {
+        reset();
+    }
+
+    Profile::~Profile() {}
+
+    void Profile::initialize(int nModules, int maxNEvents)
+    {
+        names_.assign(nModules, "Module");
+        outputSizes_.assign(nModules, 0);
+        counters_.resize(nModules);
+        maxNEvents_ = std::max(0, maxNEvents);
+        events_.clear();
+        events_.reserve(maxNEvents_);
+        reset();
+    }
+
+    void Profile::setModule(int module, const string& name, int outputSize)
+    {
+        names_[module] = name;
+        outputSizes_[module] = outputSize;
+    }
+
+    void Profile::reset()
+    {
+        Counter zero = {0, 0, 0.0, 0.0, 0.0, 0.0};
+        counters_.assign(counters_.size(), zero);
+        modelCounter_ = zero;
+        events_.clear();
+        nDroppedEvents_ = 0;
+        origin_ = getStamp();
+    }
+
+    Profile::Stamp Profile::getStamp()
+    {
+        Stamp stamp;
+        stamp.wallTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#if defined(__linux__)
+        //CPU time of the calling thread
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        stamp.cpuTime = time.tv_sec + 1e-9 * time.tv_nsec;
+#else
+        stamp.cpuTime = std::clock() / (double)CLOCKS_PER_SEC;
+#endif
+        return stamp;
+    }
+
+    void Profile::accumulate(Counter& counter, const Stamp& start,
+            const Stamp& end, int nFrames)
+    {
+        double wallTime = end.wallTime - start.wallTime;
+        double cpuTime = end.cpuTime - start.cpuTime;
+        counter.nCalls++;
+        counter.nFrames += nFrames;
+        counter.totalWallTime += wallTime;
+        counter.maxWallTime = std::max(counter.maxWallTime, wallTime);
+        counter.totalCpuTime += cpuTime;
+        counter.maxCpuTime = std::max(counter.maxCpuTime, cpuTime);
+    }
+
+    void Profile::record(int module, const Stamp& start, int nFrames)
+    {
+        Stamp end = getStamp();
+        int frame = (int)modelCounter_.nFrames;
+        if (module < 0)
+            accumulate(modelCounter_, start, end, nFrames);
+        else
+            accumulate(counters_[module], start, end, nFrames);
+
+        //capacity is reserved by initialize()
+        if ((int)events_.size() < maxNEvents_)
+        {
+            Event event = {module, frame, nFrames,
+                           start.wallTime - origin_.wallTime,
+                           end.wallTime - start.wallTime,
+                           end.cpuTime - start.cpuTime};
+            events_.push_back(event);
+        }
+        else
+        {
+            nDroppedEvents_++;
+        }
+    }
+
+    int Profile::getNModules() const
+    {
+        return (int)counters_.size();
+    }
+
+    const string& Profile::getModuleName(int module) const
+    {
+        return names_[module];
+    }
+
+    int Profile::getOutputSize(int module) const
+    {
+        return outputSizes_[module];
+    }
+
+    long Profile::getNCalls(int module) const
+    {
+        return counters_[module].nCalls;
+    }
+
+    long Profile::getNFramesProcessed(int module) const
+    {
+        return counters_[module].nFrames;
+    }
+
+    Real Profile::getTotalWallTime(int module) const
+    {
+        return counters_[module].totalWallTime;
+    }
+
+    Real Profile::getMaxWallTime(int module) const
+    {
+        return counters_[module].maxWallTime;
+    }
+
+    Real Profile::getTotalCpuTime(int module) const
+    {
+        return counters_[module].totalCpuTime;
+    }
+
+    Real Profile::getMaxCpuTime(int module) const
+    {
+        return counters_[module].maxCpuTime;
+    }
+
+    long Profile::getNFrames() const
+    {
+        return modelCounter_.nFrames;
+    }
+
+    Real Profile::getTotalWallTime() const
+    {
+        return modelCounter_.totalWallTime;
+    }
+
+    Real Profile::getTotalCpuTime() const
+    {
+        return modelCounter_.totalCpuTime;
+    }
+
+    int Profile::getNEvents() const
+    {
+        return (int)events_.size();
+    }
+
+    long Profile::getNDroppedEvents() const
+    {
+        return nDroppedEvents_;
+    }
+
+    string Profile::getSummary() const
+    {
+        std::ostringstream out;
+        out << std::left << std::setw(4) << "#" << std::setw(36) << "Module"
+            << std::right << std::setw(10) << "Calls"
+            << std::setw(10) << "Frames"
+            << std::setw(12) << "Wall (ms)"
+            << std::setw(12) << "Mean (us)"
+            << std::setw(12) << "Max (us)"
+            << std::setw(12) << "CPU (ms)"
+            << std::setw(8) << "%"
+            << std::setw(10) << "Output" << "\n";
+
+        out << std::fixed;
+        for (int i = 0; i < getNModules(); ++i)
+        {
+            const Counter& counter = counters_[i];
+            double mean = counter.nCalls > 0 ?
+                          counter.totalWallTime / counter.nCalls : 0.0;
+            double share = modelCounter_.totalWallTime > 0 ?
+                           counter.totalWallTime / modelCounter_.totalWallTime
+                           : 0.0;
+            out << std::left << std::setw(4) << i
+                << std::setw(36) << names_[i].substr(0, 35)
+                << std::right << std::setw(10) << counter.nCalls
+                << std::setw(10) << counter.nFrames
+                << std::setprecision(3)
+                << std::setw(12) << 1e3 * counter.totalWallTime
+                << std::setprecision(2)
+                << std::setw(12) << 1e6 * mean
+                << std::setw(12) << 1e6 * counter.maxWallTime
+                << std::setprecision(3)
+                << std::setw(12) << 1e3 * counter.totalCpuTime
+                << std::setprecision(1)
+                << std::setw(8) << 100 * share
+                << std::setw(10) << outputSizes_[i] << "\n";
+        }
+
+        out << std::left << std::setw(40) << "Model"
+            << std::right << std::setw(10) << modelCounter_.nCalls
+            << std::setw(10) << modelCounter_.nFrames
+            << std::setprecision(3)
+            << std::setw(12) << 1e3 * modelCounter_.totalWallTime
+            << std::setw(12) << ""
+            << std::setprecision(2)
+            << std::setw(12) << 1e6 * modelCounter_.maxWallTime
+            << std::setprecision(3)
+            << std::setw(12) << 1e3 * modelCounter_.totalCpuTime << "\n";
+        return out.str();
+    }
+
+    bool Profile::exportChromeTrace(const string& filename) const
+    {
+        FILE* file = fopen(filename.c_str(), "w");
+        if (!file)
+        {
+            LOUDNESS_ERROR("Profile: Cannot open " << filename << ".");
+            return 0;
+        }
+
+        fprintf(file, "{\"traceEvents\":[\n");
+        for (uint i = 0; i < events_.size(); ++i)
+        {
+            const Event& event = events_[i];
+            string name = event.module < 0 ? "Frame" : names_[event.module];
+            name.erase(std::remove_if(name.begin(), name.end(),
+                       [](char c) {return c == '"' || c == '\\';}),
+                       name.end());
+            fprintf(file, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                    "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,"
+                    "\"args\":{\"module\":%d,\"frame\":%d,\"nFrames\":%d,"
+                    "\"cpu_us\":%.3f}}%s\n",
+                    name.c_str(), event.module < 0 ? "model" : "module",
+                    1e6 * event.start, 1e6 * event.wallTime,
+                    event.module, event.frame, event.nFrames,
+                    1e6 * event.cpuTime,
+                    i + 1 < events_.size() ? "," : "");
+        }
+        fprintf(file, "],\n\"displayTimeUnit\":\"ms\"}\n");
+
+        bool isWritten = !ferror(file);
+        fclose(file);
+        if (!isWritten)
+            LOUDNESS_ERROR("Profile: Cannot write " << filename << ".");
+        return isWritten;
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "Common.h"
+
+namespace loudness{
+
+    /**
+     * @class Profile
+     *
+     * @brief Per-module processing statistics of a Model.
+     *
+     * When profiling is enabled (see Model::setProfilingEnabled()), every
+     * call a module makes to processInternal() or processBlockInternal() is
+     * timed. For each module the profile holds the number of calls, the
+     * number of frames processed, the total and maximum wall-clock time and
+     * the total and maximum CPU time of the calling thread, together with
+     * the size of the output SignalBank. Times are in seconds. Calls to
+     * Model::process() and Model::processBlock() are counted as frames.
+     *
+     * Each call is also logged as a timeline event, up to the capacity set
+     * by initialize(). The timeline can be written as a Chrome trace-event
+     * JSON file with exportChromeTrace() and opened in chrome://tracing or
+     * Perfetto, where every model call appears as a "Frame" slice containing
+     * the module slices.
+     *
+     * Storage is allocated by initialize(), so recording does not allocate
+     * memory; events beyond the capacity are dropped (see
+     * getNDroppedEvents()).
+     *
+     * @sa Model
+     */
+    class Profile
+    {
+    public:
+
+        /** A point in time on the wall and thread CPU clocks. */
+        struct Stamp
+        {
+            double wallTime, cpuTime;
+        };
+
+        Profile();
+        ~Profile();
+
+        /**
+         * @brief Clears the profile and allocates storage.
+         *
+         * @param nModules Number of modules profiled.
+         * @param maxNEvents Maximum number of timeline events recorded.
+         */
+        void initialize(int nModules, int maxNEvents);
+
+        /** Sets the name and output SignalBank size of a module. */
+        void setModule(int module, const string& name, int outputSize);
+
+        /** Clears all counters and the timeline. */
+        void reset();
+
+        /** Returns the current time on both clocks. */
+        static Stamp getStamp();
+
+        /**
+         * @brief Records a call that started at start and ends now.
+         *
+         * Module events are attributed to the frame being processed by the
+         * model. Recording a model call (module -1) advances the frame
+         * count by nFrames.
+         *
+         * @param module Index of the module, or -1 for a call to the model.
+         * @param nFrames Number of frames processed by the call.
+         */
+        void record(int module, const Stamp& start, int nFrames);
+
+        /** Returns the number of modules profiled. */
+        int getNModules() const;
+        const string& getModuleName(int module) const;
+
+        /** Returns the number of Real values in the output SignalBank. */
+        int getOutputSize(int module) const;
+
+        /** Returns the number of processing calls. */
+        long getNCalls(int module) const;
+
+        /** Returns the number of frames processed (calls times block
+         * sizes). */
+        long getNFramesProcessed(int module) const;
+
+        Real getTotalWallTime(int module) const;
+        Real getMaxWallTime(int module) const;
+        Real getTotalCpuTime(int module) const;
+        Real getMaxCpuTime(int module) const;
+
+        /** Returns the number of frames passed to the model. */
+        long getNFrames() const;
+
+        /** Returns the total wall-clock time spent in the model. */
+        Real getTotalWallTime() const;
+
+        /** Returns the total CPU time spent in the model. */
+        Real getTotalCpuTime() const;
+
+        /** Returns the number of timeline events recorded. */
+        int getNEvents() const;
+
+        /** Returns the number of timeline events dropped once full. */
+        long getNDroppedEvents() const;
+
+        /**
+         * @brief Returns a table with one row per module, listing calls,
+         * frames, total, mean and maximum times, the share of the model's
+         * wall-clock time and the output size.
+         */
+        string getSummary() const;
+
+        /**
+         * @brief Writes the timeline as a Chrome trace-event JSON file.
+         *
+         * Each event is a complete ("X") event with microsecond timestamps
+         * relative to the last call of initialize() or reset(). Its
+         * arguments hold the first frame of the call, the number of frames
+         * and the CPU time.
+         *
+         * @return true if the file was written, false otherwise.
+         */
+        bool exportChromeTrace(const string& filename) const;
+
+    private:
+
+        struct Counter
+        {
+            long nCalls, nFrames;
+            double totalWallTime, maxWallTime, totalCpuTime, maxCpuTime;
+        };
+
+        struct Event
+        {
+            int module, frame, nFrames;
+            double start, wallTime, cpuTime;
+        };
+
+        void accumulate(Counter& counter, const Stamp& start,
+                const Stamp& end, int nFrames);
+
+        vector<string> names_;
+        vector<int> outputSizes_;
+        vector<Counter> counters_;
+        Counter modelCounter_;
+        vector<Event> events_;
+        int maxNEvents_;
+        long nDroppedEvents_;
+        Stamp origin_;
+    };
+}
+
+#endif
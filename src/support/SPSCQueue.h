@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include "Common.h"
+#include <atomic>
+
+namespace loudness{
+
+    /**
+     * @class SPSCQueue
+     *
+     * @brief A fixed capacity, lock-free queue for one producer thread and
+     * one consumer thread.
+     *
+     * push() may only be called by the producer and pop() only by the
+     * consumer; neither blocks or allocates. initialize() and clear() must
+     * not be called while either thread is using the queue.
+     */
+    template <typename T>
+    class SPSCQueue
+    {
+    public:
+        SPSCQueue() : head_(0), tail_(0) {}
+
+        /** Allocates space for @a capacity items and empties the queue. */
+        void initialize(int capacity)
+        {
+            //one slot is kept free to tell a full queue from an empty one
+            items_.assign(capacity + 1, T());
+            clear();
+        }
+
+        void clear()
+        {
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+        }
+
+        /** Appends @a item. Returns false if the queue is full. */
+        bool push(const T& item)
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            size_t next = tail + 1 == items_.size() ? 0 : tail + 1;
+            if (next == head_.load(std::memory_order_acquire))
+                return 0;
+            items_[tail] = item;
+            tail_.store(next, std::memory_order_release);
+            return 1;
+        }
+
+        /** Removes the oldest item into @a item. Returns false if the queue
+         * is empty. */
+        bool pop(T& item)
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+                return 0;
+            item = items_[head];
+            head_.store(head + 1 == items_.size() ? 0 : head + 1,
+                        std::memory_order_release);
+            return 1;
+        }
+
+        bool isEmpty() const
+        {
+            return head_.load(std::memory_order_acquire) ==
+                   tail_.load(std::memory_order_acquire);
+        }
+
+    private:
+        vector<T> items_;
+        std::atomic<size_t> head_, tail_;
+    };
+}
+
+#endif
@@ -0,0 +1,796 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SecondOrderSections.h"
+#include <complex>
+
+namespace loudness{
+
+    typedef std::complex<double> Complex;
+
+    /*
+     * A real root or a complex conjugate pair, represented by the root with
+     * positive imaginary part.
+     */
+    struct PolynomialRoot
+    {
+        Complex value;
+        bool isComplex;
+        bool isUsed;
+    };
+
+    /*
+     * Balances a matrix (indices 1 to n) by similarity transforms with
+     * powers of two, so that its rows and columns have comparable norms.
+     * See Press et al. (1992), Numerical Recipes in C, Section 11.5.
+     */
+    static void balance(vector<vector<double> >& a, int n)
+    {
+        const double radix = 2.0, radixSq = radix * radix;
+        bool isDone = false;
+        while (!isDone)
+        {
+            isDone = true;
+            for (int i = 1; i <= n; ++i)
+            {
+                double r = 0.0, c = 0.0;
+                for (int j = 1; j <= n; ++j)
+                {
+                    if (j != i)
+                    {
+                        c += std::fabs(a[j][i]);
+                        r += std::fabs(a[i][j]);
+                    }
+                }
+                if ((c == 0.0) || (r == 0.0))
+                    continue;
+
+                double g = r / radix, f = 1.0, s = c + r;
+                while (c < g)
+                {
+                    f *= radix;
+                    c *= radixSq;
+                }
+                g = r * radix;
+                while (c > g)
+                {
+                    f /= radix;
+                    c /= radixSq;
+                }
+                if ((c + r) / f < 0.95 * s)
+                {
+                    isDone = false;
+                    g = 1.0 / f;
+                    for (int j = 1; j <= n; ++j)
+                        a[i][j] *= g;
+                    for (int j = 1; j <= n; ++j)
+                        a[j][i] *= f;
+                }
+            }
+        }
+    }
+
+    static double withSign(double a, double b)
+    {
+        return b >= 0.0 ? std::fabs(a) : -std::fabs(a);
+    }
+
+    /*
+     * Eigenvalues of an upper Hessenberg matrix (indices 1 to n) by the
+     * shifted QR algorithm. Complex eigenvalues are returned as exact
+     * conjugate pairs. See Press et al. (1992), Section 11.6.
+     */
+    static bool hessenbergEigenvalues(vector<vector<double> >& a, int n,
+                                      vector<Complex>& eigenvalues)
+    {
+        vector<double> wr(n + 1, 0.0), wi(n + 1, 0.0);
+        int nn, m, l, k, j, its, i, mmin;
+        double z = 0.0, y, x, w, v, u, t, s, r = 0.0, q = 0.0, p = 0.0;
+
+        double anorm = 0.0;
+        for (i = 1; i <= n; ++i)
+            for (j = max(i - 1, 1); j <= n; ++j)
+                anorm += std::fabs(a[i][j]);
+
+        nn = n;
+        t = 0.0;
+        while (nn >= 1)
+        {
+            its = 0;
+            do
+            {
+                for (l = nn; l >= 2; --l)
+                {
+                    s = std::fabs(a[l - 1][l - 1]) + std::fabs(a[l][l]);
+                    if (s == 0.0)
+                        s = anorm;
+                    if ((double)(std::fabs(a[l][l - 1]) + s) == s)
+                    {
+                        a[l][l - 1] = 0.0;
+                        break;
+                    }
+                }
+                x = a[nn][nn];
+                if (l == nn)
+                {
+                    wr[nn] = x + t;
+                    wi[nn--] = 0.0;
+                }
+                else
+                {
+                    y = a[nn - 1][nn - 1];
+                    w = a[nn][nn - 1] * a[nn - 1][nn];
+                    if (l == (nn - 1))
+                    {
+                        p = 0.5 * (y - x);
+                        q = p * p + w;
+                        z = std::sqrt(std::fabs(q));
+                        x += t;
+                        if (q >= 0.0)
+                        {
+                            z = p + withSign(z, p);
+                            wr[nn - 1] = wr[nn] = x + z;
+                            if (z != 0.0)
+                                wr[nn] = x - w / z;
+                            wi[nn - 1] = wi[nn] = 0.0;
+                        }
+                        else
+                        {
+                            wr[nn - 1] = wr[nn] = x + p;
+                            wi[nn - 1] = -(wi[nn] = z);
+                        }
+                        nn -= 2;
+                    }
+                    else
+                    {
+                        if (its == 60)
+                            return 0;
+                        //exceptional shifts
+                        if ((its == 10) || (its == 20))
+                        {
+                            t += x;
+                            for (i = 1; i <= nn; ++i)
+                                a[i][i] -= x;
+                            s = std::fabs(a[nn][nn - 1]) +
+                                std::fabs(a[nn - 1][nn - 2]);
+                            y = x = 0.75 * s;
+                            w = -0.4375 * s * s;
+                        }
+                        ++its;
+                        for (m = nn - 2; m >= l; --m)
+                        {
+                            z = a[m][m];
+                            r = x - z;
+                            s = y - z;
+                            p = (r * s - w) / a[m + 1][m] + a[m][m + 1];
+                            q = a[m + 1][m + 1] - z - r - s;
+                            r = a[m + 2][m + 1];
+                            s = std::fabs(p) + std::fabs(q) + std::fabs(r);
+                            p /= s;
+                            q /= s;
+                            r /= s;
+                            if (m == l)
+                                break;
+                            u = std::fabs(a[m][m - 1]) *
+                                (std::fabs(q) + std::fabs(r));
+                            v = std::fabs(p) * (std::fabs(a[m - 1][m - 1]) +
+                                std::fabs(z) + std::fabs(a[m + 1][m + 1]));
+                            if ((double)(u + v) == v)
+                                break;
+                        }
+                        for (i = m + 2; i <= nn; ++i)
+                        {
+                            a[i][i - 2] = 0.0;
+                            if (i != (m + 2))
+                                a[i][i - 3] = 0.0;
+                        }
+                        for (k = m; k <= nn - 1; ++k)
+                        {
+                            if (k != m)
+                            {
+                                p = a[k][k - 1];
+                                q = a[k + 1][k - 1];
+                                r = 0.0;
+                                if (k != (nn - 1))
+                                    r = a[k + 2][k - 1];
+                                if ((x = std::fabs(p) + std::fabs(q) +
+                                     std::fabs(r)) != 0.0)
+                                {
+                                    p /= x;
+                                    q /= x;
+                                    r /= x;
+                                }
+                            }
+                            if ((s = withSign(std::sqrt(p * p + q * q + r * r),
+                                              p)) != 0.0)
+                            {
+                                if (k == m)
+                                {
+                                    if (l != m)
+                                        a[k][k - 1] = -a[k][k - 1];
+                                }
+                                else
+                                {
+                                    a[k][k - 1] = -s * x;
+                                }
+                                p += s;
+                                x = p / s;
+                                y = q / s;
+                                z = r / s;
+                                q /= p;
+                                r /= p;
+                                for (j = k; j <= nn; ++j)
+                                {
+                                    p = a[k][j] + q * a[k + 1][j];
+                                    if (k != (nn - 1))
+                                    {
+                                        p += r * a[k + 2][j];
+                                        a[k + 2][j] -= p * z;
+                                    }
+                                    a[k + 1][j] -= p * y;
+                                    a[k][j] -= p * x;
+                                }
+                                mmin = nn < k + 3 ? nn : k + 3;
+                                for (i = l; i <= mmin; ++i)
+                                {
+                                    p = x * a[i][k] + y * a[i][k + 1];
+                                    if (k != (nn - 1))
+                                    {
+                                        p += z * a[i][k + 2];
+                                        a[i][k + 2] -= p * r;
+                                    }
+                                    a[i][k + 1] -= p * q;
+                                    a[i][k] -= p;
+                                }
+                            }
+                        }
+                    }
+                }
+            } while (l < nn - 1);
+        }
+
+        eigenvalues.resize(n);
+        for (i = 1; i <= n; ++i)
+            eigenvalues[i - 1] = Complex(wr[i], wi[i]);
+
+        return 1;
+    }
+
+    /*
+     * Roots of c[0] x^n + c[1] x^(n - 1) + ... + c[n] as the eigenvalues of
+     * the balanced companion matrix.
+     */
+    static bool findRoots(const vector<double>& c, vector<Complex>& roots)
+    {
+        int n = (int)c.size() - 1;
+        roots.clear();
+        if (n < 1)
+            return 1;
+
+        vector<vector<double> > companion(n + 1, vector<double>(n + 1, 0.0));
+        for (int k = 1; k <= n; ++k)
+            companion[1][k] = -c[k] / c[0];
+        for (int j = 2; j <= n; ++j)
+            companion[j][j - 1] = 1.0;
+
+        balance(companion, n);
+        return hessenbergEigenvalues(companion, n, roots);
+    }
+
+    /*
+     * Newton step |c(x) / c'(x)| at a root x of c[0] x^n + c[1] x^(n - 1) +
+     * ... + c[n], which estimates the error of the root.
+     */
+    static double rootErrorEstimate(const vector<double>& c, Complex x)
+    {
+        Complex value = 0.0, derivative = 0.0;
+        for (uint i = 0; i < c.size(); ++i)
+        {
+            derivative = derivative * x + value;
+            value = value * x + c[i];
+        }
+        return std::abs(value) / std::abs(derivative);
+    }
+
+    /*
+     * Matches each root in the upper half plane with the nearest root in the
+     * lower half plane. Roots left over are taken to be real.
+     */
+    static vector<PolynomialRoot> pairConjugates(const vector<Complex>& roots)
+    {
+        int n = (int)roots.size();
+        vector<bool> isPaired(n, false);
+        vector<PolynomialRoot> pairs;
+
+        for (int i = 0; i < n; ++i)
+        {
+            double tol = 1e-10 * max(1.0, std::abs(roots[i]));
+            if (roots[i].imag() <= tol)
+                continue;
+
+            int nearest = -1;
+            for (int j = 0; j < n; ++j)
+            {
+                tol = 1e-10 * max(1.0, std::abs(roots[j]));
+                if (isPaired[j] || (roots[j].imag() >= -tol))
+                    continue;
+                if ((nearest < 0) ||
+                    (std::abs(roots[j] - std::conj(roots[i])) <
+                     std::abs(roots[nearest] - std::conj(roots[i]))))
+                    nearest = j;
+            }
+
+            if (nearest >= 0)
+            {
+                isPaired[i] = true;
+                isPaired[nearest] = true;
+                PolynomialRoot root = {0.5 * (roots[i] + std::conj(roots[nearest])),
+                             true, false};
+                pairs.push_back(root);
+            }
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            if (!isPaired[i])
+            {
+                PolynomialRoot root = {Complex(roots[i].real(), 0.0), false, false};
+                pairs.push_back(root);
+            }
+        }
+
+        return pairs;
+    }
+
+    /* Index of the unused root nearest to x, or -1. */
+    static int findNearest(const vector<PolynomialRoot>& roots, Complex x,
+                           bool isComplexAllowed, bool isRealAllowed)
+    {
+        int nearest = -1;
+        for (uint i = 0; i < roots.size(); ++i)
+        {
+            if (roots[i].isUsed ||
+                (roots[i].isComplex && !isComplexAllowed) ||
+                (!roots[i].isComplex && !isRealAllowed))
+                continue;
+            if ((nearest < 0) ||
+                (std::abs(roots[i].value - x) <
+                 std::abs(roots[nearest].value - x)))
+                nearest = i;
+        }
+        return nearest;
+    }
+
+    /* Multiplies a second order polynomial in z^-1 by (c0 + c1 z^-1). */
+    static void multiplyFactor(double* poly, double c0, double c1)
+    {
+        poly[2] = poly[2] * c0 + poly[1] * c1;
+        poly[1] = poly[1] * c0 + poly[0] * c1;
+        poly[0] = poly[0] * c0;
+    }
+
+    /*
+     * Runs one signal through N consecutive sections, with the state of the
+     * sections held in registers for the whole block so that their
+     * recursions overlap in the pipeline. The state of section k is at
+     * state[2 * k * stride] and state[(2 * k + 1) * stride].
+     */
+    template <int N>
+    static void filterSections(const double* coefs, double* state,
+                               int stride, double* signal, int nSamples)
+    {
+        double z0[N], z1[N];
+        for (int k = 0; k < N; ++k)
+        {
+            z0[k] = state[2 * k * stride];
+            z1[k] = state[(2 * k + 1) * stride];
+        }
+
+        for (int smp = 0; smp < nSamples; ++smp)
+        {
+            double in = signal[smp];
+            for (int k = 0; k < N; ++k)
+            {
+                const double* c = coefs + 5 * k;
+                double out = c[0] * in + z0[k];
+                z0[k] = c[1] * in - c[3] * out + z1[k];
+                z1[k] = c[2] * in - c[4] * out;
+                in = out;
+            }
+            signal[smp] = in;
+        }
+
+        for (int k = 0; k < N; ++k)
+        {
+            state[2 * k * stride] = z0[k];
+            state[(2 * k + 1) * stride] = z1[k];
+        }
+    }
+
+    SecondOrderSections::SecondOrderSections() :
+        nSections_(0),
+        nSignals_(0),
+        nSamples_(0),
+        gain_(1.0)
+    {}
+
+    SecondOrderSections::~SecondOrderSections() {}
+
+    void SecondOrderSections::setSections(const vector<double>& sections)
+    {
+        LOUDNESS_ASSERT((sections.size() % 6) == 0,
+                "SecondOrderSections: Six coefficients are required per section.");
+
+        nSections_ = (int)sections.size() / 6;
+        coefs_.resize(5 * nSections_);
+        for (int sec = 0; sec < nSections_; ++sec)
+        {
+            const double* s = &sections[6 * sec];
+            double a0 = s[3];
+            coefs_[5 * sec] = s[0] / a0;
+            coefs_[5 * sec + 1] = s[1] / a0;
+            coefs_[5 * sec + 2] = s[2] / a0;
+            coefs_[5 * sec + 3] = s[4] / a0;
+            coefs_[5 * sec + 4] = s[5] / a0;
+        }
+    }
+
+    bool SecondOrderSections::setTransferFunction(const vector<double>& bCoefs,
+                                                  const vector<double>& aCoefs)
+    {
+        vector<double> sections;
+        if (!transferFunctionToSections(bCoefs, aCoefs, sections))
+            return 0;
+        setSections(sections);
+        return 1;
+    }
+
+    bool SecondOrderSections::transferFunctionToSections(
+            const vector<double>& bCoefs,
+            const vector<double>& aCoefs,
+            vector<double>& sections)
+    {
+        //trailing zero coefficients do not add to the order
+        vector<double> b(bCoefs), a(aCoefs);
+        while (!b.empty() && (b.back() == 0.0))
+            b.pop_back();
+        while (!a.empty() && (a.back() == 0.0))
+            a.pop_back();
+
+        if (b.empty() || a.empty() || (a[0] == 0.0))
+        {
+            LOUDNESS_ERROR("SecondOrderSections: Invalid transfer function,"
+                    << " b must be nonzero and a[0] must be nonzero.");
+            return 0;
+        }
+
+        //a single section is used as given
+        if ((b.size() <= 3) && (a.size() <= 3))
+        {
+            b.resize(3, 0.0);
+            a.resize(3, 0.0);
+            sections = {b[0], b[1], b[2], a[0], a[1], a[2]};
+            return 1;
+        }
+
+        //leading zeros of b are pure delays
+        int nDelays = 0;
+        while (b[nDelays] == 0.0)
+            nDelays++;
+        b.erase(b.begin(), b.begin() + nDelays);
+        double gain = b[0] / a[0];
+
+        vector<Complex> zeroValues, poleValues;
+        if (!findRoots(b, zeroValues) || !findRoots(a, poleValues))
+        {
+            LOUDNESS_ERROR("SecondOrderSections: Failed to find the poles and"
+                    << " zeros of the transfer function.");
+            return 0;
+        }
+
+        /*
+         * Clustered poles are found with large errors, which can even move
+         * those of a stable filter outside the unit circle. The error of a
+         * pole changes the response near it by about the error over the
+         * distance of the pole to the unit circle, which is limited to 0.1%.
+         */
+        for (uint i = 0; i < poleValues.size(); ++i)
+        {
+            double radius = std::abs(poleValues[i]);
+            double error = rootErrorEstimate(a, poleValues[i]);
+            if ((radius >= 1.0) || !(error <= 0.001 * (1.0 - radius)))
+            {
+                LOUDNESS_WARNING("SecondOrderSections: Pole of radius "
+                        << radius << " found with an estimated error of "
+                        << error << ".");
+                return 0;
+            }
+        }
+
+        vector<PolynomialRoot> zeros = pairConjugates(zeroValues);
+        vector<PolynomialRoot> poles = pairConjugates(poleValues);
+        int zeroOrder = (int)b.size() - 1 + nDelays;
+        int poleOrder = (int)a.size() - 1;
+        int nSections = (max(zeroOrder, poleOrder) + 1) / 2;
+
+        LOUDNESS_DEBUG("SecondOrderSections: Factoring transfer function with "
+                << zeroOrder << " zeros and " << poleOrder << " poles into "
+                << nSections << " sections.");
+
+        /*
+         * Denominators: one section per complex pole pair, real poles paired
+         * in order of distance to the unit circle. Each section keeps its
+         * pole closest to the unit circle for matching zeros.
+         */
+        vector<PolynomialRoot> sectionPoles;
+        vector<double> den;
+        for (uint i = 0; i < poles.size(); ++i)
+        {
+            if (poles[i].isComplex)
+            {
+                Complex p = poles[i].value;
+                sectionPoles.push_back(poles[i]);
+                den.push_back(1.0);
+                den.push_back(-2.0 * p.real());
+                den.push_back(std::norm(p));
+                poles[i].isUsed = true;
+            }
+        }
+
+        bool isSecondRealPole = false;
+        while (true)
+        {
+            int nearest = -1;
+            for (uint i = 0; i < poles.size(); ++i)
+            {
+                if (!poles[i].isUsed && ((nearest < 0) ||
+                    (std::abs(std::abs(poles[i].value) - 1.0) <
+                     std::abs(std::abs(poles[nearest].value) - 1.0))))
+                    nearest = i;
+            }
+            if (nearest < 0)
+                break;
+
+            if (!isSecondRealPole)
+            {
+                sectionPoles.push_back(poles[nearest]);
+                den.push_back(1.0);
+                den.push_back(0.0);
+                den.push_back(0.0);
+            }
+            multiplyFactor(&den[den.size() - 3], 1.0,
+                    -poles[nearest].value.real());
+            poles[nearest].isUsed = true;
+            isSecondRealPole = !isSecondRealPole;
+        }
+
+        //sections without poles
+        while ((int)sectionPoles.size() < nSections)
+        {
+            PolynomialRoot none = {0.0, false, false};
+            sectionPoles.push_back(none);
+            den.push_back(1.0);
+            den.push_back(0.0);
+            den.push_back(0.0);
+        }
+
+        //cascade order: poles closest to the unit circle last
+        vector<int> order(nSections);
+        for (int i = 0; i < nSections; ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](int i, int j)
+        {
+            return std::abs(std::abs(sectionPoles[i].value) - 1.0) >
+                   std::abs(std::abs(sectionPoles[j].value) - 1.0);
+        });
+
+        /*
+         * Numerators: working back from the last section, take the zeros
+         * nearest to the section's pole, leaving a section for each
+         * remaining complex zero pair. Free places then take the delays.
+         */
+        vector<double> num(3 * nSections, 0.0);
+        vector<int> nFree(nSections, 2);
+        int nComplexZerosLeft = 0;
+        for (uint i = 0; i < zeros.size(); ++i)
+            nComplexZerosLeft += zeros[i].isComplex;
+
+        for (int k = nSections - 1; k >= 0; --k)
+        {
+            int sec = order[k];
+            double* poly = &num[3 * sec];
+            poly[0] = 1.0;
+            Complex p = sectionPoles[sec].value;
+
+            int nearest = findNearest(zeros, p, true, true);
+            if ((nComplexZerosLeft > k) ||
+                ((nearest >= 0) && zeros[nearest].isComplex))
+            {
+                nearest = findNearest(zeros, p, true, false);
+                Complex z = zeros[nearest].value;
+                poly[1] = -2.0 * z.real();
+                poly[2] = std::norm(z);
+                zeros[nearest].isUsed = true;
+                nFree[sec] = 0;
+                nComplexZerosLeft--;
+            }
+            else
+            {
+                for (int i = 0; i < 2; ++i)
+                {
+                    nearest = findNearest(zeros, p, false, true);
+                    if (nearest < 0)
+                        break;
+                    multiplyFactor(poly, 1.0, -zeros[nearest].value.real());
+                    zeros[nearest].isUsed = true;
+                    nFree[sec]--;
+                }
+            }
+        }
+
+        for (int k = 0; (k < nSections) && (nDelays > 0); ++k)
+        {
+            int sec = order[k];
+            while ((nFree[sec] > 0) && (nDelays > 0))
+            {
+                multiplyFactor(&num[3 * sec], 0.0, 1.0);
+                nFree[sec]--;
+                nDelays--;
+            }
+        }
+
+        LOUDNESS_ASSERT((nDelays == 0) &&
+                (findNearest(zeros, 0.0, true, true) < 0),
+                "SecondOrderSections: Not all zeros were assigned.");
+
+        //the first section applies the gain
+        sections.resize(6 * nSections);
+        for (int k = 0; k < nSections; ++k)
+        {
+            int sec = order[k];
+            double sectionGain = (k == 0) ? gain : 1.0;
+            sections[6 * k] = sectionGain * num[3 * sec];
+            sections[6 * k + 1] = sectionGain * num[3 * sec + 1];
+            sections[6 * k + 2] = sectionGain * num[3 * sec + 2];
+            sections[6 * k + 3] = den[3 * sec];
+            sections[6 * k + 4] = den[3 * sec + 1];
+            sections[6 * k + 5] = den[3 * sec + 2];
+        }
+
+        return 1;
+    }
+
+    void SecondOrderSections::setGain(double gain)
+    {
+        gain_ = gain;
+    }
+
+    void SecondOrderSections::initialize(const SignalBank& input)
+    {
+        nSignals_ = input.getNSources() * input.getNEars() *
+                    input.getNChannels();
+        nSamples_ = input.getNSamples();
+        state_.assign(2 * nSections_ * nSignals_, 0.0);
+        buffer_.assign(nSignals_ * nSamples_, 0.0);
+    }
+
+    void SecondOrderSections::process(const SignalBank& input,
+                                      SignalBank& output)
+    {
+        const Real* x = input.getSignalReadPointer(0, 0, 0);
+        Real* y = output.getSignalWritePointer(0, 0, 0);
+        const double* coefs = coefs_.data();
+        double* state = state_.data();
+        int nSignals = nSignals_;
+
+        if (nSignals < 4)
+        {
+            /*
+             * Too few signals to vectorise across: each signal is run
+             * through groups of up to four sections at a time instead.
+             */
+            for (int sig = 0; sig < nSignals; ++sig)
+            {
+                double* v = buffer_.data() + sig * nSamples_;
+                for (int smp = 0; smp < nSamples_; ++smp)
+                    v[smp] = x[sig * nSamples_ + smp];
+
+                int sec = 0;
+                for (; sec + 4 <= nSections_; sec += 4)
+                    filterSections<4>(coefs + 5 * sec,
+                                      state + 2 * sec * nSignals + sig,
+                                      nSignals, v, nSamples_);
+                if (sec + 2 <= nSections_)
+                {
+                    filterSections<2>(coefs + 5 * sec,
+                                      state + 2 * sec * nSignals + sig,
+                                      nSignals, v, nSamples_);
+                    sec += 2;
+                }
+                if (sec < nSections_)
+                    filterSections<1>(coefs + 5 * sec,
+                                      state + 2 * sec * nSignals + sig,
+                                      nSignals, v, nSamples_);
+
+                for (int smp = 0; smp < nSamples_; ++smp)
+                    y[sig * nSamples_ + smp] = gain_ * v[smp];
+            }
+            return;
+        }
+
+        //interleave the signals, sample by sample
+        double* buffer = buffer_.data();
+        for (int sig = 0; sig < nSignals; ++sig)
+            for (int smp = 0; smp < nSamples_; ++smp)
+                buffer[smp * nSignals + sig] = x[sig * nSamples_ + smp];
+
+        for (int sec = 0; sec < nSections_; ++sec)
+        {
+            const double b0 = coefs[5 * sec];
+            const double b1 = coefs[5 * sec + 1];
+            const double b2 = coefs[5 * sec + 2];
+            const double a1 = coefs[5 * sec + 3];
+            const double a2 = coefs[5 * sec + 4];
+            double* z0 = state + 2 * sec * nSignals;
+            double* z1 = z0 + nSignals;
+
+            for (int smp = 0; smp < nSamples_; ++smp)
+            {
+                double* v = buffer + smp * nSignals;
+                for (int sig = 0; sig < nSignals; ++sig)
+                {
+                    double in = v[sig];
+                    double out = b0 * in + z0[sig];
+                    z0[sig] = b1 * in - a1 * out + z1[sig];
+                    z1[sig] = b2 * in - a2 * out;
+                    v[sig] = out;
+                }
+            }
+        }
+
+        for (int sig = 0; sig < nSignals; ++sig)
+            for (int smp = 0; smp < nSamples_; ++smp)
+                y[sig * nSamples_ + smp] = gain_ * buffer[smp * nSignals + sig];
+    }
+
+    void SecondOrderSections::reset()
+    {
+        std::fill(state_.begin(), state_.end(), 0.0);
+    }
+
+    int SecondOrderSections::getNSections() const
+    {
+        return nSections_;
+    }
+
+    vector<double> SecondOrderSections::getSections() const
+    {
+        vector<double> sections(6 * nSections_);
+        for (int sec = 0; sec < nSections_; ++sec)
+        {
+            sections[6 * sec] = coefs_[5 * sec];
+            sections[6 * sec + 1] = coefs_[5 * sec + 1];
+            sections[6 * sec + 2] = coefs_[5 * sec + 2];
+            sections[6 * sec + 3] = 1.0;
+            sections[6 * sec + 4] = coefs_[5 * sec + 3];
+            sections[6 * sec + 5] = coefs_[5 * sec + 4];
+        }
+        return sections;
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SECONDORDERSECTIONS_H
+#define SECONDORDERSECTIONS_H
+
+#include "SignalBank.h"
+
+namespace loudness{
+
+    /**
+     * @class SecondOrderSections
+     *
+     * @brief Applies a cascade of second order sections (biquads) to every
+     * signal of a SignalBank.
+     *
+     * Each section is evaluated in transposed direct form 2. The filter state
+     * of all sources, ears and channels of the SignalBank is interleaved, so
+     * that one step of the recursion is a loop over all signals which the
+     * compiler maps onto SIMD instructions. With fewer than four signals,
+     * each signal is instead run through several sections at once.
+     * Coefficients, state and the
+     * recursion are held in double precision regardless of Real.
+     *
+     * Higher order filters given as transfer function coefficients are
+     * factored into sections by setTransferFunction(). The cascade is far
+     * less sensitive to rounding than a high order direct form filter.
+     *
+     * Denormals are not handled here; callers should process under a
+     * DenormalGuard.
+     *
+     * @sa IIR, Biquad, Butter, ForwardMaskingPO1998
+     */
+    class SecondOrderSections
+    {
+    public:
+        SecondOrderSections();
+        ~SecondOrderSections();
+
+        /**
+         * @brief Sets the sections of the cascade.
+         *
+         * @param sections Six coefficients per section, b0 b1 b2 a0 a1 a2,
+         * with the first section applied first (as used by scipy.signal).
+         * The coefficients of each section are normalised by its a0.
+         */
+        void setSections(const vector<double>& sections);
+
+        /**
+         * @brief Sets the cascade equivalent to the transfer function with
+         * feedforward coefficients @a bCoefs and feedback coefficients
+         * @a aCoefs.
+         *
+         * @return true if the transfer function could be factored, false
+         * otherwise.
+         */
+        bool setTransferFunction(const vector<double>& bCoefs,
+                                 const vector<double>& aCoefs);
+
+        /**
+         * @brief Factors a transfer function into second order sections.
+         *
+         * The poles and zeros are found as the roots of the feedback and
+         * feedforward polynomials. Pole pairs closest to the unit circle are
+         * matched with the nearest zeros and placed last in the cascade. The
+         * overall gain is applied by the first section.
+         *
+         * @param sections Six coefficients per section, as for setSections().
+         *
+         * @return true if successful, false if the roots could not be found
+         * or a pole is not accurate enough. The roots of clustered poles are
+         * found with large errors, so the sections of a stable high order
+         * filter can have a different response, or even be unstable. A pole
+         * is rejected if it lies on or outside the unit circle, or if its
+         * estimated error exceeds 0.1% of its distance to the unit circle.
+         */
+        static bool transferFunctionToSections(const vector<double>& bCoefs,
+                                               const vector<double>& aCoefs,
+                                               vector<double>& sections);
+
+        /** Sets a gain applied to the output of the cascade (default 1). */
+        void setGain(double gain);
+
+        /**
+         * @brief Allocates the filter state for all signals of @a input and
+         * clears it.
+         */
+        void initialize(const SignalBank& input);
+
+        /**
+         * @brief Filters all signals of @a input into @a output.
+         *
+         * The SignalBanks must have the shape passed to initialize().
+         */
+        void process(const SignalBank& input, SignalBank& output);
+
+        /** Clears the filter state. */
+        void reset();
+
+        int getNSections() const;
+
+        /** Returns the normalised sections, as for setSections(). */
+        vector<double> getSections() const;
+
+    private:
+        int nSections_, nSignals_, nSamples_;
+        double gain_;
+        vector<double> coefs_, state_, buffer_;
+    };
+}
+
+#endif
@@ -31,7 +31,8 @@ namespace loudness{
         fs_(0),
         frameRate_(0),
         channelSpacingInCams_(0),
-        reserveSamples_(0)
+        reserveSamples_(0),
+        ringOffset_(0)
     {}
 
     SignalBank::~SignalBank() {}
@@ -56,6 +57,7 @@ namespace loudness{
             frameRate_ = fs_;
             trig_ = 1;
             initialized_ = true;
+            ringOffset_ = 0;
 
             centreFreqs_.assign(nChannels_, 0.0);
             signals_.assign(nTotalSamples_, 0.0);
@@ -81,6 +83,7 @@ namespace loudness{
             frameRate_ = input.getFrameRate();
             trig_ = input.getTrig();
             initialized_ = true;
+            ringOffset_ = 0;
             centreFreqs_ = input.getCentreFreqs();
             channelSpacingInCams_ = input.getChannelSpacingInCams();
             signals_.assign(input.getNTotalSamples(), 0.0);
@@ -99,6 +102,7 @@ namespace loudness{
         signals_.assign(nTotalSamples_, 0.0);
         aggregatedSignals_.clear();
         trig_ = true;
+        ringOffset_ = 0;
     }
 
     bool SignalBank::hasSameShape(const SignalBank& input) const
@@ -208,7 +212,11 @@ namespace loudness{
             int ear,
             int channel,
             int writeSampleIndex,
+#ifdef SINGLE_PRECISION
+            const double* input,
+#else
             const float* input,
+#endif
             int nSamples)
     {
         LOUDNESS_ASSERT(((nSamples+writeSampleIndex) <= nSamples_) &&
@@ -222,13 +230,14 @@ namespace loudness{
                         + writeSampleIndex);
         Real* write = &signals_[startIdx];
         for (int smp = 0; smp < nSamples; ++smp)
-            *write++ = *input++;
+            *write++ = (Real)*input++;
     }
 
     void SignalBank::copySamples(const SignalBank& input)
     {
         LOUDNESS_ASSERT(hasSameShape(input), "SignalBank: Dimensions do not match");
         signals_ = input.getSignals();
+        ringOffset_ = input.getRingOffset();
     }
 
     void SignalBank::copySamples(
@@ -264,6 +273,33 @@ namespace loudness{
         aggregatedSignals_.insert (aggregatedSignals_.end(), signals_.begin(), signals_.end());
     }
 
+    void SignalBank::aggregate(const SignalBank& input)
+    {
+        LOUDNESS_ASSERT(hasSameShape(input), "SignalBank: Dimensions do not match");
+        aggregatedSignals_.reserve(reserveSamples_);
+        aggregatedSignals_.insert (aggregatedSignals_.end(),
+                                   input.signals_.begin(),
+                                   input.signals_.end());
+    }
+
+    void SignalBank::insertAggregatedSignals(long long position,
+            const SignalBank& input)
+    {
+        LOUDNESS_ASSERT(hasSameShape(input), "SignalBank: Dimensions do not match");
+        LOUDNESS_ASSERT(position <= (long long)aggregatedSignals_.size());
+        aggregatedSignals_.insert (aggregatedSignals_.begin() + position,
+                                   input.aggregatedSignals_.begin(),
+                                   input.aggregatedSignals_.end());
+    }
+
+    void SignalBank::swapSignals(SignalBank& input)
+    {
+        LOUDNESS_ASSERT(hasSameShape(input), "SignalBank: Dimensions do not match");
+        signals_.swap(input.signals_);
+        std::swap(trig_, input.trig_);
+        std::swap(ringOffset_, input.ringOffset_);
+    }
+
     void SignalBank::pullBack(int nSamples)
     {
         if (nSamples < nSamples_)
@@ -155,10 +155,16 @@ namespace loudness{
         void copySamples(int source, int ear, int channel, int writeSampleIndex, const Real* input, int nSamples);
 
         /** Copies nSamples from an array pointed to by source into a specified
-         * signal. The ear, channel and sample index to write to must be specified,
-         * along with the number of samples to copy. Watch your bounds.
+         * signal, converting from the precision not used by Real (float in
+         * the default build, double when built with SINGLE_PRECISION). The
+         * ear, channel and sample index to write to must be specified, along
+         * with the number of samples to copy. Watch your bounds.
          */
+#ifdef SINGLE_PRECISION
+        void copySamples(int source, int ear, int channel, int writeSampleIndex, const double* input, int nSamples);
+#else
         void copySamples(int source, int ear, int channel, int writeSampleIndex, const float* input, int nSamples);
+#endif
 
         /** Copies nSamples from all signals of the input SignalBank into the
          * current SignalBank. Both the destination sample index and source
@@ -169,6 +175,7 @@ namespace loudness{
 
         /** Copies nSamples from all signals of the input SignalBank into the
          * current SignalBank. Both the destination sample index and source.
+         * The ring offset is copied too.
          * Watch your bounds.
          */
         void copySamples(const SignalBank& input);
@@ -176,6 +183,21 @@ namespace loudness{
         /** Aggregates the vector signals_ on each call. */
         void aggregate();
 
+        /** Appends the signals of the input SignalBank, which must have the
+         * same shape, to the aggregated signals. */
+        void aggregate(const SignalBank& input);
+
+        /** Inserts the aggregated signals of the input SignalBank, which
+         * must have the same shape, before element @a position of the
+         * aggregated signals. */
+        void insertAggregatedSignals(long long position,
+                const SignalBank& input);
+
+        /** Exchanges the signals, trigger and ring offset with those of the
+         * input SignalBank, which must have the same shape. No samples are
+         * copied. */
+        void swapSignals(SignalBank& input);
+
         /** Pull all signals back by nSamples. */
         void pullBack(int nSamples);
 
@@ -188,6 +210,25 @@ namespace loudness{
             trig_ = trig;
         }
 
+        /** Sets the ring offset of the SignalBank.
+         *
+         * A non-zero offset means every signal is stored as a circular
+         * buffer: sample i is held at index (ringOffset + i) % nSamples. The
+         * default is zero (linear storage). Only modules which report
+         * Module::readsRingBuffers() receive SignalBanks with a non-zero
+         * offset.
+         */
+        inline void setRingOffset(int ringOffset)
+        {
+            ringOffset_ = ringOffset;
+        }
+
+        /** Returns the ring offset of the SignalBank. */
+        inline int getRingOffset() const
+        {
+            return ringOffset_;
+        }
+
         /** Returns the channel spacing in Cam units. */
         const Real getChannelSpacingInCams() const;
 
@@ -412,6 +453,7 @@ namespace loudness{
         int fs_;
         Real frameRate_, channelSpacingInCams_;
         long long reserveSamples_;
+        int ringOffset_;
         RealVec signals_, aggregatedSignals_;
         RealVec centreFreqs_;
     }; 
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SparseMatrix.h"
+
+namespace loudness{
+
+    SparseMatrix::SparseMatrix() :
+        nRows_(0),
+        nColumns_(0)
+    {
+        rowPtr_.assign(1, 0);
+    }
+
+    SparseMatrix::~SparseMatrix() {}
+
+    void SparseMatrix::initialize(int nRows, int nColumns)
+    {
+        nRows_ = 0;
+        nColumns_ = nColumns;
+        rowPtr_.assign(1, 0);
+        rowPtr_.reserve(nRows + 1);
+        firstColumn_.clear();
+        firstColumn_.reserve(nRows);
+        weights_.clear();
+    }
+
+    void SparseMatrix::setRow(const RealVec& weights, int firstColumn,
+            Real tolerance)
+    {
+        int lo = 0, hi = (int)weights.size();
+        while ((lo < hi) && (std::abs(weights[lo]) < tolerance))
+            lo++;
+        while ((hi > lo) && (std::abs(weights[hi - 1]) < tolerance))
+            hi--;
+
+        LOUDNESS_ASSERT(firstColumn + hi <= nColumns_,
+                "SparseMatrix: Row exceeds the number of columns.");
+
+        firstColumn_.push_back(lo < hi ? firstColumn + lo : 0);
+        weights_.insert(weights_.end(), weights.begin() + lo,
+                weights.begin() + hi);
+        rowPtr_.push_back((int)weights_.size());
+        nRows_++;
+    }
+
+    void SparseMatrix::multiply(const Real* const* inputs,
+            Real* const* outputs, int nVectors) const
+    {
+        for (int row = 0; row < nRows_; ++row)
+        {
+            const Real* w = weights_.data() + rowPtr_[row];
+            int n = rowPtr_[row + 1] - rowPtr_[row];
+            int offset = firstColumn_[row];
+            for (int v = 0; v < nVectors; ++v)
+                outputs[v][row] = dot(w, inputs[v] + offset, n);
+        }
+    }
+}
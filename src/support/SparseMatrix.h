@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include "Common.h"
+
+namespace loudness{
+
+    /**
+     * @class SparseMatrix
+     *
+     * @brief A banded sparse matrix stored in compressed row form.
+     *
+     * Each row holds a single contiguous run of non-negligible weights,
+     * starting at column getFirstColumn(row). The weights of all rows are
+     * stored back to back, so a row is applied to an input vector with a
+     * dense dot product over contiguous memory.
+     *
+     * This is the form taken by the weighting functions of a filter bank
+     * operating on a power spectrum, where each filter only covers the
+     * spectral components near its centre frequency. Weights at either end
+     * of a row with a magnitude below the tolerance passed to setRow() are
+     * dropped.
+     *
+     * multiply() applies the matrix to several input vectors at once (e.g.
+     * sources or frames), so each row is read from memory once for all of
+     * them.
+     */
+    class SparseMatrix
+    {
+    public:
+        SparseMatrix();
+        ~SparseMatrix();
+
+        /**
+         * @brief Clears the matrix and sets its dimensions.
+         *
+         * Rows must then be set in order using setRow().
+         */
+        void initialize(int nRows, int nColumns);
+
+        /**
+         * @brief Sets the next row of the matrix.
+         *
+         * @param weights Weights of the row, weights[0] being the weight of
+         * column firstColumn.
+         * @param firstColumn Column of the first weight.
+         * @param tolerance Leading and trailing weights with a magnitude
+         * below this value are dropped.
+         */
+        void setRow(const RealVec& weights, int firstColumn, Real tolerance);
+
+        /**
+         * @brief Computes the product of a row and an input vector.
+         */
+        inline Real dot(int row, const Real* input) const
+        {
+            return dot(weights_.data() + rowPtr_[row],
+                       input + firstColumn_[row],
+                       rowPtr_[row + 1] - rowPtr_[row]);
+        }
+
+        /**
+         * @brief Computes the product of the matrix and a dense matrix.
+         *
+         * @param inputs Array of nVectors pointers to input vectors of
+         * length getNColumns().
+         * @param outputs Array of nVectors pointers to output vectors of
+         * length getNRows().
+         * @param nVectors Number of input vectors.
+         */
+        void multiply(const Real* const* inputs, Real* const* outputs,
+                int nVectors) const;
+
+        int getNRows() const {return nRows_;}
+        int getNColumns() const {return nColumns_;}
+        int getFirstColumn(int row) const {return firstColumn_[row];}
+        int getRowLength(int row) const
+        {
+            return rowPtr_[row + 1] - rowPtr_[row];
+        }
+
+        /** Returns the number of stored weights. */
+        int getNNonZero() const {return (int)weights_.size();}
+
+    private:
+
+        /**
+         * Dot product using four partial sums, which the compiler maps
+         * onto SIMD registers.
+         */
+        static inline Real dot(const Real* w, const Real* x, int n)
+        {
+            Real sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+            int j = 0;
+            for (; j + 3 < n; j += 4)
+            {
+                sum0 += w[j] * x[j];
+                sum1 += w[j + 1] * x[j + 1];
+                sum2 += w[j + 2] * x[j + 2];
+                sum3 += w[j + 3] * x[j + 3];
+            }
+            for (; j < n; ++j)
+                sum0 += w[j] * x[j];
+            return (sum0 + sum1) + (sum2 + sum3);
+        }
+
+        int nRows_, nColumns_;
+        vector<int> rowPtr_, firstColumn_;
+        RealVec weights_;
+    };
+}
+
+#endif
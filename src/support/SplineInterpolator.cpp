@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SplineInterpolator.h"
+#include "../thirdParty/spline/Spline.h"
+
+namespace loudness{
+
+    SplineInterpolator::SplineInterpolator() {}
+
+    SplineInterpolator::~SplineInterpolator() {}
+
+    void SplineInterpolator::initialize(const RealVec& x,
+            const RealVec& xInterp,
+            bool isCubic,
+            Real tolerance)
+    {
+        int nPoints = (int)x.size();
+        int nInterp = (int)xInterp.size();
+
+        /*
+         * Column k of the operator is the spline through the k'th unit
+         * vector, evaluated at the query points.
+         */
+        RealVecVec weights(nInterp, RealVec(nPoints, 0.0));
+        RealVec y(nPoints, 0.0);
+        spline s;
+        for (int k = 0; k < nPoints; ++k)
+        {
+            y[k] = 1.0;
+            s.set_points(x, y, isCubic);
+            for (int i = 0; i < nInterp; ++i)
+                weights[i][k] = s(xInterp[i]);
+            y[k] = 0.0;
+        }
+
+        operator_.initialize(nInterp, nPoints);
+        for (int i = 0; i < nInterp; ++i)
+            operator_.setRow(weights[i], 0, tolerance);
+
+        LOUDNESS_DEBUG("SplineInterpolator: weights used: "
+                << operator_.getNNonZero()
+                << " of " << nInterp * nPoints);
+    }
+}
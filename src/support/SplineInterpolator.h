@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2014 Dominic Ward <contactdominicward@gmail.com>
+ *
+ * This file is part of Loudness
+ *
+ * Loudness is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Loudness is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Loudness.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLINEINTERPOLATOR_H
+#define SPLINEINTERPOLATOR_H
+
+#include "SparseMatrix.h"
+
+namespace loudness{
+
+    /**
+     * @class SplineInterpolator
+     *
+     * @brief Interpolates functions sampled at fixed points onto a fixed set
+     * of query points.
+     *
+     * A (cubic or linear) spline through points (x, y) evaluated at fixed
+     * query points is a linear function of y. The interpolator computes this
+     * linear map once, when initialised, and stores it as a banded
+     * SparseMatrix. Interpolating a new set of y values then only takes a
+     * sparse matrix-vector product, with no equation system to solve.
+     *
+     * The results are those of the spline class up to rounding, except that
+     * weights below the tolerance passed to initialize() are ignored.
+     */
+    class SplineInterpolator
+    {
+    public:
+        SplineInterpolator();
+        ~SplineInterpolator();
+
+        /**
+         * @brief Computes the interpolation operator.
+         *
+         * @param x Strictly increasing points at which the function is
+         * sampled.
+         * @param xInterp Points at which the function is interpolated.
+         * @param isCubic Set true for cubic spline interpolation (natural
+         * boundary conditions), false for linear interpolation.
+         * @param tolerance Weights with a smaller magnitude at either end of
+         * the support of an interpolated point are dropped.
+         */
+        void initialize(const RealVec& x,
+                const RealVec& xInterp,
+                bool isCubic = true,
+                Real tolerance = 1e-12);
+
+        /**
+         * @brief Interpolates the function values y (one per point x) at the
+         * query points, writing them to yInterp.
+         */
+        void process(const Real* y, Real* yInterp) const
+        {
+            operator_.multiply(&y, &yInterp, 1);
+        }
+
+        /**
+         * @brief Interpolates nVectors sets of function values at once.
+         */
+        void process(const Real* const* y, Real* const* yInterp,
+                int nVectors) const
+        {
+            operator_.multiply(y, yInterp, nVectors);
+        }
+
+        int getNPoints() const {return operator_.getNColumns();}
+        int getNInterpolatedPoints() const {return operator_.getNRows();}
+
+    private:
+        SparseMatrix operator_;
+    };
+}
+
+#endif
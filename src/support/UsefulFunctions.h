@@ -26,9 +26,10 @@
 
 namespace loudness{
 
-    inline void killDenormal (Real& value)
+    template <typename Type>
+    inline void killDenormal (Type& value)
     {
-        static const Real antiDenormal = 1e-18;
+        static const Type antiDenormal = 1e-18;
         value += antiDenormal;
         value -= antiDenormal;
     }
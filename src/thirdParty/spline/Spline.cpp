@@ -51,7 +51,7 @@ int band_matrix::dim() const {
 
 // defines the new operator (), so that we can access the elements
 // by A(i,j), index going from i=0,...,dim()-1
-double & band_matrix::operator () (int i, int j) {
+Real & band_matrix::operator () (int i, int j) {
    int k=j-i;       // what band is the entry
    assert( (i>=0) && (i<dim()) && (j>=0) && (j<dim()) );
    assert( (-num_lower()<=k) && (k<=num_upper()) );
@@ -59,7 +59,7 @@ double & band_matrix::operator () (int i, int j) {
    if(k>=0)   return m_upper[k][i];
    else	    return m_lower[-k][i];
 }
-double band_matrix::operator () (int i, int j) const {
+Real band_matrix::operator () (int i, int j) const {
    int k=j-i;       // what band is the entry
    assert( (i>=0) && (i<dim()) && (j>=0) && (j<dim()) );
    assert( (-num_lower()<=k) && (k<=num_upper()) );
@@ -68,11 +68,11 @@ double band_matrix::operator () (int i, int j) const {
    else	    return m_lower[-k][i];
 }
 // second diag (used in LU decomposition), saved in m_lower
-double band_matrix::saved_diag(int i) const {
+Real band_matrix::saved_diag(int i) const {
    assert( (i>=0) && (i<dim()) );
    return m_lower[0][i];
 }
-double & band_matrix::saved_diag(int i) {
+Real & band_matrix::saved_diag(int i) {
    assert( (i>=0) && (i<dim()) );
    return m_lower[0][i];
 }
@@ -81,7 +81,7 @@ double & band_matrix::saved_diag(int i) {
 void band_matrix::lu_decompose() {
    int  i_max,j_max;
    int  j_min;
-   double x;
+   Real x;
 
    // preconditioning
    // normalize column i so that a_ii=1
@@ -112,11 +112,11 @@ void band_matrix::lu_decompose() {
    }
 }
 // solves Ly=b
-std::vector<double> band_matrix::l_solve(const std::vector<double>& b) const {
+std::vector<Real> band_matrix::l_solve(const std::vector<Real>& b) const {
    assert( this->dim()==(int)b.size() );
-   std::vector<double> x(this->dim());
+   std::vector<Real> x(this->dim());
    int j_start;
-   double sum;
+   Real sum;
    for(int i=0; i<this->dim(); i++) {
       sum=0;
       j_start=std::max(0,i-this->num_lower());
@@ -126,11 +126,11 @@ std::vector<double> band_matrix::l_solve(const std::vector<double>& b) const {
    return x;
 }
 // solves Rx=y
-std::vector<double> band_matrix::r_solve(const std::vector<double>& b) const {
+std::vector<Real> band_matrix::r_solve(const std::vector<Real>& b) const {
    assert( this->dim()==(int)b.size() );
-   std::vector<double> x(this->dim());
+   std::vector<Real> x(this->dim());
    int j_stop;
-   double sum;
+   Real sum;
    for(int i=this->dim()-1; i>=0; i--) {
       sum=0;
       j_stop=std::min(this->dim()-1,i+this->num_upper());
@@ -140,10 +140,10 @@ std::vector<double> band_matrix::r_solve(const std::vector<double>& b) const {
    return x;
 }
 
-std::vector<double> band_matrix::lu_solve(const std::vector<double>& b,
+std::vector<Real> band_matrix::lu_solve(const std::vector<Real>& b,
       bool is_lu_decomposed) {
    assert( this->dim()==(int)b.size() );
-   std::vector<double>  x,y;
+   std::vector<Real>  x,y;
    if(is_lu_decomposed==false) {
       this->lu_decompose();
    }
@@ -159,8 +159,8 @@ std::vector<double> band_matrix::lu_solve(const std::vector<double>& b,
 // spline implementation
 // -----------------------
 
-void spline::set_points(const std::vector<double>& x,
-                          const std::vector<double>& y, bool cubic_spline) {
+void spline::set_points(const std::vector<Real>& x,
+                          const std::vector<Real>& y, bool cubic_spline) {
    assert(x.size()==y.size());
    m_x=x;
    m_y=y;
@@ -174,7 +174,7 @@ void spline::set_points(const std::vector<double>& x,
       // setting up the matrix and right hand side of the equation system
       // for the parameters b[]
       band_matrix A(n,1,1);
-      std::vector<double>  rhs(n);
+      std::vector<Real>  rhs(n);
       for(int i=1; i<n-1; i++) {
          A(i,i-1)=1.0/3.0*(x[i]-x[i-1]);
          A(i,i)=2.0/3.0*(x[i+1]-x[i-1]);
@@ -213,21 +213,21 @@ void spline::set_points(const std::vector<double>& x,
 
    // for the right boundary we define
    // f_{n-1}(x) = b*(x-x_{n-1})^2 + c*(x-x_{n-1}) + y_{n-1}
-   double h=x[n-1]-x[n-2];
+   Real h=x[n-1]-x[n-2];
    // m_b[n-1] is determined by the boundary condition
    m_a[n-1]=0.0;
    m_c[n-1]=3.0*m_a[n-2]*h*h+2.0*m_b[n-2]*h+m_c[n-2];   // = f'_{n-2}(x_{n-1})
 }
 
-double spline::operator() (double x) const {
+Real spline::operator() (Real x) const {
    size_t n=m_x.size();
    // find the closest point m_x[idx] < x, idx=0 even if x<m_x[0]
-   std::vector<double>::const_iterator it;
+   std::vector<Real>::const_iterator it;
    it=std::lower_bound(m_x.begin(),m_x.end(),x);
    int idx=std::max( int(it-m_x.begin())-1, 0);
 
-   double h=x-m_x[idx];
-   double interpol;
+   Real h=x-m_x[idx];
+   Real interpol;
    if(x<m_x[0]) {
       // extrapolation to the left
       interpol=((m_b[0])*h + m_c[0])*h + m_y[0];
@@ -29,8 +29,8 @@ namespace loudness{
 // band matrix solver
 class band_matrix {
 private:
-   std::vector< std::vector<double> > m_upper;  // upper band
-   std::vector< std::vector<double> > m_lower;  // lower band
+   std::vector< std::vector<Real> > m_upper;  // upper band
+   std::vector< std::vector<Real> > m_lower;  // lower band
 public:
    band_matrix() {};                             // constructor
    band_matrix(int dim, int n_u, int n_l);       // constructor
@@ -44,15 +44,15 @@ public:
       return m_lower.size()-1;
    }
    // access operator
-   double & operator () (int i, int j);            // write
-   double   operator () (int i, int j) const;      // read
+   Real & operator () (int i, int j);            // write
+   Real   operator () (int i, int j) const;      // read
    // we can store an additional diogonal (in m_lower)
-   double& saved_diag(int i);
-   double  saved_diag(int i) const;
+   Real& saved_diag(int i);
+   Real  saved_diag(int i) const;
    void lu_decompose();
-   std::vector<double> r_solve(const std::vector<double>& b) const;
-   std::vector<double> l_solve(const std::vector<double>& b) const;
-   std::vector<double> lu_solve(const std::vector<double>& b,
+   std::vector<Real> r_solve(const std::vector<Real>& b) const;
+   std::vector<Real> l_solve(const std::vector<Real>& b) const;
+   std::vector<Real> lu_solve(const std::vector<Real>& b,
                                 bool is_lu_decomposed=false);
 
 };
@@ -62,16 +62,16 @@ public:
 class spline 
 {
 private:
-   std::vector<double> m_x,m_y;           // x,y coordinates of points
+   std::vector<Real> m_x,m_y;           // x,y coordinates of points
    // interpolation parameters
    // f(x) = a*(x-x_i)^3 + b*(x-x_i)^2 + c*(x-x_i) + y_i
-   std::vector<double> m_a,m_b,m_c,m_d;
+   std::vector<Real> m_a,m_b,m_c,m_d;
 public:
    spline(){};
    ~spline(){};
-   void set_points(const std::vector<double>& x,
-                   const std::vector<double>& y, bool cubic_spline=true);
-   double operator() (double x) const;
+   void set_points(const std::vector<Real>& x,
+                   const std::vector<Real>& y, bool cubic_spline=true);
+   Real operator() (Real x) const;
 };
 
 }
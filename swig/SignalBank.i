@@ -42,7 +42,7 @@ public:
             const Real* ptr;
             ptr = $self -> getSignalReadPointer(source, ear, channel, 0);
             npy_intp dims[1] = {$self -> getNSamples()}; 
-            return PyArray_SimpleNewFromData(1, dims, NPY_DOUBLE, (void*)ptr);
+            return PyArray_SimpleNewFromData(1, dims, NPY_REAL, (void*)ptr);
         }
 
         PyObject* getSignals()
@@ -53,7 +53,7 @@ public:
                                 $self -> getNEars(),
                                 $self -> getNChannels(),
                                 $self -> getNSamples()}; 
-            return PyArray_SimpleNewFromData(4, dims, NPY_DOUBLE, (void*)ptr);
+            return PyArray_SimpleNewFromData(4, dims, NPY_REAL, (void*)ptr);
         }
 
         PyObject* getAggregatedSignals()
@@ -65,14 +65,14 @@ public:
                                 $self -> getNEars(),
                                 $self -> getNChannels(),
                                 $self -> getNSamples()}; 
-            return PyArray_SimpleNewFromData(5, dims, NPY_DOUBLE, (void*)vec.data());
+            return PyArray_SimpleNewFromData(5, dims, NPY_REAL, (void*)vec.data());
         }
 
         PyObject* getCentreFreqs()
         {
             const Real* ptr = $self -> getCentreFreqsReadPointer(0);
             npy_intp dims[1] = {$self -> getNChannels()}; 
-            return PyArray_SimpleNewFromData(1, dims, NPY_DOUBLE, (void*)ptr);
+            return PyArray_SimpleNewFromData(1, dims, NPY_REAL, (void*)ptr);
         }
 
         void setSignal(int source, int ear, int channel, Real* data, int nSamples)
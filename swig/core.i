@@ -28,9 +28,12 @@
 #include "../src/support/AuditoryTools.h"
 #include "../src/support/SignalBank.h"
 #include "../src/support/Module.h"
+#include "../src/support/Profile.h"
 #include "../src/support/Model.h"
 #include "../src/support/FFT.h"
+#include "../src/support/FastMath.h"
 #include "../src/support/Filter.h"
+#include "../src/support/SecondOrderSections.h"
 #include "../src/support/AudioFileProcessor.h"
 #include "../src/modules/UnaryOperator.h"
 #include "../src/modules/FIR.h"
@@ -44,6 +47,7 @@
 #include "../src/modules/Window.h"
 #include "../src/modules/PowerSpectrum.h"
 #include "../src/modules/HoppingGoertzelDFT.h"
+#include "../src/modules/MultiRatePowerSpectrum.h"
 #include "../src/modules/WeightSpectrum.h"
 #include "../src/modules/CompressSpectrum.h"
 #include "../src/modules/RoexBankANSIS342007.h"
@@ -72,6 +76,13 @@
 typedef loudness::Real Real;
 typedef loudness::uint unint;
 typedef loudness::RealVec RealVec;
+
+//numpy type matching Real
+#ifdef SINGLE_PRECISION
+#define NPY_REAL NPY_FLOAT
+#else
+#define NPY_REAL NPY_DOUBLE
+#endif
 %}
 
 //Required for integration with numpy arrays
@@ -80,29 +91,40 @@ typedef loudness::RealVec RealVec;
     import_array();
 %}
 
-//apply all of the double typemaps to Real
-%apply double { Real };
+//Real is float when built with SINGLE_PRECISION (see setup.py)
+#ifdef SINGLE_PRECISION
+#define REAL float
+#else
+#define REAL double
+#endif
+
+//apply all of the REAL typemaps to Real
+%apply REAL { Real };
 %apply unsigned int { uint };
 
 %include "std_vector.i"
 %include "std_string.i"
 namespace std {
     //The argument to %template() is the name of the instantiation in the target language
-    %template(RealVec) vector<double>;
+    %template(RealVec) vector<REAL>;
     %template(IntVec) vector<int>;
     %template(StringVec) vector<string>;
+#ifdef SINGLE_PRECISION
+    //second order sections are specified in double precision
+    %template(DoubleVec) vector<double>;
+#endif
 
-    %apply vector<double>& { RealVec& };
-    %apply const vector<double>& { const RealVec& };
+    %apply vector<REAL>& { RealVec& };
+    %apply const vector<REAL>& { const RealVec& };
     %apply vector<int> { IntVec };
     %apply vector<int>& { IntVec& };
     %apply const vector<int>& { const IntVec& };
     %apply vector<string>& { StringVec };
 }
 
-%apply (double* IN_ARRAY1, int DIM1) {(Real* data, int nSamples)};
-%apply (double* IN_ARRAY1, int DIM1) {(Real* data, int nChannels)};
-%apply (double* IN_ARRAY4, int DIM1, int DIM2, int DIM3, int DIM4) {
+%apply (REAL* IN_ARRAY1, int DIM1) {(Real* data, int nSamples)};
+%apply (REAL* IN_ARRAY1, int DIM1) {(Real* data, int nChannels)};
+%apply (REAL* IN_ARRAY4, int DIM1, int DIM2, int DIM3, int DIM4) {
     (Real* data, int nSources, int nEars, int nChannels, int nSamples)};
 
 using namespace std;
@@ -119,9 +141,27 @@ using std::vector;
 %include "../src/support/UsefulFunctions.h"
 %include "../src/support/AuditoryTools.h"
 %include "../src/support/Module.h"
+//Profile is recorded by the modules, Python only reads it
+%ignore loudness::Profile::Stamp;
+%ignore loudness::Profile::getStamp;
+%ignore loudness::Profile::record;
+%include "../src/support/Profile.h"
 %include "../src/support/Model.h"
 %include "../src/support/FFT.h"
+//Only the switch is exposed, the kernels are used by the modules
+%ignore loudness::fastExp;
+%ignore loudness::fastLog;
+%ignore loudness::fastLog10;
+%ignore loudness::fastPow;
+%ignore loudness::fastCosh;
+%ignore loudness::vectorExp;
+%ignore loudness::vectorLog;
+%ignore loudness::vectorLog10;
+%ignore loudness::vectorCosh;
+%ignore loudness::vectorPow;
+%include "../src/support/FastMath.h"
 %include "../src/support/Filter.h"
+%include "../src/support/SecondOrderSections.h"
 %include "../src/support/AudioFileProcessor.h"
 %include "../src/modules/UnaryOperator.h"
 %include "../src/modules/FIR.h"
@@ -135,6 +175,7 @@ using std::vector;
 %include "../src/modules/Window.h"
 %include "../src/modules/PowerSpectrum.h"
 %include "../src/modules/HoppingGoertzelDFT.h"
+%include "../src/modules/MultiRatePowerSpectrum.h"
 %include "../src/modules/WeightSpectrum.h"
 %include "../src/modules/CompressSpectrum.h"
 %include "../src/modules/RoexBankANSIS342007.h"
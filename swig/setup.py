@@ -4,6 +4,7 @@ from distutils.core import setup, Extension
 
 # Third-party modules - we depend on numpy for everything
 import numpy
+import os
 
 # Obtain the numpy include directory.  This logic works across numpy versions.
 try:
@@ -11,6 +12,17 @@ try:
 except AttributeError:
     numpy_include = numpy.get_numpy_include()
 
+# Build with Real = float when SINGLE_PRECISION is set, e.g.
+# SINGLE_PRECISION=1 python setup.py install
+if os.environ.get('SINGLE_PRECISION'):
+    define_macros = [('SINGLE_PRECISION', None)]
+    swig_opts = ['-c++', '-DSINGLE_PRECISION']
+    libraries = ['fftw3f', 'sndfile', 'pthread']
+else:
+    define_macros = []
+    swig_opts = ['-c++']
+    libraries = ['fftw3', 'sndfile', 'pthread']
+
 if __name__ == "__main__":
 
     setup(
@@ -34,8 +46,16 @@ if __name__ == "__main__":
                     "../src/support/Module.cpp",
                     "../src/support/Model.cpp",
                     "../src/support/FFT.cpp",
+                    "../src/support/PartitionedConvolution.cpp",
+                    "../src/support/SparseMatrix.cpp",
+                    "../src/support/FastMath.cpp",
+                    "../src/support/SplineInterpolator.cpp",
                     "../src/support/Filter.cpp",
+                    "../src/support/SecondOrderSections.cpp",
+                    "../src/support/MappedAudioFile.cpp",
                     "../src/support/AudioFileProcessor.cpp",
+                    "../src/support/AllocationCounter.cpp",
+                    "../src/support/Profile.cpp",
                     "../src/modules/UnaryOperator.cpp",
                     "../src/modules/FIR.cpp",
                     "../src/modules/IIR.cpp",
@@ -48,6 +68,7 @@ if __name__ == "__main__":
                     "../src/modules/Window.cpp",
                     "../src/modules/PowerSpectrum.cpp",
                     "../src/modules/HoppingGoertzelDFT.cpp",
+                    "../src/modules/MultiRatePowerSpectrum.cpp",
                     "../src/modules/WeightSpectrum.cpp",
                     "../src/modules/CompressSpectrum.cpp",
                     "../src/modules/RoexBankANSIS342007.cpp",
@@ -75,8 +96,10 @@ if __name__ == "__main__":
                 ],
                 include_dirs=[numpy_include, "/usr/include"],
                 library_dirs=['/usr/lib', '/usr/local/lib'],
-                libraries=['fftw3', 'sndfile'],
-                swig_opts=['-c++'],
-                extra_compile_args=["-std=c++11", "-fPIC", "-O3"])
+                libraries=libraries,
+                define_macros=define_macros,
+                swig_opts=swig_opts,
+                extra_compile_args=["-std=c++11", "-fPIC", "-O3",
+                                    "-fno-trapping-math"])
             ]
         )